@@ -22,10 +22,13 @@
 #define ROCBLAS_BETA_FEATURES_API
 #include "program_options.hpp"
 
+#include "cblas_backend.hpp"
 #include "rocblas.hpp"
 #include "rocblas_data.hpp"
 #include "rocblas_datatype2string.hpp"
+#include "rocblas_error_stats.hpp"
 #include "rocblas_parse_data.hpp"
+#include "rocblas_replay.hpp"
 #include "tensile_host.hpp"
 #include "type_dispatch.hpp"
 #include "utility.hpp"
@@ -33,11 +36,14 @@
 #include <cctype>
 #include <cstdio>
 #include <cstring>
+#include <fstream>
 #include <iostream>
 #include <map>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 // aux
 #include "testing_set_get_matrix.hpp"
@@ -1449,6 +1455,139 @@ int run_bench_gpu_test(int                parallel_devices,
     return 0;
 }
 
+int rocblas_bench_command(int argc, char* argv[], bool replaying);
+
+// Replay a captured workload: run each distinct command of a bench or profile log once,
+// reusing device memory between commands, and weight its time by how often it was called
+int rocblas_bench_replay(const std::string& file, const std::vector<std::string>& options)
+{
+    std::ifstream in(file);
+    if(!in)
+        throw std::invalid_argument("Cannot open --replay file " + file);
+
+    struct replay_command
+    {
+        std::vector<std::string> tokens;
+        size_t                   count  = 0;
+        double                   gpu_us = ArgumentLogging::NA_value;
+        double                   gflop  = ArgumentLogging::NA_value;
+        double                   gbyte  = ArgumentLogging::NA_value;
+    };
+
+    // Distinct commands in order of first appearance
+    std::vector<replay_command>                commands;
+    std::map<std::vector<std::string>, size_t> index;
+    std::vector<std::string>                   tokens;
+    size_t                                     count, total_calls = 0;
+
+    for(std::string line; std::getline(in, line);)
+    {
+        if(!rocblas_replay_parse_line(line, tokens, count))
+            continue;
+
+        auto it = index.emplace(tokens, commands.size());
+        if(it.second)
+            commands.push_back({tokens});
+        commands[it.first->second].count += count;
+        total_calls += count;
+    }
+
+    rocblas_cout << "Replaying " << total_calls << " calls as " << commands.size()
+                 << " distinct commands from " << file << std::endl;
+
+    d_vector_cache_enable(true);
+
+    int ret = 0;
+    for(size_t i = 0; i < commands.size(); ++i)
+    {
+        auto& cmd = commands[i];
+
+        // Options given alongside --replay come first, so the logged options take precedence
+        std::vector<std::string> args{"rocblas-bench"};
+        args.insert(args.end(), options.begin(), options.end());
+        args.insert(args.end(), cmd.tokens.begin(), cmd.tokens.end());
+
+        std::vector<char*> argv;
+        for(auto& a : args)
+            argv.push_back(&a[0]);
+        argv.push_back(nullptr);
+
+        rocblas_cout << "\n[" << i + 1 << "/" << commands.size() << "] x" << cmd.count << ":";
+        for(size_t j = 1; j < args.size(); ++j)
+            rocblas_cout << " " << args[j];
+        rocblas_cout << std::endl;
+
+        ArgumentModel_set_last_perf(
+            ArgumentLogging::NA_value, ArgumentLogging::NA_value, ArgumentLogging::NA_value);
+        if(rocblas_bench_command(int(args.size()), argv.data(), true))
+            ret = -1;
+        else
+            ArgumentModel_get_last_perf(cmd.gpu_us, cmd.gflop, cmd.gbyte);
+    }
+
+    size_t reused, allocated;
+    d_vector_cache_stats(reused, allocated);
+    d_vector_cache_enable(false);
+    test_cleanup::cleanup();
+
+    // Summary of the workload, heaviest commands first
+    std::vector<const replay_command*> order;
+    double                             total_us = 0, total_gflop = 0, total_gbyte = 0;
+    size_t                             timed_calls = 0;
+    for(const auto& cmd : commands)
+    {
+        order.push_back(&cmd);
+        if(cmd.gpu_us == ArgumentLogging::NA_value)
+            continue;
+        timed_calls += cmd.count;
+        total_us += cmd.gpu_us * cmd.count;
+        if(cmd.gflop != ArgumentLogging::NA_value)
+            total_gflop += cmd.gflop * cmd.count;
+        if(cmd.gbyte != ArgumentLogging::NA_value)
+            total_gbyte += cmd.gbyte * cmd.count;
+    }
+    std::stable_sort(order.begin(), order.end(), [](const auto* a, const auto* b) {
+        return a->gpu_us * a->count > b->gpu_us * b->count;
+    });
+
+    rocblas_cout << "\nreplay summary: " << file << "\ncount,us,total_us,percent,command\n";
+    for(const auto* cmd : order)
+    {
+        rocblas_cout << cmd->count << ",";
+        if(cmd->gpu_us == ArgumentLogging::NA_value)
+            rocblas_cout << "NA,NA,NA,";
+        else
+        {
+            double us = cmd->gpu_us * cmd->count;
+            rocblas_cout << cmd->gpu_us << "," << us << "," << (total_us ? 100 * us / total_us : 0)
+                         << ",";
+        }
+        const char* delim = "";
+        for(const auto& token : cmd->tokens)
+        {
+            rocblas_cout << delim << token;
+            delim = " ";
+        }
+        rocblas_cout << "\n";
+    }
+
+    rocblas_cout << "\ncalls,timed_calls,distinct_commands,allocations,reused_allocations,total_us";
+    if(total_gflop)
+        rocblas_cout << ",rocblas-Gflops";
+    if(total_gbyte)
+        rocblas_cout << ",rocblas-GB/s";
+    rocblas_cout << "\n"
+                 << total_calls << "," << timed_calls << "," << commands.size() << ","
+                 << allocated << "," << reused << "," << total_us;
+    if(total_gflop)
+        rocblas_cout << "," << total_gflop / total_us * 1e6;
+    if(total_gbyte)
+        rocblas_cout << "," << total_gbyte / total_us * 1e6;
+    rocblas_cout << std::endl;
+
+    return ret;
+}
+
 // Replace --batch with --batch_count for backward compatibility
 void fix_batch(int argc, char* argv[])
 {
@@ -1465,7 +1604,7 @@ void fix_batch(int argc, char* argv[])
         }
 }
 
-int main(int argc, char* argv[])
+int rocblas_bench_command(int argc, char* argv[], bool replaying)
 try
 {
     fix_batch(argc, argv);
@@ -1482,6 +1621,7 @@ try
     std::string arithmetic_check;
     std::string filter;
     std::string name_filter;
+    std::string replay_file;
     int32_t     device_id           = 0;
     int32_t     parallel_devices    = 0;
     int32_t     flags               = 0;
@@ -1492,10 +1632,21 @@ try
     bool        atomics_not_allowed = false;
     bool        log_function_name   = false;
     bool        log_datatype        = false;
+    bool        log_error_stats     = false;
     bool        any_stride          = false;
     uint32_t    math_mode           = 0;
     bool        fortran             = false;
 
+    // Options which apply to every command of --replay
+    std::vector<std::string> replay_options;
+    for(int i = 1; i < argc; ++i)
+    {
+        if(!strcmp(argv[i], "--replay"))
+            ++i;
+        else
+            replay_options.push_back(argv[i]);
+    }
+
     arg.init(); // set all defaults
 
     options_description desc("rocblas-bench command line options");
@@ -1734,6 +1885,10 @@ try
          bool_switch(&log_datatype)->default_value(false),
          "Include datatypes used in output.")
 
+        ("log_error_stats",
+         bool_switch(&log_error_stats)->default_value(false),
+         "With -v 1, include ULP and relative error distributions in output.")
+
         ("function_filter",
          value<std::string>(&filter),
          "Simple strstr filter on function name only without wildcards")
@@ -1746,6 +1901,11 @@ try
          value<std::string>(&name_filter),
          "Simple strstr filter on test name only without wildcards, only used with --yaml or --data")
 
+        ("replay",
+         value<std::string>(&replay_file),
+         "Replay a bench log (ROCBLAS_LAYER=2) or profile YAML log (ROCBLAS_LAYER=4), running each "
+         "distinct command once and reporting the total time weighted by call counts")
+
         ("help,h", "produces this help message")
 
         ("version", "Prints the version number");
@@ -1826,18 +1986,40 @@ try
 
     ArgumentModel_set_log_datatype(log_datatype);
 
-    // Device Query
-    rocblas_int device_count = query_device_property();
+    rocblas_error_stats_enable(log_error_stats);
 
-    rocblas_cout << std::endl;
-    if(device_count <= device_id)
-        throw std::invalid_argument("Invalid Device ID");
-    if(device_id >= 0)
-        set_device(device_id);
+    if(replaying)
+    {
+        // The device is selected once for the whole replay
+        if(!replay_file.empty() || parallel_devices)
+            throw std::invalid_argument("--replay and --parallel_devices cannot be replayed");
+    }
+    else
+    {
+        // Device Query
+        rocblas_int device_count = query_device_property();
+
+        rocblas_cout << std::endl;
+        if(device_count <= device_id)
+            throw std::invalid_argument("Invalid Device ID");
+        if(device_id >= 0)
+            set_device(device_id);
+    }
+
+    // Name the host reference BLAS when --cblas or ROCBLAS_CLIENT_CBLAS selects another one
+    if(strcmp(cblas_backend_name(), "linked"))
+        rocblas_cout << cblas_backend_banner() << "\n" << std::endl;
 
     if(datafile)
         return rocblas_bench_datafile(filter, name_filter, any_stride);
 
+    if(!replay_file.empty())
+    {
+        if(parallel_devices)
+            throw std::invalid_argument("--replay cannot be used with --parallel_devices");
+        return rocblas_bench_replay(replay_file, replay_options);
+    }
+
     // single bench run
 
     // validate arguments
@@ -1904,3 +2086,8 @@ catch(const std::invalid_argument& exp)
     rocblas_cerr << exp.what() << std::endl;
     return -1;
 }
+
+int main(int argc, char* argv[])
+{
+    return rocblas_bench_command(argc, argv, false);
+}
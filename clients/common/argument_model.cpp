@@ -21,6 +21,7 @@
  * ************************************************************************ */
 
 #include "argument_model.hpp"
+#include "rocblas_error_stats.hpp"
 
 // this should have been a member variable but due to the complex variadic template this singleton allows global control
 
@@ -47,3 +48,36 @@ bool ArgumentModel_get_log_datatype()
 {
     return log_datatype;
 }
+
+static double last_gpu_us = ArgumentLogging::NA_value;
+static double last_gflop  = ArgumentLogging::NA_value;
+static double last_gbyte  = ArgumentLogging::NA_value;
+
+void ArgumentModel_set_last_perf(double gpu_us, double gflop, double gbyte)
+{
+    last_gpu_us = gpu_us;
+    last_gflop  = gflop;
+    last_gbyte  = gbyte;
+}
+
+void ArgumentModel_get_last_perf(double& gpu_us, double& gflop, double& gbyte)
+{
+    gpu_us = last_gpu_us;
+    gflop  = last_gflop;
+    gbyte  = last_gbyte;
+}
+
+void ArgumentModel_log_error_stats(rocblas_internal_ostream& name_line,
+                                   rocblas_internal_ostream& val_line)
+{
+    rocblas_error_stats stats;
+    if(!rocblas_error_stats_take(stats))
+        return;
+
+    auto values = stats.columns();
+    for(size_t i = 0; i < rocblas_error_stats_column_count; i++)
+    {
+        name_line << "," << rocblas_error_stats_columns[i];
+        val_line << "," << values[i];
+    }
+}
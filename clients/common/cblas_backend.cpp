@@ -0,0 +1,674 @@
+/* ************************************************************************
+ * Copyright (C) 2018-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell cop-
+ * ies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM-
+ * PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNE-
+ * CTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ************************************************************************/
+
+#include "cblas_backend.hpp"
+#include "cblas.h"
+#include "cblas_interface.hpp"
+#include "rocblas_ostream.hpp"
+#include <algorithm>
+#include <atomic>
+#include <complex>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#ifndef WIN32
+#include <dlfcn.h>
+#endif
+
+// The linked library is chosen at link time, so its thread controls are weak and looked up at
+// run time
+#ifndef WIN32
+extern "C" {
+int     openblas_get_num_threads(void) __attribute__((weak));
+void    openblas_set_num_threads(int num_threads) __attribute__((weak));
+int64_t bli_thread_get_num_threads(void) __attribute__((weak));
+void    bli_thread_set_num_threads(int64_t n_threads) __attribute__((weak));
+}
+#endif
+
+namespace
+{
+    struct cblas_backend_state
+    {
+        std::string name;
+        bool        builtin = false;
+        bool        ilp64   = false;
+
+        // cblas_sgemm, cblas_dgemm, cblas_cgemm and cblas_zgemm of a loaded library; null for
+        // the linked one
+        void* gemm[4] = {};
+
+        int (*openblas_get_threads)()     = nullptr;
+        void (*openblas_set_threads)(int) = nullptr;
+        int64_t (*blis_get_threads)()     = nullptr;
+        void (*blis_set_threads)(int64_t) = nullptr;
+        int (*mkl_get_threads)()          = nullptr;
+        void (*mkl_set_threads)(int)      = nullptr;
+    };
+
+    std::string& cblas_backend_requested()
+    {
+        static std::string name;
+        return name;
+    }
+
+    // Thread count of the builtin backend; 0 uses the OpenMP default
+    std::atomic<int> builtin_threads{0};
+
+    [[noreturn]] void cblas_backend_fail(const std::string& name, const char* reason)
+    {
+        rocblas_cerr << "rocBLAS error: cannot use reference BLAS \"" << name << "\": " << reason
+                     << std::endl;
+        rocblas_abort();
+    }
+
+#ifndef WIN32
+    template <typename F>
+    void cblas_backend_symbol(void* lib, const char* symbol, F& fn)
+    {
+        fn = reinterpret_cast<F>(dlsym(lib, symbol));
+    }
+
+    void cblas_backend_load(cblas_backend_state& state)
+    {
+        static const char* const openblas[] = {"libopenblas.so.0", "libopenblas.so", nullptr};
+        static const char* const blis[]
+            = {"libblis-mt.so.4", "libblis.so.4", "libblis-mt.so", "libblis.so", nullptr};
+        static const char* const mkl[]
+            = {"libmkl_rt.so.2", "libmkl_rt.so.1", "libmkl_rt.so", nullptr};
+
+        const std::string& name   = state.name;
+        const char*        path[] = {name.c_str(), nullptr};
+        const char* const* candidates;
+
+        if(name == "openblas")
+            candidates = openblas;
+        else if(name == "blis")
+            candidates = blis;
+        else if(name == "mkl")
+            candidates = mkl;
+        else if(name.find('/') != std::string::npos || name.find(".so") != std::string::npos)
+            candidates = path;
+        else
+            cblas_backend_fail(name,
+                               "expected linked, openblas, blis, mkl, builtin or a library path");
+
+        void* lib = nullptr;
+        for(; *candidates && !lib; ++candidates)
+            lib = dlopen(*candidates, RTLD_NOW | RTLD_LOCAL);
+        if(!lib)
+            cblas_backend_fail(name, dlerror());
+
+        static const char* const gemm[]
+            = {"cblas_sgemm", "cblas_dgemm", "cblas_cgemm", "cblas_zgemm"};
+        for(int t = 0; t < 4; t++)
+        {
+            state.gemm[t] = dlsym(lib, gemm[t]);
+            if(!state.gemm[t])
+                cblas_backend_fail(name, dlerror());
+        }
+
+        cblas_backend_symbol(lib, "openblas_get_num_threads", state.openblas_get_threads);
+        cblas_backend_symbol(lib, "openblas_set_num_threads", state.openblas_set_threads);
+        cblas_backend_symbol(lib, "bli_thread_get_num_threads", state.blis_get_threads);
+        cblas_backend_symbol(lib, "bli_thread_set_num_threads", state.blis_set_threads);
+        cblas_backend_symbol(lib, "MKL_Get_Max_Threads", state.mkl_get_threads);
+        cblas_backend_symbol(lib, "MKL_Set_Num_Threads", state.mkl_set_threads);
+
+        // The integer width is not part of the symbol names, so ask the library
+        const char* (*openblas_config)() = nullptr;
+        int64_t (*blis_int_size)()       = nullptr;
+        int (*mkl_interface_layer)(int)  = nullptr;
+        cblas_backend_symbol(lib, "openblas_get_config", openblas_config);
+        cblas_backend_symbol(lib, "bli_info_get_blas_int_type_size", blis_int_size);
+        cblas_backend_symbol(lib, "MKL_Set_Interface_Layer", mkl_interface_layer);
+
+        if(openblas_config)
+            state.ilp64 = strstr(openblas_config(), "USE64BITINT") != nullptr;
+        else if(blis_int_size)
+            state.ilp64 = blis_int_size() == 64;
+        else if(mkl_interface_layer)
+            state.ilp64 = mkl_interface_layer(0 /* MKL_INTERFACE_LP64 */) != 0;
+    }
+#endif
+
+    void cblas_backend_set_threads(const cblas_backend_state& state, int n)
+    {
+        if(state.builtin)
+            builtin_threads = n;
+        else if(state.openblas_set_threads)
+            state.openblas_set_threads(n);
+        else if(state.blis_set_threads)
+            state.blis_set_threads(n);
+        else if(state.mkl_set_threads)
+            state.mkl_set_threads(n);
+    }
+
+    cblas_backend_state cblas_backend_open(const std::string& name)
+    {
+        cblas_backend_state state;
+
+        state.name = name;
+        if(state.name == "builtin")
+        {
+            state.builtin = true;
+        }
+        else if(state.name == "linked")
+        {
+#ifndef WIN32
+            state.openblas_get_threads = openblas_get_num_threads;
+            state.openblas_set_threads = openblas_set_num_threads;
+            state.blis_get_threads     = bli_thread_get_num_threads;
+            state.blis_set_threads     = bli_thread_set_num_threads;
+#endif
+        }
+        else
+        {
+#ifdef WIN32
+            cblas_backend_fail(state.name, "only linked and builtin are supported on Windows");
+#else
+            cblas_backend_load(state);
+#endif
+        }
+
+        const char* threads = getenv("ROCBLAS_CLIENT_CBLAS_THREADS");
+        if(threads && *threads)
+        {
+            int n = atoi(threads);
+            if(n <= 0)
+                cblas_backend_fail(state.name, "ROCBLAS_CLIENT_CBLAS_THREADS must be positive");
+            cblas_backend_set_threads(state, n);
+        }
+
+        return state;
+    }
+
+    const cblas_backend_state& cblas_backend()
+    {
+        static const cblas_backend_state state = [] {
+            std::string name = cblas_backend_requested();
+            if(name.empty())
+            {
+                const char* env = getenv("ROCBLAS_CLIENT_CBLAS");
+                name            = env && *env ? env : "linked";
+            }
+            return cblas_backend_open(name);
+        }();
+        return state;
+    }
+
+    // A backend other than the selected one, opened once on first use
+    const cblas_backend_state& cblas_backend(const std::string& name)
+    {
+        static std::mutex                                 mutex;
+        static std::map<std::string, cblas_backend_state> states;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto                        it = states.find(name);
+        if(it == states.end())
+            it = states.emplace(name, cblas_backend_open(name)).first;
+        return it->second;
+    }
+
+    /*
+     * ===========================================================================
+     *    builtin backend
+     * ===========================================================================
+     */
+
+    template <typename T>
+    inline T builtin_conj(const T& x)
+    {
+        if constexpr(rocblas_is_complex<T>)
+            return std::conj(x);
+        else
+            return x;
+    }
+
+    // Packs the mb x kb block at (i0, l0) of A, or of A^T when trans, into P with column l at
+    // P + l * ldp
+    template <typename T>
+    void builtin_pack(bool     trans,
+                      bool     conj,
+                      const T* A,
+                      int64_t  lda,
+                      int64_t  i0,
+                      int64_t  l0,
+                      int64_t  mb,
+                      int64_t  kb,
+                      T*       P,
+                      int64_t  ldp)
+    {
+        if(!trans)
+        {
+            for(int64_t l = 0; l < kb; l++)
+                for(int64_t i = 0; i < mb; i++)
+                {
+                    T a            = A[(i0 + i) + (l0 + l) * lda];
+                    P[l * ldp + i] = conj ? builtin_conj(a) : a;
+                }
+        }
+        else
+        {
+            for(int64_t i = 0; i < mb; i++)
+                for(int64_t l = 0; l < kb; l++)
+                {
+                    T a            = A[(l0 + l) + (i0 + i) * lda];
+                    P[l * ldp + i] = conj ? builtin_conj(a) : a;
+                }
+        }
+    }
+
+    // Blocked gemm: each C tile is accumulated over packed panels of op(A) and op(B) and then
+    // scaled once, so C is not read when beta is 0 and A and B are not read when alpha is 0
+    template <typename T>
+    void builtin_gemm(rocblas_operation transA,
+                      rocblas_operation transB,
+                      int64_t           m,
+                      int64_t           n,
+                      int64_t           k,
+                      T                 alpha,
+                      const T*          A,
+                      int64_t           lda,
+                      const T*          B,
+                      int64_t           ldb,
+                      T                 beta,
+                      T*                C,
+                      int64_t           ldc)
+    {
+        constexpr int64_t MB = 128, NB = 64, KB = 128;
+
+        if(m <= 0 || n <= 0)
+            return;
+        if(alpha == T(0))
+            k = 0;
+
+        int64_t mt = (m + MB - 1) / MB, nt = (n + NB - 1) / NB;
+
+#ifdef _OPENMP
+        int threads = builtin_threads > 0 ? int(builtin_threads) : omp_get_max_threads();
+
+#pragma omp parallel num_threads(threads) if(mt * nt > 1 && threads > 1)
+#endif
+        {
+            std::vector<T> Ap(MB * KB), Bp(NB * KB), acc(MB * NB);
+
+#ifdef _OPENMP
+#pragma omp for collapse(2) schedule(dynamic)
+#endif
+            for(int64_t jt = 0; jt < nt; jt++)
+                for(int64_t it = 0; it < mt; it++)
+                {
+                    int64_t i0 = it * MB, mb = std::min(MB, m - i0);
+                    int64_t j0 = jt * NB, nb = std::min(NB, n - j0);
+
+                    std::fill(acc.begin(), acc.end(), T(0));
+
+                    for(int64_t l0 = 0; l0 < k; l0 += KB)
+                    {
+                        int64_t kb = std::min(KB, k - l0);
+
+                        // Ap(i, l) = op(A)(i0 + i, l0 + l); Bp(j, l) = op(B)(l0 + l, j0 + j)
+                        builtin_pack(transA != rocblas_operation_none,
+                                     transA == rocblas_operation_conjugate_transpose,
+                                     A,
+                                     lda,
+                                     i0,
+                                     l0,
+                                     mb,
+                                     kb,
+                                     Ap.data(),
+                                     MB);
+                        builtin_pack(transB == rocblas_operation_none,
+                                     transB == rocblas_operation_conjugate_transpose,
+                                     B,
+                                     ldb,
+                                     j0,
+                                     l0,
+                                     nb,
+                                     kb,
+                                     Bp.data(),
+                                     NB);
+
+                        for(int64_t j = 0; j < nb; j++)
+                        {
+                            T* c = acc.data() + j * MB;
+                            for(int64_t l = 0; l < kb; l++)
+                            {
+                                const T* a = Ap.data() + l * MB;
+                                T        b = Bp[l * NB + j];
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+                                for(int64_t i = 0; i < mb; i++)
+                                    c[i] += a[i] * b;
+                            }
+                        }
+                    }
+
+                    for(int64_t j = 0; j < nb; j++)
+                    {
+                        T* c = C + i0 + (j0 + j) * ldc;
+                        for(int64_t i = 0; i < mb; i++)
+                            c[i] = beta == T(0) ? alpha * acc[j * MB + i]
+                                                : alpha * acc[j * MB + i] + beta * c[i];
+                    }
+                }
+        }
+    }
+
+    /*
+     * ===========================================================================
+     *    loaded and linked backends
+     * ===========================================================================
+     */
+
+    template <typename T>
+    constexpr int cblas_backend_slot = std::is_same_v<T, float>                   ? 0
+                                       : std::is_same_v<T, double>                ? 1
+                                       : std::is_same_v<T, rocblas_float_complex> ? 2
+                                                                                  : 3;
+
+    template <typename I, typename T>
+    void loaded_gemm(void*             fn,
+                     rocblas_operation transA,
+                     rocblas_operation transB,
+                     int64_t           m,
+                     int64_t           n,
+                     int64_t           k,
+                     T                 alpha,
+                     const T*          A,
+                     int64_t           lda,
+                     const T*          B,
+                     int64_t           ldb,
+                     T                 beta,
+                     T*                C,
+                     int64_t           ldc)
+    {
+        // CBLAS enums are passed as int; rocblas_operation has the CBLAS_TRANSPOSE values
+        if constexpr(rocblas_is_complex<T>)
+        {
+            using F = void (*)(int,
+                               int,
+                               int,
+                               I,
+                               I,
+                               I,
+                               const void*,
+                               const void*,
+                               I,
+                               const void*,
+                               I,
+                               const void*,
+                               void*,
+                               I);
+            reinterpret_cast<F>(fn)(
+                CblasColMajor, transA, transB, m, n, k, &alpha, A, lda, B, ldb, &beta, C, ldc);
+        }
+        else
+        {
+            using F = void (*)(int, int, int, I, I, I, T, const T*, I, const T*, I, T, T*, I);
+            reinterpret_cast<F>(fn)(
+                CblasColMajor, transA, transB, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+        }
+    }
+
+    void linked_gemm(CBLAS_TRANSPOSE transA,
+                     CBLAS_TRANSPOSE transB,
+                     int64_t         m,
+                     int64_t         n,
+                     int64_t         k,
+                     float           alpha,
+                     const float*    A,
+                     int64_t         lda,
+                     const float*    B,
+                     int64_t         ldb,
+                     float           beta,
+                     float*          C,
+                     int64_t         ldc)
+    {
+        cblas_sgemm(CblasColMajor, transA, transB, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+    }
+
+    void linked_gemm(CBLAS_TRANSPOSE transA,
+                     CBLAS_TRANSPOSE transB,
+                     int64_t         m,
+                     int64_t         n,
+                     int64_t         k,
+                     double          alpha,
+                     const double*   A,
+                     int64_t         lda,
+                     const double*   B,
+                     int64_t         ldb,
+                     double          beta,
+                     double*         C,
+                     int64_t         ldc)
+    {
+        cblas_dgemm(CblasColMajor, transA, transB, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+    }
+
+    void linked_gemm(CBLAS_TRANSPOSE              transA,
+                     CBLAS_TRANSPOSE              transB,
+                     int64_t                      m,
+                     int64_t                      n,
+                     int64_t                      k,
+                     rocblas_float_complex        alpha,
+                     const rocblas_float_complex* A,
+                     int64_t                      lda,
+                     const rocblas_float_complex* B,
+                     int64_t                      ldb,
+                     rocblas_float_complex        beta,
+                     rocblas_float_complex*       C,
+                     int64_t                      ldc)
+    {
+        cblas_cgemm(CblasColMajor, transA, transB, m, n, k, &alpha, A, lda, B, ldb, &beta, C, ldc);
+    }
+
+    void linked_gemm(CBLAS_TRANSPOSE               transA,
+                     CBLAS_TRANSPOSE               transB,
+                     int64_t                       m,
+                     int64_t                       n,
+                     int64_t                       k,
+                     rocblas_double_complex        alpha,
+                     const rocblas_double_complex* A,
+                     int64_t                       lda,
+                     const rocblas_double_complex* B,
+                     int64_t                       ldb,
+                     rocblas_double_complex        beta,
+                     rocblas_double_complex*       C,
+                     int64_t                       ldc)
+    {
+        cblas_zgemm(CblasColMajor, transA, transB, m, n, k, &alpha, A, lda, B, ldb, &beta, C, ldc);
+    }
+
+    // Runs a gemm on the given backend
+    template <typename T>
+    void backend_gemm(const cblas_backend_state& state,
+                      rocblas_operation          transA,
+                      rocblas_operation          transB,
+                      int64_t                    m,
+                      int64_t                    n,
+                      int64_t                    k,
+                      T                          alpha,
+                      const T*                   A,
+                      int64_t                    lda,
+                      const T*                   B,
+                      int64_t                    ldb,
+                      T                          beta,
+                      T*                         C,
+                      int64_t                    ldc)
+    {
+        void* fn = state.gemm[cblas_backend_slot<T>];
+
+        if(state.builtin)
+            builtin_gemm(transA, transB, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+        else if(!fn)
+            linked_gemm(CBLAS_TRANSPOSE(transA),
+                        CBLAS_TRANSPOSE(transB),
+                        m,
+                        n,
+                        k,
+                        alpha,
+                        A,
+                        lda,
+                        B,
+                        ldb,
+                        beta,
+                        C,
+                        ldc);
+        else if(state.ilp64)
+            loaded_gemm<int64_t>(fn, transA, transB, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+        else
+            loaded_gemm<int32_t>(fn, transA, transB, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+    }
+}
+
+void cblas_backend_set(const char* name)
+{
+    cblas_backend_requested() = name ? name : "";
+}
+
+const char* cblas_backend_name()
+{
+    return cblas_backend().name.c_str();
+}
+
+std::string cblas_backend_banner()
+{
+    std::string banner = "host reference BLAS: " + cblas_backend().name;
+    if(cblas_backend().name != "linked")
+        banner += " (gemm and the references built on it only; the other references use the"
+                  " linked CBLAS)";
+    return banner;
+}
+
+template <typename T>
+void cblas_backend_gemm(rocblas_operation transA,
+                        rocblas_operation transB,
+                        int64_t           m,
+                        int64_t           n,
+                        int64_t           k,
+                        T                 alpha,
+                        const T*          A,
+                        int64_t           lda,
+                        const T*          B,
+                        int64_t           ldb,
+                        T                 beta,
+                        T*                C,
+                        int64_t           ldc)
+{
+    backend_gemm(cblas_backend(), transA, transB, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+}
+
+template <typename T>
+void cblas_backend_gemm(const char*       backend,
+                        rocblas_operation transA,
+                        rocblas_operation transB,
+                        int64_t           m,
+                        int64_t           n,
+                        int64_t           k,
+                        T                 alpha,
+                        const T*          A,
+                        int64_t           lda,
+                        const T*          B,
+                        int64_t           ldb,
+                        T                 beta,
+                        T*                C,
+                        int64_t           ldc)
+{
+    backend_gemm(
+        cblas_backend(backend), transA, transB, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+}
+
+#define INSTANTIATE_CBLAS_BACKEND_GEMM(T_)                                          \
+    template void cblas_backend_gemm<T_>(rocblas_operation transA,                  \
+                                         rocblas_operation transB,                  \
+                                         int64_t           m,                       \
+                                         int64_t           n,                       \
+                                         int64_t           k,                       \
+                                         T_                alpha,                   \
+                                         const T_*         A,                       \
+                                         int64_t           lda,                     \
+                                         const T_*         B,                       \
+                                         int64_t           ldb,                     \
+                                         T_                beta,                    \
+                                         T_*               C,                       \
+                                         int64_t           ldc);                    \
+    template void cblas_backend_gemm<T_>(const char*       backend,                 \
+                                         rocblas_operation transA,                  \
+                                         rocblas_operation transB,                  \
+                                         int64_t           m,                       \
+                                         int64_t           n,                       \
+                                         int64_t           k,                       \
+                                         T_                alpha,                   \
+                                         const T_*         A,                       \
+                                         int64_t           lda,                     \
+                                         const T_*         B,                       \
+                                         int64_t           ldb,                     \
+                                         T_                beta,                    \
+                                         T_*               C,                       \
+                                         int64_t           ldc);
+
+INSTANTIATE_CBLAS_BACKEND_GEMM(float)
+INSTANTIATE_CBLAS_BACKEND_GEMM(double)
+INSTANTIATE_CBLAS_BACKEND_GEMM(rocblas_float_complex)
+INSTANTIATE_CBLAS_BACKEND_GEMM(rocblas_double_complex)
+
+#undef INSTANTIATE_CBLAS_BACKEND_GEMM
+
+/*
+ * ===========================================================================
+ *    thread control
+ * ===========================================================================
+ */
+
+int cblas_get_num_threads()
+{
+    const cblas_backend_state& state = cblas_backend();
+
+    if(state.builtin)
+    {
+#ifdef _OPENMP
+        return builtin_threads > 0 ? int(builtin_threads) : omp_get_max_threads();
+#else
+        return 1;
+#endif
+    }
+    if(state.openblas_get_threads)
+        return state.openblas_get_threads();
+    if(state.blis_get_threads)
+        return int(state.blis_get_threads());
+    if(state.mkl_get_threads)
+        return state.mkl_get_threads();
+    return 0;
+}
+
+void cblas_set_num_threads(int n)
+{
+    cblas_backend_set_threads(cblas_backend(), n);
+}
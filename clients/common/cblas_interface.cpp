@@ -20,8 +20,10 @@
  *
  * ************************************************************************/
 #include "cblas_interface.hpp"
+#include "cblas_semiring.hpp"
 #include "rocblas_vector.hpp"
 #include "utility.hpp"
+#include <algorithm>
 #include <bitset>
 #ifdef _OPENMP
 #include <omp.h>
@@ -574,6 +576,20 @@ inline rocblas_double_complex rocblas_conj(const rocblas_double_complex& x)
     return std::conj(x);
 }
 
+// copy op(X) for an mb x nb tile of a transposed operand into dst (leading dimension ld_dst),
+// reading src along its contiguous dimension rather than striding through it
+template <typename T>
+static void cblas_geam_transpose_tile(
+    const T* src, int64_t ld_src, int64_t mb, int64_t nb, bool conj, T* dst, int64_t ld_dst)
+{
+    for(int64_t i = 0; i < mb; i++)
+    {
+        const T* src_row = src + i * ld_src;
+        for(int64_t j = 0; j < nb; j++)
+            dst[i + j * ld_dst] = conj ? rocblas_conj(src_row[j]) : src_row[j];
+    }
+}
+
 template <typename T>
 void cblas_geam_helper(rocblas_operation transA,
                        rocblas_operation transB,
@@ -588,25 +604,92 @@ void cblas_geam_helper(rocblas_operation transA,
                        T*                C,
                        int64_t           ldc)
 {
-    int64_t inc1_A = transA == rocblas_operation_none ? 1 : lda;
-    int64_t inc2_A = transA == rocblas_operation_none ? lda : 1;
-    int64_t inc1_B = transB == rocblas_operation_none ? 1 : ldb;
-    int64_t inc2_B = transB == rocblas_operation_none ? ldb : 1;
+    // C is computed in cache sized tiles, threads own column blocks of C. A transposed operand is
+    // first copied into a thread local tile so every inner loop runs down a contiguous column;
+    // when both are transposed, both tiles are staged and C is still written a column at a time.
+    // The per element arithmetic is unchanged so results are bitwise identical to the untiled form.
+    constexpr int64_t tile = 64;
+
+    const bool use_A = static_cast<bool>(alpha);
+    const bool use_B = static_cast<bool>(beta);
+
+    const bool conj_A = transA == rocblas_operation_conjugate_transpose;
+    const bool conj_B = transB == rocblas_operation_conjugate_transpose;
+
+    // A and B are not read when alpha or beta is zero, they may not be valid pointers
+    const T zero_A = conj_A ? rocblas_conj(T(0)) : T(0);
+    const T zero_B = conj_B ? rocblas_conj(T(0)) : T(0);
 
 #ifdef _OPENMP
-#pragma omp parallel for
+#pragma omp parallel
 #endif
-    for(int64_t i = 0; i < M; i++)
     {
-        for(int64_t j = 0; j < N; j++)
+        std::vector<T> tile_A(use_A && transA != rocblas_operation_none ? tile * tile : 0);
+        std::vector<T> tile_B(use_B && transB != rocblas_operation_none ? tile * tile : 0);
+
+#ifdef _OPENMP
+#pragma omp for
+#endif
+        for(int64_t jb = 0; jb < N; jb += tile)
         {
-            T a_val = alpha ? A[i * inc1_A + j * inc2_A] : 0;
-            T b_val = beta ? B[i * inc1_B + j * inc2_B] : 0;
-            if(transA == rocblas_operation_conjugate_transpose)
-                a_val = rocblas_conj(a_val);
-            if(transB == rocblas_operation_conjugate_transpose)
-                b_val = rocblas_conj(b_val);
-            C[i + j * ldc] = alpha * a_val + beta * b_val;
+            const int64_t nb = std::min(tile, N - jb);
+
+            for(int64_t ib = 0; ib < M; ib += tile)
+            {
+                const int64_t mb = std::min(tile, M - ib);
+
+                // op(A) and op(B) restricted to this tile, addressed as a[i + j * ld_a]
+                const T* a    = nullptr;
+                int64_t  ld_a = 0;
+                if(use_A && transA == rocblas_operation_none)
+                {
+                    a    = A + ib + jb * lda;
+                    ld_a = lda;
+                }
+                else if(use_A)
+                {
+                    cblas_geam_transpose_tile(A + jb + ib * lda,
+                                              lda,
+                                              mb,
+                                              nb,
+                                              conj_A,
+                                              tile_A.data(),
+                                              tile);
+                    a    = tile_A.data();
+                    ld_a = tile;
+                }
+
+                const T* b    = nullptr;
+                int64_t  ld_b = 0;
+                if(use_B && transB == rocblas_operation_none)
+                {
+                    b    = B + ib + jb * ldb;
+                    ld_b = ldb;
+                }
+                else if(use_B)
+                {
+                    cblas_geam_transpose_tile(B + jb + ib * ldb,
+                                              ldb,
+                                              mb,
+                                              nb,
+                                              conj_B,
+                                              tile_B.data(),
+                                              tile);
+                    b    = tile_B.data();
+                    ld_b = tile;
+                }
+
+                for(int64_t j = 0; j < nb; j++)
+                {
+                    T* c = C + ib + (jb + j) * ldc;
+                    for(int64_t i = 0; i < mb; i++)
+                    {
+                        T a_val = a ? a[i + j * ld_a] : zero_A;
+                        T b_val = b ? b[i + j * ld_b] : zero_B;
+                        c[i]    = alpha * a_val + beta * b_val;
+                    }
+                }
+            }
         }
     }
 }
@@ -680,6 +763,129 @@ void cblas_geam(rocblas_operation       transa,
 }
 
 // gemm
+// Copy a rows x cols block of X (leading dimension ldx) into dst with leading dimension rows,
+// converting each contiguous column with conv(src, dst, n)
+template <typename Ti, typename Tw, typename Conv>
+static void cblas_gemm_convert_block(
+    const Ti* X, int64_t ldx, int64_t rows, int64_t cols, Tw* dst, Conv conv)
+{
+    for(int64_t c = 0; c < cols; c++)
+        conv(X + c * ldx, dst + c * rows, size_t(rows));
+}
+
+// Reference gemm for input types cblas does not support. Tiles of C are distributed over OpenMP
+// threads, and each tile together with the panels of A and B feeding it is converted on the fly
+// with the bulk conversion routines into thread local buffers of the compute type Tw, then
+// multiplied with the Tw cblas gemm. Panels keep the storage order of A and B so every
+// conversion runs over contiguous memory, and the transposes are left to cblas.
+// No full size converted copy of A, B or C is ever made.
+template <typename Tw, typename Ti, typename To, typename ConvIn, typename ConvOut>
+static void cblas_gemm_blocked(rocblas_operation transA,
+                               rocblas_operation transB,
+                               int64_t           m,
+                               int64_t           n,
+                               int64_t           k,
+                               Tw                alpha,
+                               const Ti*         A,
+                               int64_t           lda,
+                               const Ti*         B,
+                               int64_t           ldb,
+                               Tw                beta,
+                               To*               C,
+                               int64_t           ldc,
+                               ConvIn            conv_in,
+                               ConvOut           conv_out)
+{
+    constexpr int64_t MB = 128, NB = 128, KB = 256;
+
+    // A and B are not read when alpha is zero, as in cblas
+    const int64_t k_used = alpha != 0 ? k : 0;
+
+    const int64_t m_tiles = (m + MB - 1) / MB;
+    const int64_t n_tiles = (n + NB - 1) / NB;
+
+    const bool trans_A = transA != rocblas_operation_none;
+    const bool trans_B = transB != rocblas_operation_none;
+
+#ifdef _OPENMP
+    // The tiles are spread over the OpenMP threads, and the host BLAS is pinned to one thread
+    // meanwhile so the two levels do not oversubscribe the cores. The thread count is read first,
+    // since pinning an OpenMP build of the host BLAS also pins OpenMP.
+    const int                 num_threads = omp_get_max_threads();
+    cblas_single_thread_guard single_thread;
+
+#pragma omp parallel num_threads(num_threads)
+#endif
+    {
+        host_vector<Tw> A_panel(MB * KB), B_panel(KB * NB), C_tile(MB * NB);
+
+#ifdef _OPENMP
+#pragma omp for collapse(2) schedule(dynamic)
+#endif
+        for(int64_t jt = 0; jt < n_tiles; jt++)
+        {
+            for(int64_t it = 0; it < m_tiles; it++)
+            {
+                const int64_t i0 = it * MB, mb = std::min(MB, m - i0);
+                const int64_t j0 = jt * NB, nb = std::min(NB, n - j0);
+
+                // C is not read when beta is zero, as in cblas
+                if(beta != 0)
+                    cblas_gemm_convert_block(
+                        C + i0 + j0 * ldc, ldc, mb, nb, C_tile.data(), conv_in);
+                else
+                    std::fill(C_tile.begin(), C_tile.end(), Tw(0));
+
+                // a single pass with an empty panel still applies beta when k == 0
+                int64_t p0 = 0;
+                do
+                {
+                    const int64_t kb = std::min(KB, k_used - p0);
+
+                    // op(A) is mb x kb, stored as A (mb x kb) or A^T (kb x mb)
+                    const int64_t ld_a = trans_A ? kb : mb;
+                    if(trans_A)
+                        cblas_gemm_convert_block(
+                            A + p0 + i0 * lda, lda, kb, mb, A_panel.data(), conv_in);
+                    else
+                        cblas_gemm_convert_block(
+                            A + i0 + p0 * lda, lda, mb, kb, A_panel.data(), conv_in);
+
+                    // op(B) is kb x nb, stored as B (kb x nb) or B^T (nb x kb)
+                    const int64_t ld_b = trans_B ? nb : kb;
+                    if(trans_B)
+                        cblas_gemm_convert_block(
+                            B + j0 + p0 * ldb, ldb, nb, kb, B_panel.data(), conv_in);
+                    else
+                        cblas_gemm_convert_block(
+                            B + p0 + j0 * ldb, ldb, kb, nb, B_panel.data(), conv_in);
+
+                    cblas_gemm<Tw, Tw, Tw>(transA,
+                                           transB,
+                                           mb,
+                                           nb,
+                                           kb,
+                                           alpha,
+                                           A_panel.data(),
+                                           std::max(ld_a, int64_t(1)),
+                                           B_panel.data(),
+                                           std::max(ld_b, int64_t(1)),
+                                           p0 ? Tw(1) : beta,
+                                           C_tile.data(),
+                                           mb);
+                } while((p0 += KB) < k_used);
+
+                for(int64_t j = 0; j < nb; j++)
+                    conv_out(C_tile.data() + j * mb, C + i0 + (j0 + j) * ldc, size_t(mb));
+            }
+        }
+    }
+}
+
+// converters for cblas_gemm_blocked
+static const auto cblas_gemm_convert
+    = [](const auto* src, auto* dst, size_t n) { rocblas_convert(src, dst, n); };
+
 template <>
 void cblas_gemm<rocblas_bfloat16, float, float>(rocblas_operation                    transA,
                                                 rocblas_operation                    transB,
@@ -698,33 +904,21 @@ void cblas_gemm<rocblas_bfloat16, float, float>(rocblas_operation
 {
     // cblas does not support rocblas_bfloat16, so convert to higher precision float
     // This will give more precise result which is acceptable for testing
-
-    size_t sizeA = (transA == rocblas_operation_none ? k : m) * size_t(lda);
-    size_t sizeB = (transB == rocblas_operation_none ? n : k) * size_t(ldb);
-
-    host_vector<float> A_float(sizeA), B_float(sizeB);
-
-    for(size_t i = 0; i < sizeA; i++)
-        A_float[i] = static_cast<float>(A[i]);
-    for(size_t i = 0; i < sizeB; i++)
-        B_float[i] = static_cast<float>(B[i]);
-
-    // just directly cast, since transA, transB are integers in the enum
-    // printf("transA: rocblas =%d, cblas=%d\n", transA, static_cast<CBLAS_TRANSPOSE>(transA) );
-    cblas_sgemm(CblasColMajor,
-                static_cast<CBLAS_TRANSPOSE>(transA),
-                static_cast<CBLAS_TRANSPOSE>(transB),
-                m,
-                n,
-                k,
-                alpha,
-                A_float,
-                lda,
-                B_float,
-                ldb,
-                beta,
-                C,
-                ldc);
+    cblas_gemm_blocked(transA,
+                       transB,
+                       m,
+                       n,
+                       k,
+                       alpha,
+                       A,
+                       lda,
+                       B,
+                       ldb,
+                       beta,
+                       C,
+                       ldc,
+                       cblas_gemm_convert,
+                       cblas_gemm_convert);
 }
 
 template <>
@@ -746,39 +940,21 @@ void cblas_gemm<rocblas_bfloat16, rocblas_bfloat16, float>(
 {
     // cblas does not support rocblas_bfloat16, so convert to higher precision float
     // This will give more precise result which is acceptable for testing
-
-    size_t sizeA = (transA == rocblas_operation_none ? k : m) * size_t(lda);
-    size_t sizeB = (transB == rocblas_operation_none ? n : k) * size_t(ldb);
-    size_t sizeC = n * size_t(ldc);
-
-    host_vector<float> A_float(sizeA), B_float(sizeB), C_float(sizeC);
-
-    for(size_t i = 0; i < sizeA; i++)
-        A_float[i] = static_cast<float>(A[i]);
-    for(size_t i = 0; i < sizeB; i++)
-        B_float[i] = static_cast<float>(B[i]);
-    for(size_t i = 0; i < sizeC; i++)
-        C_float[i] = static_cast<float>(C[i]);
-
-    // just directly cast, since transA, transB are integers in the enum
-    // printf("transA: rocblas =%d, cblas=%d\n", transA, static_cast<CBLAS_TRANSPOSE>(transA) );
-    cblas_sgemm(CblasColMajor,
-                static_cast<CBLAS_TRANSPOSE>(transA),
-                static_cast<CBLAS_TRANSPOSE>(transB),
-                m,
-                n,
-                k,
-                alpha,
-                A_float,
-                lda,
-                B_float,
-                ldb,
-                beta,
-                C_float,
-                ldc);
-
-    for(size_t i = 0; i < sizeC; i++)
-        C[i] = static_cast<rocblas_bfloat16>(C_float[i]);
+    cblas_gemm_blocked(transA,
+                       transB,
+                       m,
+                       n,
+                       k,
+                       alpha,
+                       A,
+                       lda,
+                       B,
+                       ldb,
+                       beta,
+                       C,
+                       ldc,
+                       cblas_gemm_convert,
+                       cblas_gemm_convert);
 }
 
 template <>
@@ -799,33 +975,21 @@ void cblas_gemm<rocblas_half, float, float>(rocblas_operation
 {
     // cblas does not support rocblas_half, so convert to higher precision float
     // This will give more precise result which is acceptable for testing
-
-    size_t sizeA = (transA == rocblas_operation_none ? k : m) * size_t(lda);
-    size_t sizeB = (transB == rocblas_operation_none ? n : k) * size_t(ldb);
-
-    host_vector<float> A_float(sizeA), B_float(sizeB);
-
-    for(size_t i = 0; i < sizeA; i++)
-        A_float[i] = A[i];
-    for(size_t i = 0; i < sizeB; i++)
-        B_float[i] = B[i];
-
-    // just directly cast, since transA, transB are integers in the enum
-    // printf("transA: rocblas =%d, cblas=%d\n", transA, static_cast<CBLAS_TRANSPOSE>(transA) );
-    cblas_sgemm(CblasColMajor,
-                static_cast<CBLAS_TRANSPOSE>(transA),
-                static_cast<CBLAS_TRANSPOSE>(transB),
-                m,
-                n,
-                k,
-                alpha,
-                A_float,
-                lda,
-                B_float,
-                ldb,
-                beta,
-                C,
-                ldc);
+    cblas_gemm_blocked(transA,
+                       transB,
+                       m,
+                       n,
+                       k,
+                       alpha,
+                       A,
+                       lda,
+                       B,
+                       ldb,
+                       beta,
+                       C,
+                       ldc,
+                       cblas_gemm_convert,
+                       cblas_gemm_convert);
 }
 
 template <>
@@ -846,51 +1010,37 @@ void cblas_gemm<rocblas_half, rocblas_half, float>(rocblas_operation
 {
     // cblas does not support rocblas_half, so convert to higher precision float
     // This will give more precise result which is acceptable for testing
-
-    size_t sizeA = (transA == rocblas_operation_none ? k : m) * size_t(lda);
-    size_t sizeB = (transB == rocblas_operation_none ? n : k) * size_t(ldb);
-    size_t sizeC = n * size_t(ldc);
-
-    host_vector<float> A_float(sizeA), B_float(sizeB), C_float(sizeC);
-
-    if(round != rocblas_bfloat16::rocblas_truncate_t::rocblas_round_near_even)
-    {
-        for(size_t i = 0; i < sizeA; i++)
-            A_float[i] = rocblas_bfloat16(float(A[i]), round);
-        for(size_t i = 0; i < sizeB; i++)
-            B_float[i] = rocblas_bfloat16(float(B[i]), round);
-        for(size_t i = 0; i < sizeC; i++)
-            C_float[i] = rocblas_bfloat16(float(C[i]), round);
-    }
-    else
-    {
-        for(size_t i = 0; i < sizeA; i++)
-            A_float[i] = A[i];
-        for(size_t i = 0; i < sizeB; i++)
-            B_float[i] = B[i];
-        for(size_t i = 0; i < sizeC; i++)
-            C_float[i] = C[i];
-    }
-
-    // just directly cast, since transA, transB are integers in the enum
-    // printf("transA: rocblas =%d, cblas=%d\n", transA, static_cast<CBLAS_TRANSPOSE>(transA) );
-    cblas_sgemm(CblasColMajor,
-                static_cast<CBLAS_TRANSPOSE>(transA),
-                static_cast<CBLAS_TRANSPOSE>(transB),
-                m,
-                n,
-                k,
-                alpha,
-                A_float,
-                lda,
-                B_float,
-                ldb,
-                beta,
-                C_float,
-                ldc);
-
-    for(size_t i = 0; i < sizeC; i++)
-        C[i] = rocblas_half(C_float[i]);
+    // With a bfloat16 rounding mode the inputs are also rounded through bfloat16
+    auto to_float = [round](const rocblas_half* src, float* dst, size_t n) {
+        rocblas_convert(src, dst, n);
+        if(round == rocblas_bfloat16::rocblas_truncate_t::rocblas_round_near_even)
+            return;
+
+        constexpr size_t chunk = 256;
+        rocblas_bfloat16 rounded[chunk];
+        for(size_t i = 0; i < n; i += chunk)
+        {
+            size_t len = std::min(chunk, n - i);
+            rocblas_convert(dst + i, rounded, len, rocblas_convert_round_from(round));
+            rocblas_convert(rounded, dst + i, len);
+        }
+    };
+
+    cblas_gemm_blocked(transA,
+                       transB,
+                       m,
+                       n,
+                       k,
+                       alpha,
+                       A,
+                       lda,
+                       B,
+                       ldb,
+                       beta,
+                       C,
+                       ldc,
+                       to_float,
+                       cblas_gemm_convert);
 }
 
 template <>
@@ -912,41 +1062,43 @@ void cblas_gemm<rocblas_half, rocblas_half, rocblas_half>(
 {
     // cblas does not support rocblas_half, so convert to higher precision float
     // This will give more precise result which is acceptable for testing
-    float alpha_float = alpha;
-    float beta_float  = beta;
-
-    size_t sizeA = (transA == rocblas_operation_none ? k : m) * size_t(lda);
-    size_t sizeB = (transB == rocblas_operation_none ? n : k) * size_t(ldb);
-    size_t sizeC = n * size_t(ldc);
-
-    host_vector<float> A_float(sizeA), B_float(sizeB), C_float(sizeC);
-
-    for(size_t i = 0; i < sizeA; i++)
-        A_float[i] = A[i];
-    for(size_t i = 0; i < sizeB; i++)
-        B_float[i] = B[i];
-    for(size_t i = 0; i < sizeC; i++)
-        C_float[i] = C[i];
-
-    // just directly cast, since transA, transB are integers in the enum
-    // printf("transA: rocblas =%d, cblas=%d\n", transA, static_cast<CBLAS_TRANSPOSE>(transA) );
-    cblas_sgemm(CblasColMajor,
-                static_cast<CBLAS_TRANSPOSE>(transA),
-                static_cast<CBLAS_TRANSPOSE>(transB),
-                m,
-                n,
-                k,
-                alpha_float,
-                A_float,
-                lda,
-                B_float,
-                ldb,
-                beta_float,
-                C_float,
-                ldc);
-
-    for(size_t i = 0; i < sizeC; i++)
-        C[i] = rocblas_half(C_float[i]);
+    cblas_gemm_blocked(transA,
+                       transB,
+                       m,
+                       n,
+                       k,
+                       float(alpha),
+                       A,
+                       lda,
+                       B,
+                       ldb,
+                       float(beta),
+                       C,
+                       ldc,
+                       cblas_gemm_convert,
+                       cblas_gemm_convert);
+}
+
+// op(X) restricted to a rows x cols int8 panel, stored with each row of op(X) contiguous so the
+// dot products of cblas_gemm_int8 run over unit stride on both operands
+static void cblas_gemm_int8_pack_rows(rocblas_operation trans,
+                                      const int8_t*     X,
+                                      int64_t           ldx,
+                                      int64_t           rows,
+                                      int64_t           cols,
+                                      int8_t*           dst)
+{
+    if(trans == rocblas_operation_none)
+    {
+        for(int64_t c = 0; c < cols; c++)
+            for(int64_t r = 0; r < rows; r++)
+                dst[c + r * cols] = X[r + c * ldx];
+    }
+    else
+    {
+        for(int64_t r = 0; r < rows; r++)
+            std::copy(X + r * ldx, X + r * ldx + cols, dst + r * cols);
+    }
 }
 
 template <>
@@ -965,45 +1117,172 @@ void cblas_gemm<int8_t, int32_t, int32_t>(rocblas_operation                    t
                                           int64_t                              ldc,
                                           rocblas_bfloat16::rocblas_truncate_t round)
 {
-    // cblas does not support int8_t input / int32_t output, however non-overflowing
-    // 32-bit integer operations can be represented accurately with double-precision
-    // floats, so convert to doubles and downcast result down to int32_t.
-    // NOTE: This will not properly account for 32-bit integer overflow, however
-    //       the result should be acceptable for testing.
-
-    size_t const sizeA = ((transA == rocblas_operation_none) ? k : m) * size_t(lda);
-    size_t const sizeB = ((transB == rocblas_operation_none) ? n : k) * size_t(ldb);
-    size_t const sizeC = n * size_t(ldc);
-
-    host_vector<double> A_double(sizeA);
-    host_vector<double> B_double(sizeB);
-    host_vector<double> C_double(sizeC);
-
-    for(size_t i = 0; i < sizeA; i++)
-        A_double[i] = static_cast<double>(A[i]);
-    for(size_t i = 0; i < sizeB; i++)
-        B_double[i] = static_cast<double>(B[i]);
-    for(size_t i = 0; i < sizeC; i++)
-        C_double[i] = static_cast<double>(C[i]);
-
-    // just directly cast, since transA, transB are integers in the enum
-    cblas_dgemm(CblasColMajor,
-                static_cast<CBLAS_TRANSPOSE>(transA),
-                static_cast<CBLAS_TRANSPOSE>(transB),
-                m,
-                n,
-                k,
-                alpha,
-                A_double,
-                lda,
-                B_double,
-                ldb,
-                beta,
-                C_double,
-                ldc);
-
-    for(size_t i = 0; i < sizeC; i++)
-        C[i] = static_cast<int32_t>(C_double[i]);
+    // Native int8 x int8 -> int32 reference. Products are summed in 32-bit integers and every
+    // step wraps modulo 2^32 like the device, so results are exact even when they overflow.
+    // Unsigned arithmetic is used for the wrapping steps since signed overflow is undefined.
+    constexpr int64_t MB = 64, NB = 64, KB = 256;
+
+    const int64_t m_tiles = (m + MB - 1) / MB;
+    const int64_t n_tiles = (n + NB - 1) / NB;
+
+    // A and B are not read when alpha is zero, C is not read when beta is zero
+    const int64_t k_used = alpha ? k : 0;
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        host_vector<int8_t>   A_panel(MB * KB), B_panel(NB * KB);
+        host_vector<uint32_t> C_tile(MB * NB);
+
+#ifdef _OPENMP
+#pragma omp for collapse(2) schedule(dynamic)
+#endif
+        for(int64_t jt = 0; jt < n_tiles; jt++)
+        {
+            for(int64_t it = 0; it < m_tiles; it++)
+            {
+                const int64_t i0 = it * MB, mb = std::min(MB, m - i0);
+                const int64_t j0 = jt * NB, nb = std::min(NB, n - j0);
+
+                std::fill(C_tile.begin(), C_tile.end(), 0);
+
+                for(int64_t p0 = 0; p0 < k_used; p0 += KB)
+                {
+                    const int64_t kb = std::min(KB, k_used - p0);
+
+                    // rows of op(A) and columns of op(B), i.e. rows of op(B)^T
+                    cblas_gemm_int8_pack_rows(transA,
+                                              transA == rocblas_operation_none
+                                                  ? A + i0 + p0 * lda
+                                                  : A + p0 + i0 * lda,
+                                              lda,
+                                              mb,
+                                              kb,
+                                              A_panel.data());
+                    cblas_gemm_int8_pack_rows(transB == rocblas_operation_none
+                                                  ? rocblas_operation_transpose
+                                                  : rocblas_operation_none,
+                                              transB == rocblas_operation_none
+                                                  ? B + p0 + j0 * ldb
+                                                  : B + j0 + p0 * ldb,
+                                              ldb,
+                                              nb,
+                                              kb,
+                                              B_panel.data());
+
+                    // |dot| <= KB * 128 * 128 so a panel never overflows int32
+                    for(int64_t j = 0; j < nb; j++)
+                    {
+                        const int8_t* b = B_panel.data() + j * kb;
+                        for(int64_t i = 0; i < mb; i++)
+                        {
+                            const int8_t* a   = A_panel.data() + i * kb;
+                            int32_t       dot = 0;
+#ifdef _OPENMP
+#pragma omp simd reduction(+ : dot)
+#endif
+                            for(int64_t p = 0; p < kb; p++)
+                                dot += int32_t(a[p]) * int32_t(b[p]);
+
+                            C_tile[i + j * mb] += uint32_t(dot);
+                        }
+                    }
+                }
+
+                for(int64_t j = 0; j < nb; j++)
+                {
+                    for(int64_t i = 0; i < mb; i++)
+                    {
+                        int32_t& c   = C[(i0 + i) + (j0 + j) * ldc];
+                        uint32_t res = uint32_t(alpha) * C_tile[i + j * mb];
+                        if(beta)
+                            res += uint32_t(beta) * uint32_t(c);
+                        c = int32_t(res);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// C = alpha * op(A) * op(B) + beta * C on the uplo triangle of the n x n matrix C only, as host
+// gemm calls: a rectangular panel above (upper) or below (lower) each diagonal block, and the
+// diagonal block itself through a scratch tile of which only the triangle is copied back.
+template <typename T>
+static void cblas_gemm_triangle(rocblas_fill      uplo,
+                                rocblas_operation transA,
+                                rocblas_operation transB,
+                                int64_t           n,
+                                int64_t           k,
+                                T                 alpha,
+                                const T*          A,
+                                int64_t           lda,
+                                const T*          B,
+                                int64_t           ldb,
+                                T                 beta,
+                                T*                C,
+                                int64_t           ldc)
+{
+    constexpr int64_t NB = 256;
+
+    // row i of op(A) and column j of op(B)
+    const int64_t row_A = transA == rocblas_operation_none ? 1 : lda;
+    const int64_t col_B = transB == rocblas_operation_none ? ldb : 1;
+
+    host_vector<T> tile(NB * NB);
+
+    for(int64_t j0 = 0; j0 < n; j0 += NB)
+    {
+        const int64_t nb = std::min(NB, n - j0);
+
+        // off-diagonal panel, rows [i0, i0 + mb) of column block j0
+        const int64_t i0 = uplo == rocblas_fill_upper ? 0 : j0 + nb;
+        const int64_t mb = uplo == rocblas_fill_upper ? j0 : n - j0 - nb;
+        if(mb > 0)
+            cblas_gemm<T>(transA,
+                          transB,
+                          mb,
+                          nb,
+                          k,
+                          alpha,
+                          A + i0 * row_A,
+                          lda,
+                          B + j0 * col_B,
+                          ldb,
+                          beta,
+                          C + i0 + j0 * ldc,
+                          ldc);
+
+        // diagonal block; the scratch tile is not read when beta is zero
+        T* C_diag = C + j0 + j0 * ldc;
+        if(beta != T(0))
+            for(int64_t j = 0; j < nb; j++)
+                std::copy(C_diag + j * ldc, C_diag + j * ldc + nb, tile.data() + j * nb);
+
+        cblas_gemm<T>(transA,
+                      transB,
+                      nb,
+                      nb,
+                      k,
+                      alpha,
+                      A + j0 * row_A,
+                      lda,
+                      B + j0 * col_B,
+                      ldb,
+                      beta,
+                      tile.data(),
+                      nb);
+
+        for(int64_t j = 0; j < nb; j++)
+        {
+            const int64_t i_begin = uplo == rocblas_fill_upper ? 0 : j;
+            const int64_t i_end   = uplo == rocblas_fill_upper ? j + 1 : nb;
+            std::copy(tile.data() + i_begin + j * nb,
+                      tile.data() + i_end + j * nb,
+                      C_diag + i_begin + j * ldc);
+        }
+    }
 }
 
 //GEMMT
@@ -1022,61 +1301,10 @@ void cblas_gemmt(rocblas_fill      uplo,
                  T*                C,
                  int64_t           ldc)
 {
-    int64_t inc1_A = transA == rocblas_operation_none ? 1 : lda;
-    int64_t inc2_A = transA == rocblas_operation_none ? lda : 1;
-    int64_t inc1_B = transB == rocblas_operation_none ? 1 : ldb;
-    int64_t inc2_B = transB == rocblas_operation_none ? ldb : 1;
+    if(N <= 0)
+        return;
 
-    if(uplo == rocblas_fill_upper)
-    {
-        //upper
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-        for(int row = 0; row < N; row++)
-        {
-            for(int col = row; col < N; col++)
-            {
-                T t = T(0.0);
-                for(int elem = 0; elem < K; elem++)
-                {
-                    T a_val = alpha ? A[row * inc1_A + elem * inc2_A] : 0;
-                    T b_val = alpha ? B[elem * inc1_B + col * inc2_B] : 0;
-                    if(transA == rocblas_operation_conjugate_transpose)
-                        a_val = rocblas_conj(a_val);
-                    if(transB == rocblas_operation_conjugate_transpose)
-                        b_val = rocblas_conj(b_val);
-                    t += a_val * b_val;
-                }
-                C[row + col * ldc] = beta ? beta * C[row + col * ldc] + alpha * t : alpha * t;
-            }
-        }
-    }
-    else
-    {
-        //lower
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-        for(int row = 0; row < N; row++)
-        {
-            for(int col = 0; col <= row; col++)
-            {
-                T t = T(0.0);
-                for(int elem = 0; elem < K; elem++)
-                {
-                    T a_val = alpha ? A[row * inc1_A + elem * inc2_A] : 0;
-                    T b_val = alpha ? B[elem * inc1_B + col * inc2_B] : 0;
-                    if(transA == rocblas_operation_conjugate_transpose)
-                        a_val = rocblas_conj(a_val);
-                    if(transB == rocblas_operation_conjugate_transpose)
-                        b_val = rocblas_conj(b_val);
-                    t += a_val * b_val;
-                }
-                C[row + col * ldc] = beta ? beta * C[row + col * ldc] + alpha * t : alpha * t;
-            }
-        }
-    }
+    cblas_gemm_triangle<T>(uplo, transA, transB, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
 }
 
 //gemmt instantiations
@@ -1150,27 +1378,8 @@ void cblas_geam_min_plus(rocblas_operation transA,
                          T*                D,
                          int64_t           ldd)
 {
-    bool TRANSA = transA != rocblas_operation_none;
-    bool TRANSB = transB != rocblas_operation_none;
-
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-    for(int64_t n1 = 0; n1 < n; n1++)
-    {
-        for(int64_t m1 = 0; m1 < m; m1++)
-        {
-            size_t idxC = size_t(ldc) * n1 + m1;
-            size_t idxD = size_t(ldd) * n1 + m1;
-            D[idxD]     = beta * C[idxC];
-            for(int64_t k1 = 0; k1 < k; k1++)
-            {
-                size_t idxA = TRANSA ? size_t(lda) * m1 + k1 : size_t(lda) * k1 + m1;
-                size_t idxB = TRANSB ? size_t(ldb) * k1 + n1 : size_t(ldb) * n1 + k1;
-                D[idxD]     = std::min(alpha * (A[idxA] + B[idxB]), D[idxD]);
-            }
-        }
-    }
+    cblas_semiring_gemm<semiring_min_plus<T>>(
+        transA, transB, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc, D, ldd);
 }
 
 template <typename T>
@@ -1190,27 +1399,8 @@ void cblas_geam_plus_min(rocblas_operation transA,
                          T*                D,
                          int64_t           ldd)
 {
-    bool TRANSA = transA != rocblas_operation_none;
-    bool TRANSB = transB != rocblas_operation_none;
-
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-    for(int64_t n1 = 0; n1 < n; n1++)
-    {
-        for(int64_t m1 = 0; m1 < m; m1++)
-        {
-            size_t idxC = size_t(ldc) * n1 + m1;
-            size_t idxD = size_t(ldd) * n1 + m1;
-            D[idxD]     = beta * C[idxC];
-            for(int64_t k1 = 0; k1 < k; k1++)
-            {
-                size_t idxA = TRANSA ? size_t(lda) * m1 + k1 : size_t(lda) * k1 + m1;
-                size_t idxB = TRANSB ? size_t(ldb) * k1 + n1 : size_t(ldb) * n1 + k1;
-                D[idxD] += std::min(alpha * A[idxA], alpha * B[idxB]);
-            }
-        }
-    }
+    cblas_semiring_gemm<semiring_plus_min<T>>(
+        transA, transB, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc, D, ldd);
 }
 
 template <typename T, typename U>
@@ -1230,112 +1420,15 @@ void cblas_herkx(rocblas_fill      uplo,
     if(n <= 0 || (*beta == 1 && (k == 0 || *alpha == 0)))
         return;
 
-    if(transA == rocblas_operation_none)
-    {
-        if(uplo == rocblas_fill_upper)
-        {
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-            for(int64_t j = 0; j < n; ++j)
-            {
-                for(int64_t i = 0; i <= j; i++)
-                {
-                    C[i + j * ldc] = *beta ? *beta * C[i + j * ldc] : 0;
-                }
+    // C = alpha * A * B^H + beta * C, or alpha * A^H * B + beta * C
+    rocblas_operation transB = transA == rocblas_operation_none
+                                   ? rocblas_operation_conjugate_transpose
+                                   : rocblas_operation_none;
 
-                if(*alpha)
-                    for(int64_t l = 0; l < k; l++)
-                    {
-                        T temp = *alpha * std::conj(B[j + l * ldb]);
-                        for(int64_t i = 0; i <= j; ++i)
-                        {
-                            C[i + j * ldc] += temp * A[i + l * lda];
-                        }
-                    }
-                C[j + j * ldc].imag(0);
-            }
-        }
-        else // lower
-        {
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-            for(int64_t j = 0; j < n; ++j)
-            {
-                for(int64_t i = j; i < n; i++)
-                {
-                    C[i + j * ldc] = *beta ? *beta * C[i + j * ldc] : 0;
-                }
+    cblas_gemm_triangle<T>(uplo, transA, transB, n, k, *alpha, A, lda, B, ldb, T(*beta), C, ldc);
 
-                if(*alpha)
-                    for(int64_t l = 0; l < k; l++)
-                    {
-                        T temp = *alpha * std::conj(B[j + l * ldb]);
-                        for(int64_t i = j; i < n; ++i)
-                        {
-                            C[i + j * ldc] += temp * A[i + l * lda];
-                        }
-                    }
-                C[j + j * ldc].imag(0);
-            }
-        }
-    }
-    else // conjugate transpose
-    {
-        if(uplo == rocblas_fill_upper)
-        {
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-            for(int64_t j = 0; j < n; ++j)
-            {
-                for(int64_t i = 0; i <= j; i++)
-                {
-                    C[i + j * ldc] = *beta ? *beta * C[i + j * ldc] : 0;
-
-                    if(*alpha)
-                    {
-                        T temp(0);
-                        for(int64_t l = 0; l < k; l++)
-                        {
-                            temp += std::conj(A[l + i * lda]) * B[l + j * ldb];
-                        }
-                        C[i + j * ldc] += *alpha * temp;
-                    }
-
-                    if(i == j)
-                        C[j + j * ldc].imag(0);
-                }
-            }
-        }
-        else // lower
-        {
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-            for(int64_t j = 0; j < n; ++j)
-            {
-                for(int64_t i = j; i < n; i++)
-                {
-                    C[i + j * ldc] = *beta ? *beta * C[i + j * ldc] : 0;
-
-                    if(*alpha)
-                    {
-                        T temp(0);
-                        for(int64_t l = 0; l < k; l++)
-                        {
-                            temp += std::conj(A[l + i * lda]) * B[l + j * ldb];
-                        }
-                        C[i + j * ldc] += *alpha * temp;
-                    }
-
-                    if(i == j)
-                        C[j + j * ldc].imag(0);
-                }
-            }
-        }
-    }
+    for(int64_t j = 0; j < n; j++)
+        C[j + j * ldc].imag(0);
 }
 
 // instantiations
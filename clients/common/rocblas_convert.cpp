@@ -0,0 +1,307 @@
+/* ************************************************************************
+ * Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell cop-
+ * ies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM-
+ * PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNE-
+ * CTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ************************************************************************ */
+
+#include "rocblas_convert.hpp"
+#include <array>
+#include <cstring>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if(defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(__clang__))
+#define ROCBLAS_CONVERT_X86 1
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    // spans shorter than this are converted on the calling thread
+    constexpr size_t convert_chunk = size_t(1) << 16;
+
+    // run kernel(begin, end) over [0, n) split into chunks over the OpenMP threads
+    template <typename K>
+    void convert_parallel(size_t n, K kernel)
+    {
+        if(n < 2 * convert_chunk)
+            return kernel(size_t(0), n);
+
+        const size_t chunks = (n + convert_chunk - 1) / convert_chunk;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for(size_t c = 0; c < chunks; c++)
+        {
+            size_t begin = c * convert_chunk;
+            size_t end   = begin + convert_chunk < n ? begin + convert_chunk : n;
+            kernel(begin, end);
+        }
+    }
+
+    // counter based random value for stochastic rounding of element i
+    inline uint32_t convert_rng(uint32_t seed, size_t i)
+    {
+        uint64_t x = (uint64_t(seed) << 32) ^ uint64_t(i);
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdull;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ull;
+        x ^= x >> 33;
+        return uint32_t(x);
+    }
+
+    inline uint32_t float_bits(float f)
+    {
+        uint32_t u;
+        std::memcpy(&u, &f, sizeof(u));
+        return u;
+    }
+
+    // rocblas_half, using the F16C or AVX-512 conversion instructions when available
+
+#ifdef ROCBLAS_CONVERT_X86
+    __attribute__((target("avx512f"))) void
+        half_to_float_avx512(const rocblas_half* src, float* dst, size_t begin, size_t end)
+    {
+        size_t i = begin;
+        for(; i + 16 <= end; i += 16)
+            _mm512_storeu_ps(dst + i,
+                             _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*)(src + i))));
+        for(; i < end; i++)
+            dst[i] = float(src[i]);
+    }
+
+    __attribute__((target("avx512f"))) void
+        float_to_half_avx512(const float* src, rocblas_half* dst, size_t begin, size_t end)
+    {
+        size_t i = begin;
+        for(; i + 16 <= end; i += 16)
+            _mm256_storeu_si256(
+                (__m256i*)(dst + i),
+                _mm512_cvtps_ph(_mm512_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+        for(; i < end; i++)
+            dst[i] = rocblas_half(src[i]);
+    }
+
+    __attribute__((target("avx,f16c"))) void
+        half_to_float_f16c(const rocblas_half* src, float* dst, size_t begin, size_t end)
+    {
+        size_t i = begin;
+        for(; i + 8 <= end; i += 8)
+            _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(src + i))));
+        for(; i < end; i++)
+            dst[i] = float(src[i]);
+    }
+
+    __attribute__((target("avx,f16c"))) void
+        float_to_half_f16c(const float* src, rocblas_half* dst, size_t begin, size_t end)
+    {
+        size_t i = begin;
+        for(; i + 8 <= end; i += 8)
+            _mm_storeu_si128((__m128i*)(dst + i),
+                             _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+        for(; i < end; i++)
+            dst[i] = rocblas_half(src[i]);
+    }
+
+    bool has_avx512()
+    {
+        static const bool supported = (__builtin_cpu_init(), __builtin_cpu_supports("avx512f"));
+        return supported;
+    }
+
+    bool has_f16c()
+    {
+        static const bool supported
+            = (__builtin_cpu_init(),
+               __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c"));
+        return supported;
+    }
+#endif
+
+    // rocblas_bfloat16, branch free forms of the rocblas_bfloat16 constructors which vectorize
+
+    // exponent not all ones: zero, subnormal or normal
+    inline bool bf16_finite(uint32_t u)
+    {
+        return (~u & 0x7f800000) != 0;
+    }
+
+    // Inf or NaN: keep a NaN whose payload is only in the low 16 bits a NaN
+    inline uint32_t bf16_special(uint32_t u)
+    {
+        return (u & 0xffff) ? u | 0x10000 : u;
+    }
+
+    inline uint16_t bf16_round(uint32_t u, uint32_t add)
+    {
+        return uint16_t((bf16_finite(u) ? u + add : bf16_special(u)) >> 16);
+    }
+
+    // rocblas_f8 and rocblas_bf8, decoded through a table of all 256 values
+
+    template <typename T>
+    const std::array<float, 256>& f8_decode_table()
+    {
+        static const std::array<float, 256> table = [] {
+            std::array<float, 256> t;
+            for(int i = 0; i < 256; i++)
+            {
+                T x;
+                x.data = uint8_t(i);
+                t[i]   = float(x);
+            }
+            return t;
+        }();
+        return table;
+    }
+
+    template <typename T>
+    void f8_decode(const T* src, float* dst, size_t n)
+    {
+        const float* table = f8_decode_table<T>().data();
+        convert_parallel(n, [=](size_t begin, size_t end) {
+            for(size_t i = begin; i < end; i++)
+                dst[i] = table[src[i].data];
+        });
+    }
+
+    template <typename T>
+    void f8_encode(const float* src, T* dst, size_t n, rocblas_convert_round round, uint32_t seed)
+    {
+        using mode = typename T::rocblas_hip_f8_rounding_mode;
+        if(round == rocblas_convert_round::stochastic)
+        {
+            convert_parallel(n, [=](size_t begin, size_t end) {
+                for(size_t i = begin; i < end; i++)
+                    dst[i] = T(src[i], mode::stochastic, convert_rng(seed, i));
+            });
+        }
+        else
+        {
+            convert_parallel(n, [=](size_t begin, size_t end) {
+                for(size_t i = begin; i < end; i++)
+                    dst[i] = T(src[i], mode::standard);
+            });
+        }
+    }
+}
+
+void rocblas_convert(const rocblas_half* src, float* dst, size_t n)
+{
+    convert_parallel(n, [=](size_t begin, size_t end) {
+#ifdef ROCBLAS_CONVERT_X86
+        if(has_avx512())
+            return half_to_float_avx512(src, dst, begin, end);
+        if(has_f16c())
+            return half_to_float_f16c(src, dst, begin, end);
+#endif
+        for(size_t i = begin; i < end; i++)
+            dst[i] = float(src[i]);
+    });
+}
+
+void rocblas_convert(const float* src, rocblas_half* dst, size_t n)
+{
+    convert_parallel(n, [=](size_t begin, size_t end) {
+#ifdef ROCBLAS_CONVERT_X86
+        if(has_avx512())
+            return float_to_half_avx512(src, dst, begin, end);
+        if(has_f16c())
+            return float_to_half_f16c(src, dst, begin, end);
+#endif
+        for(size_t i = begin; i < end; i++)
+            dst[i] = rocblas_half(src[i]);
+    });
+}
+
+void rocblas_convert(const rocblas_bfloat16* src, float* dst, size_t n)
+{
+    convert_parallel(n, [=](size_t begin, size_t end) {
+        for(size_t i = begin; i < end; i++)
+        {
+            uint32_t u = uint32_t(src[i].data) << 16;
+            std::memcpy(dst + i, &u, sizeof(u));
+        }
+    });
+}
+
+void rocblas_convert(const float*          src,
+                     rocblas_bfloat16*     dst,
+                     size_t                n,
+                     rocblas_convert_round round,
+                     uint32_t              seed)
+{
+    switch(round)
+    {
+    case rocblas_convert_round::near_even:
+        convert_parallel(n, [=](size_t begin, size_t end) {
+            for(size_t i = begin; i < end; i++)
+            {
+                uint32_t u  = float_bits(src[i]);
+                dst[i].data = bf16_round(u, 0x7fff + ((u >> 16) & 1));
+            }
+        });
+        break;
+    case rocblas_convert_round::near_zero:
+        convert_parallel(n, [=](size_t begin, size_t end) {
+            for(size_t i = begin; i < end; i++)
+                dst[i].data = bf16_round(float_bits(src[i]), 0x7fff);
+        });
+        break;
+    case rocblas_convert_round::truncate:
+        convert_parallel(n, [=](size_t begin, size_t end) {
+            for(size_t i = begin; i < end; i++)
+                dst[i].data = bf16_round(float_bits(src[i]), 0);
+        });
+        break;
+    case rocblas_convert_round::stochastic:
+        // a uniform 16 bit value added below the kept bits rounds up with probability equal to
+        // the discarded fraction
+        convert_parallel(n, [=](size_t begin, size_t end) {
+            for(size_t i = begin; i < end; i++)
+                dst[i].data = bf16_round(float_bits(src[i]), convert_rng(seed, i) & 0xffff);
+        });
+        break;
+    }
+}
+
+void rocblas_convert(const rocblas_f8* src, float* dst, size_t n)
+{
+    f8_decode(src, dst, n);
+}
+
+void rocblas_convert(
+    const float* src, rocblas_f8* dst, size_t n, rocblas_convert_round round, uint32_t seed)
+{
+    f8_encode(src, dst, n, round, seed);
+}
+
+void rocblas_convert(const rocblas_bf8* src, float* dst, size_t n)
+{
+    f8_decode(src, dst, n);
+}
+
+void rocblas_convert(
+    const float* src, rocblas_bf8* dst, size_t n, rocblas_convert_round round, uint32_t seed)
+{
+    f8_encode(src, dst, n, round, seed);
+}
@@ -0,0 +1,283 @@
+/* ************************************************************************
+ * Copyright (C) 2018-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell cop-
+ * ies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM-
+ * PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNE-
+ * CTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ************************************************************************ */
+
+#include "rocblas_data.hpp"
+#include "rocblas_test_cost.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <tuple>
+
+#if __has_include(<filesystem>)
+#include <filesystem>
+namespace fs = std::filesystem;
+#elif __has_include(<experimental/filesystem>)
+#include <experimental/filesystem>
+namespace fs = std::experimental::filesystem;
+#else
+#error no filesystem found
+#endif
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // Size of the header, signature and trailer which precede the records
+    constexpr size_t c_header_size = 8 + sizeof(Arguments) + 8;
+
+    // Key of the index: records with the same function, category and precision
+    using index_key = std::tuple<std::string, std::string, rocblas_datatype>;
+
+    struct test_data
+    {
+        std::string filename
+            = "(Uninitialized data. RocBLAS_TestData::set_filename needs to be called first.)";
+        std::string memory; // data read from pipes, or on platforms without mmap
+        size_t      shard_index = 0, shard_count = 1;
+        size_t      worker_index = 0, worker_count = 1;
+
+        const char* base = nullptr; // start of the data, mapped or in memory
+        size_t      size = 0;
+        bool        opened = false;
+
+        // Records of each key in the shard, in data order
+        std::map<index_key, std::vector<size_t>> index;
+        RocBLAS_TestData::selection              all;
+
+        const char* record(size_t i) const
+        {
+            return base + c_header_size + i * sizeof(Arguments);
+        }
+
+        [[noreturn]] void open_error() const
+        {
+            rocblas_cerr << "Cannot open " << filename << ": " << strerror(errno) << std::endl;
+            exit(EXIT_FAILURE);
+        }
+
+        // Maps the file read only, or reads it where mmap is not available
+        void map_file()
+        {
+#ifndef WIN32
+            int fd = ::open(filename.c_str(), O_RDONLY);
+            if(fd < 0)
+                open_error();
+
+            struct stat st;
+            if(!fstat(fd, &st) && S_ISREG(st.st_mode))
+            {
+                size = st.st_size;
+                if(size)
+                {
+                    void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                    if(map == MAP_FAILED)
+                        open_error();
+                    base = static_cast<const char*>(map);
+                }
+                close(fd);
+                return;
+            }
+            close(fd);
+#endif
+            // Pipes such as /dev/stdin, and platforms without mmap, are read into memory
+            std::ifstream ifs(filename, std::ifstream::in | std::ifstream::binary);
+            if(!ifs)
+                open_error();
+            std::ostringstream contents;
+            contents << ifs.rdbuf();
+            memory = contents.str();
+        }
+
+        void open()
+        {
+            map_file();
+            if(!base)
+            {
+                base = memory.data();
+                size = memory.size();
+            }
+
+            // Validate the data file format
+            std::istringstream header(std::string(base, std::min(size, c_header_size)));
+            Arguments::validate(header);
+
+            // Index the records of the shard, whose bounds are rounded down
+            size_t count = (size - c_header_size) / sizeof(Arguments);
+            size_t first = count * shard_index / shard_count;
+            size_t last  = count * (shard_index + 1) / shard_count;
+
+            auto all_records = std::make_shared<std::vector<size_t>>();
+            all_records->reserve(last - first);
+
+            std::vector<size_t>* group = nullptr;
+            Arguments            arg, prev;
+            for(size_t i = first; i < last; ++i)
+            {
+                memcpy(&arg, record(i), sizeof(arg));
+
+                // Consecutive records usually share their key
+                if(!group || strcmp(arg.function, prev.function)
+                   || strcmp(arg.category, prev.category) || arg.a_type != prev.a_type)
+                {
+                    group = &index[index_key{arg.function, arg.category, arg.a_type}];
+                    prev  = arg;
+                }
+                group->push_back(i);
+                all_records->push_back(i);
+            }
+
+            if(worker_count > 1)
+                select_worker(*all_records);
+
+            all    = std::move(all_records);
+            opened = true;
+        }
+
+        // Keeps the records scheduled on the worker. Each group is balanced on its own, so that
+        // the tests selected by function or category are balanced too; ties go to the workers with
+        // the least total so far, so that the small groups and the remainders are spread.
+        void select_worker(std::vector<size_t>& all_records)
+        {
+            std::vector<double> totals(worker_count), costs;
+            Arguments           arg;
+
+            all_records.clear();
+            for(auto& group : index)
+            {
+                auto& records = group.second;
+                costs.clear();
+                for(size_t i : records)
+                {
+                    memcpy(&arg, record(i), sizeof(arg));
+                    costs.push_back(rocblas_test_cost(arg));
+                }
+
+                auto   worker = rocblas_test_schedule(costs, totals);
+                size_t kept   = 0;
+                for(size_t j = 0; j < records.size(); ++j)
+                    if(worker[j] == worker_index)
+                        records[kept++] = records[j];
+                records.resize(kept);
+
+                all_records.insert(all_records.end(), records.begin(), records.end());
+            }
+
+            // Groups without records of this worker are dropped, since begin() reads their front
+            for(auto it = index.begin(); it != index.end();)
+                it = it->second.empty() ? index.erase(it) : std::next(it);
+
+            std::sort(all_records.begin(), all_records.end());
+        }
+    };
+
+    test_data& data()
+    {
+        static test_data data;
+        return data;
+    }
+
+    void set_data_source(const char* what)
+    {
+        if(data().opened)
+        {
+            rocblas_cerr << "RocBLAS_TestData::" << what << " must be called before begin()"
+                         << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+RocBLAS_TestData::iterator::iterator(bool filter(const Arguments&), selection records)
+    : filter(filter)
+    , records(std::move(records))
+{
+    skip_filter();
+}
+
+void RocBLAS_TestData::iterator::skip_filter()
+{
+    // The record is copied, since validate and the filter may update the Arguments
+    for(; !at_end(); ++pos)
+    {
+        memcpy(&arg, data().record((*records)[pos]), sizeof(arg));
+        if(arg.validate() && (!filter || filter(arg)))
+            break;
+    }
+}
+
+void RocBLAS_TestData::set_filename(std::string name, bool remove_atexit)
+{
+    set_data_source("set_filename");
+    data().filename = std::move(name);
+    if(remove_atexit)
+    {
+        auto cleanup = [] { fs::remove(data().filename.c_str()); };
+        atexit(cleanup);
+        at_quick_exit(cleanup);
+    }
+}
+
+void RocBLAS_TestData::set_shard(size_t index, size_t count)
+{
+    set_data_source("set_shard");
+    data().shard_index = index;
+    data().shard_count = count;
+}
+
+void RocBLAS_TestData::set_worker(size_t index, size_t count)
+{
+    set_data_source("set_worker");
+    data().worker_index = index;
+    data().worker_count = count;
+}
+
+RocBLAS_TestData::iterator RocBLAS_TestData::begin(bool filter(const Arguments&),
+                                                   bool function_filter(const Arguments&))
+{
+    test_data& d = data();
+    if(!d.opened)
+        d.open();
+
+    if(!function_filter)
+        return iterator(filter, d.all);
+
+    // Select the groups of records which the function filter accepts, back in data order
+    auto records = std::make_shared<std::vector<size_t>>();
+    for(const auto& group : d.index)
+    {
+        Arguments arg;
+        memcpy(&arg, d.record(group.second.front()), sizeof(arg));
+        if(function_filter(arg))
+            records->insert(records->end(), group.second.begin(), group.second.end());
+    }
+    std::sort(records->begin(), records->end());
+
+    return iterator(filter, std::move(records));
+}
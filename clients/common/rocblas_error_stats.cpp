@@ -0,0 +1,227 @@
+/* ************************************************************************
+ * Copyright (C) 2018-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell cop-
+ * ies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM-
+ * PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNE-
+ * CTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ************************************************************************/
+
+#include "rocblas_error_stats.hpp"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <sstream>
+#include <tuple>
+
+const char* const rocblas_error_stats_columns[] = {"ulp_max",
+                                                   "ulp_p50",
+                                                   "ulp_p99",
+                                                   "rel_error_p50",
+                                                   "rel_error_p99",
+                                                   "rel_error_max",
+                                                   "ulp_histogram",
+                                                   "worst_elements"};
+
+const size_t rocblas_error_stats_column_count
+    = sizeof(rocblas_error_stats_columns) / sizeof(*rocblas_error_stats_columns);
+
+namespace
+{
+    bool                g_enabled = false;
+    std::mutex          g_mutex;
+    rocblas_error_stats g_stats;
+
+    // Largest ULP distance first, then storage order
+    bool worse(const rocblas_error_stats::element& a, const rocblas_error_stats::element& b)
+    {
+        if(a.ulps != b.ulps)
+            return a.ulps > b.ulps;
+        return std::tie(a.matrix, a.col, a.row) < std::tie(b.matrix, b.col, b.row);
+    }
+
+    // Bin of a ULP distance: 0, 1, then one per power of 2
+    int ulp_bin(uint64_t ulps)
+    {
+        if(ulps == rocblas_error_stats::nan_ulps)
+            return rocblas_error_stats::ulp_nan;
+        int bin = 0;
+        for(; ulps; ulps >>= 1)
+            bin++;
+        return bin;
+    }
+
+    // Bin of a relative error: 0, then rel_sub per binade, then infinite or NaN
+    int rel_bin(double rel)
+    {
+        using S = rocblas_error_stats;
+        if(rel == 0)
+            return 0;
+        if(!(rel < std::numeric_limits<double>::infinity()))
+            return S::rel_bins - 1;
+
+        int    exp;
+        double mantissa = std::frexp(rel, &exp);
+        if(exp < S::rel_min_exp)
+            return 1;
+        if(exp > S::rel_max_exp)
+            return S::rel_bins - 2;
+        return 1 + (exp - S::rel_min_exp) * S::rel_sub + int((mantissa - 0.5) * 2 * S::rel_sub);
+    }
+
+    // First bin holding the pth fraction of the count elements of hist
+    template <size_t BINS>
+    int percentile_bin(const int64_t (&hist)[BINS], int64_t count, double p)
+    {
+        int64_t rank = std::max(int64_t(1), int64_t(std::ceil(p * count)));
+        for(size_t bin = 0; bin < BINS; bin++)
+            if((rank -= hist[bin]) <= 0)
+                return bin;
+        return BINS - 1;
+    }
+
+    std::string ulp_string(uint64_t ulps)
+    {
+        return ulps == rocblas_error_stats::nan_ulps ? "nan" : std::to_string(ulps);
+    }
+
+    // Largest ULP distance in a bin
+    std::string ulp_bin_string(int bin)
+    {
+        if(bin == rocblas_error_stats::ulp_nan)
+            return "nan";
+        return std::to_string(bin < 64 ? (uint64_t(1) << bin) - 1 : ~uint64_t(0) - 1);
+    }
+
+    // Largest relative error in a bin
+    double rel_bin_upper(int bin)
+    {
+        using S = rocblas_error_stats;
+        if(bin == 0)
+            return 0;
+        if(bin == S::rel_bins - 1)
+            return std::numeric_limits<double>::infinity();
+        int exp = S::rel_min_exp + (bin - 1) / S::rel_sub;
+        int sub = (bin - 1) % S::rel_sub;
+        return std::ldexp(0.5 + (sub + 1) / (2.0 * S::rel_sub), exp);
+    }
+}
+
+void rocblas_error_stats::add(int64_t matrix, int64_t row, int64_t col, uint64_t ulps, double rel)
+{
+    elements++;
+    ulp_hist[ulp_bin(ulps)]++;
+    rel_hist[rel_bin(rel)]++;
+    ulp_max = std::max(ulp_max, ulps);
+    if(rel_max < rel || std::isnan(rel))
+        rel_max = rel;
+
+    // Elements arrive in storage order, so a later one only replaces an earlier one if worse
+    if(ulps && (worst.size() < reported || ulps > worst.back().ulps))
+    {
+        element e{matrix, row, col, ulps};
+        worst.insert(std::upper_bound(worst.begin(), worst.end(), e, worse), e);
+        if(worst.size() > reported)
+            worst.pop_back();
+    }
+}
+
+void rocblas_error_stats::merge(const rocblas_error_stats& other)
+{
+    for(element e : other.worst)
+    {
+        e.matrix += matrices;
+        worst.push_back(e);
+    }
+    std::sort(worst.begin(), worst.end(), worse);
+    if(worst.size() > reported)
+        worst.resize(reported);
+
+    matrices += other.matrices;
+    elements += other.elements;
+    ulp_max = std::max(ulp_max, other.ulp_max);
+    if(rel_max < other.rel_max || std::isnan(other.rel_max))
+        rel_max = other.rel_max;
+    for(int bin = 0; bin < ulp_bins; bin++)
+        ulp_hist[bin] += other.ulp_hist[bin];
+    for(int bin = 0; bin < rel_bins; bin++)
+        rel_hist[bin] += other.rel_hist[bin];
+}
+
+std::vector<std::string> rocblas_error_stats::columns() const
+{
+    auto rel_string = [](double rel) {
+        std::ostringstream os;
+        os.precision(3);
+        os << rel;
+        return os.str();
+    };
+
+    std::ostringstream hist;
+    for(int bin = 0, delim = 0; bin < ulp_bins; bin++)
+    {
+        if(!ulp_hist[bin])
+            continue;
+        hist << (delim++ ? ";" : "");
+        if(bin == ulp_nan)
+            hist << "nan";
+        else if(bin < 2)
+            hist << bin;
+        else
+            hist << (uint64_t(1) << (bin - 1)) << '-' << ulp_bin_string(bin);
+        hist << ':' << ulp_hist[bin];
+    }
+
+    std::ostringstream positions;
+    for(size_t i = 0; i < worst.size(); i++)
+        positions << (i ? ";" : "") << worst[i].matrix << '/' << worst[i].row << '/'
+                  << worst[i].col << ':' << ulp_string(worst[i].ulps);
+
+    return {ulp_string(ulp_max),
+            ulp_bin_string(percentile_bin(ulp_hist, elements, 0.5)),
+            ulp_bin_string(percentile_bin(ulp_hist, elements, 0.99)),
+            rel_string(rel_bin_upper(percentile_bin(rel_hist, elements, 0.5))),
+            rel_string(rel_bin_upper(percentile_bin(rel_hist, elements, 0.99))),
+            rel_string(rel_max),
+            elements ? hist.str() : "-",
+            worst.empty() ? "-" : positions.str()};
+}
+
+void rocblas_error_stats_enable(bool enable)
+{
+    g_enabled = enable;
+}
+
+bool rocblas_error_stats_enabled()
+{
+    return g_enabled;
+}
+
+void rocblas_error_stats_record(const rocblas_error_stats& stats)
+{
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_stats.merge(stats);
+}
+
+bool rocblas_error_stats_take(rocblas_error_stats& stats)
+{
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if(!g_stats.matrices)
+        return false;
+    stats   = std::move(g_stats);
+    g_stats = {};
+    return true;
+}
@@ -0,0 +1,2022 @@
+/* ************************************************************************
+ * Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell cop-
+ * ies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM-
+ * PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNE-
+ * CTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ************************************************************************ */
+
+#include "rocblas_gentest.hpp"
+#include "rocblas_arguments.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if __has_include(<filesystem>)
+#include <filesystem>
+namespace fs = std::filesystem;
+#elif __has_include(<experimental/filesystem>)
+#include <experimental/filesystem>
+namespace fs = std::experimental::filesystem;
+#else
+#error no filesystem found
+#endif
+
+namespace
+{
+    [[noreturn]] void gentest_error(const std::string& message)
+    {
+        rocblas_cerr << message << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    /**************************************************************************
+     * YAML values, typed the way PyYAML resolves plain scalars, so that the  *
+     * expansion, the known bug matching and the conversion to Arguments      *
+     * fields follow the same rules as in rocblas_gentest.py                  *
+     **************************************************************************/
+    struct yaml_value;
+    using yaml_ptr  = std::shared_ptr<const yaml_value>;
+    using yaml_pair = std::pair<std::string, yaml_ptr>;
+
+    struct yaml_value
+    {
+        enum kind_t
+        {
+            null,
+            boolean,
+            integer,
+            real,
+            string,
+            list,
+            map
+        };
+
+        kind_t                 kind = null;
+        int64_t                i    = 0; // boolean and integer
+        double                 f    = 0;
+        std::string            s;
+        std::vector<yaml_ptr>  items; // list
+        std::vector<yaml_pair> pairs; // map, in order of first insertion
+
+        bool is_number() const
+        {
+            return kind == boolean || kind == integer || kind == real;
+        }
+
+        double as_double() const
+        {
+            return kind == real ? f : double(i);
+        }
+
+        const yaml_ptr* find(const std::string& key) const
+        {
+            for(const auto& p : pairs)
+                if(p.first == key)
+                    return &p.second;
+            return nullptr;
+        }
+
+        // Python truth value
+        explicit operator bool() const
+        {
+            switch(kind)
+            {
+            case null:
+                return false;
+            case boolean:
+            case integer:
+                return i != 0;
+            case real:
+                return f != 0;
+            case string:
+                return !s.empty();
+            case list:
+                return !items.empty();
+            case map:
+                return !pairs.empty();
+            }
+            return false;
+        }
+    };
+
+    yaml_ptr make_null()
+    {
+        static const yaml_ptr null = std::make_shared<yaml_value>();
+        return null;
+    }
+
+    yaml_ptr make_int(int64_t i)
+    {
+        auto v  = std::make_shared<yaml_value>();
+        v->kind = yaml_value::integer;
+        v->i    = i;
+        return v;
+    }
+
+    yaml_ptr make_string(std::string s)
+    {
+        auto v  = std::make_shared<yaml_value>();
+        v->kind = yaml_value::string;
+        v->s    = std::move(s);
+        return v;
+    }
+
+    // Assigns a key of a map, keeping the position of its first insertion
+    void map_set(std::vector<yaml_pair>& pairs, const std::string& key, yaml_ptr value)
+    {
+        for(auto& p : pairs)
+            if(p.first == key)
+            {
+                p.second = std::move(value);
+                return;
+            }
+        pairs.emplace_back(key, std::move(value));
+    }
+
+    // Python equality, under which 1 == 1.0 == True
+    bool py_equal(const yaml_value& a, const yaml_value& b)
+    {
+        if(a.is_number() && b.is_number())
+            return a.kind == yaml_value::real || b.kind == yaml_value::real
+                       ? a.as_double() == b.as_double()
+                       : a.i == b.i;
+        if(a.kind != b.kind)
+            return false;
+        switch(a.kind)
+        {
+        case yaml_value::string:
+            return a.s == b.s;
+        case yaml_value::list:
+            if(a.items.size() != b.items.size())
+                return false;
+            for(size_t i = 0; i < a.items.size(); ++i)
+                if(!py_equal(*a.items[i], *b.items[i]))
+                    return false;
+            return true;
+        case yaml_value::map:
+            if(a.pairs.size() != b.pairs.size())
+                return false;
+            for(const auto& p : a.pairs)
+            {
+                const yaml_ptr* q = b.find(p.first);
+                if(!q || !py_equal(*p.second, **q))
+                    return false;
+            }
+            return true;
+        default:
+            return true;
+        }
+    }
+
+    std::ostream& operator<<(std::ostream& os, const yaml_value& v)
+    {
+        switch(v.kind)
+        {
+        case yaml_value::null:
+            return os << "null";
+        case yaml_value::boolean:
+            return os << (v.i ? "true" : "false");
+        case yaml_value::integer:
+            return os << v.i;
+        case yaml_value::real:
+            return os << v.f;
+        case yaml_value::string:
+            return os << '\'' << v.s << '\'';
+        case yaml_value::list:
+        {
+            const char* delim = "[";
+            for(const auto& item : v.items)
+            {
+                os << delim << *item;
+                delim = ", ";
+            }
+            return os << (v.items.empty() ? "[]" : "]");
+        }
+        case yaml_value::map:
+        {
+            const char* delim = "{ ";
+            for(const auto& p : v.pairs)
+            {
+                os << delim << p.first << ": " << *p.second;
+                delim = ", ";
+            }
+            return os << (v.pairs.empty() ? "{}" : " }");
+        }
+        }
+        return os;
+    }
+
+    /**************************************************************************
+     * YAML source text, with include: lines replaced by the included files   *
+     * and the file and line number of each line kept for error messages      *
+     **************************************************************************/
+    struct yaml_source
+    {
+        std::string                              text;
+        std::vector<size_t>                      line_start;
+        std::vector<std::pair<std::string, int>> line_origin;
+        std::vector<std::string>                 include_dirs;
+
+        // include\s*:\s*([-.\w/]+) at the start of the line
+        static bool include_line(const std::string& line, size_t& begin, size_t& end)
+        {
+            if(line.compare(0, 7, "include"))
+                return false;
+            size_t i = 7;
+            while(i < line.size() && isspace((unsigned char)line[i]))
+                ++i;
+            if(i == line.size() || line[i++] != ':')
+                return false;
+            while(i < line.size() && isspace((unsigned char)line[i]))
+                ++i;
+            for(begin = end = i; end < line.size(); ++end)
+            {
+                unsigned char c = line[end];
+                if(!isalnum(c) && !strchr("-._/", c))
+                    break;
+            }
+            return end > begin;
+        }
+
+        void read(const std::string& path)
+        {
+            std::ifstream file(path);
+            if(!file)
+                gentest_error("Cannot open " + path + ": " + strerror(errno));
+
+            fs::path dir = fs::path(path).parent_path();
+            if(dir.empty() || path == "/dev/stdin")
+                dir = fs::current_path();
+
+            std::string line;
+            for(int line_no = 1; std::getline(file, line); ++line_no)
+            {
+                if(!line.empty() && line.back() == '\r')
+                    line.pop_back();
+
+                size_t begin, end;
+                if(include_line(line, begin, end))
+                {
+                    // The directory of the file is searched first, then the include paths
+                    std::string name  = line.substr(begin, end - begin);
+                    std::string paths = dir.string();
+                    fs::path    include = dir / name;
+                    for(size_t i = 0; !fs::exists(include) && i < include_dirs.size(); ++i)
+                    {
+                        paths += "\n" + include_dirs[i];
+                        include = fs::path(include_dirs[i]) / name;
+                    }
+                    if(!fs::exists(include))
+                        gentest_error("In file " + path + ", line " + std::to_string(line_no)
+                                      + ", column " + std::to_string(begin + 1) + ":\n" + line
+                                      + "\n" + std::string(begin, ' ') + "^\nCannot open " + name
+                                      + "\n\nInclude paths:\n" + paths);
+                    read(include.string());
+                    continue;
+                }
+
+                line_start.push_back(text.size());
+                line_origin.emplace_back(path, line_no);
+                text += line;
+                text += '\n';
+            }
+        }
+    };
+
+    /**************************************************************************
+     * YAML parser for the block and flow styles, anchors, aliases and merge  *
+     * keys, producing the same values as PyYAML for the rocBLAS test data    *
+     **************************************************************************/
+    class yaml_parser
+    {
+        const yaml_source&              src;
+        size_t                          pos  = 0;
+        size_t                          line = 0;
+        std::map<std::string, yaml_ptr> anchors;
+
+        static bool is_blank(char c)
+        {
+            return c == ' ' || c == '\t';
+        }
+
+        static bool is_blankz(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\n' || c == 0;
+        }
+
+        static bool is_flow_indicator(char c)
+        {
+            return c && strchr(",[]{}", c);
+        }
+
+        char peek(size_t k = 0) const
+        {
+            return pos + k < src.text.size() ? src.text[pos + k] : 0;
+        }
+
+        bool at_end() const
+        {
+            return pos >= src.text.size();
+        }
+
+        int column() const
+        {
+            return int(pos - src.line_start[line]);
+        }
+
+        void advance(size_t n = 1)
+        {
+            for(; n && pos < src.text.size(); --n)
+                if(src.text[pos++] == '\n' && line + 1 < src.line_start.size())
+                    ++line;
+        }
+
+        [[noreturn]] void error(const std::string& problem) const
+        {
+            size_t      end = src.text.find('\n', src.line_start[line]);
+            std::string text(src.text, src.line_start[line], end - src.line_start[line]);
+            gentest_error("In file " + src.line_origin[line].first + ", line "
+                          + std::to_string(src.line_origin[line].second) + ", column "
+                          + std::to_string(column() + 1) + ":\n" + text + "\n"
+                          + std::string(column(), ' ') + "^\n" + problem);
+        }
+
+        // Skips blanks and a comment, up to the end of the line
+        void skip_line_space()
+        {
+            while(is_blank(peek()))
+                advance();
+            if(peek() == '#')
+                while(peek() != '\n' && !at_end())
+                    advance();
+        }
+
+        // Skips blank lines and comments up to the next token. Returns whether a line was ended.
+        bool skip_to_token()
+        {
+            bool crossed = false;
+            for(skip_line_space(); peek() == '\n'; skip_line_space())
+            {
+                advance();
+                crossed = true;
+            }
+            return crossed;
+        }
+
+        bool at_marker(const char* marker) const
+        {
+            return column() == 0 && !src.text.compare(pos, 3, marker) && is_blankz(peek(3));
+        }
+
+        // Document start or end marker
+        bool at_marker() const
+        {
+            return at_marker("---") || at_marker("...");
+        }
+
+        // Block sequence entry indicator
+        bool at_entry() const
+        {
+            return peek() == '-' && is_blankz(peek(1));
+        }
+
+        std::string read_name()
+        {
+            advance();
+            size_t start = pos;
+            while(!is_blankz(peek()) && !is_flow_indicator(peek()))
+                advance();
+            if(pos == start)
+                error("expected an anchor or alias name");
+            return src.text.substr(start, pos - start);
+        }
+
+        yaml_ptr read_alias()
+        {
+            size_t      start = pos;
+            std::string name  = read_name();
+            auto        it    = anchors.find(name);
+            if(it == anchors.end())
+            {
+                pos = start;
+                error("found undefined alias " + name);
+            }
+            return it->second;
+        }
+
+        // Reads a quoted or plain scalar, folding the line breaks of quoted scalars
+        std::string read_scalar(bool flow, bool& quoted)
+        {
+            std::string s;
+            char        quote = peek();
+            quoted            = quote == '\'' || quote == '"';
+            if(quoted)
+            {
+                for(advance(); peek() != quote || (quote == '\'' && peek(1) == '\'');)
+                {
+                    char c = peek();
+                    if(at_end())
+                        error("found unexpected end of stream in a quoted scalar");
+                    advance();
+                    if(c == '\'' && quote == '\'')
+                    {
+                        advance();
+                        s += '\'';
+                    }
+                    else if(c == '\n')
+                    {
+                        // A line break folds into a space, or is kept for each empty line
+                        while(!s.empty() && is_blank(s.back()))
+                            s.pop_back();
+                        size_t breaks = 0;
+                        for(;; advance())
+                        {
+                            while(is_blank(peek()))
+                                advance();
+                            if(peek() != '\n')
+                                break;
+                            ++breaks;
+                        }
+                        s.append(breaks ? breaks : 1, breaks ? '\n' : ' ');
+                    }
+                    else if(c == '\\' && quote == '"')
+                    {
+                        static const char escapes[] = "n\nt\tr\r0\0\\\\\"\"//  ";
+                        const char*       e         = nullptr;
+                        for(size_t i = 0; i + 1 < sizeof(escapes) && !e; i += 2)
+                            if(escapes[i] == peek())
+                                e = &escapes[i + 1];
+                        if(!e)
+                            error("unsupported escape sequence in a double-quoted scalar");
+                        advance();
+                        s += *e;
+                    }
+                    else
+                        s += c;
+                }
+                advance();
+                return s;
+            }
+
+            size_t start = pos;
+            for(;; advance())
+            {
+                char c = peek();
+                if(c == '\n' || at_end() || (flow && is_flow_indicator(c)))
+                    break;
+                if(c == ':' && (is_blankz(peek(1)) || (flow && is_flow_indicator(peek(1)))))
+                    break;
+                if(c == '#' && pos > start && is_blank(src.text[pos - 1]))
+                    break;
+            }
+            s = src.text.substr(start, pos - start);
+            while(!s.empty() && is_blank(s.back()))
+                s.pop_back();
+            return s;
+        }
+
+        // Integer forms of the YAML 1.1 resolver used by PyYAML
+        static bool resolve_int(const std::string& text, int64_t& value)
+        {
+            size_t i    = text.size() && (text[0] == '-' || text[0] == '+');
+            bool   neg  = i && text[0] == '-';
+            int    base = 10;
+            auto   all  = [&](size_t from, const char* chars) {
+                return from < text.size()
+                       && text.find_first_not_of(chars, from) == std::string::npos;
+            };
+
+            if(text.compare(i, std::string::npos, "0") == 0)
+                base = 10;
+            else if(!text.compare(i, 2, "0b") && all(i + 2, "01_"))
+                base = 2, i += 2;
+            else if(!text.compare(i, 2, "0x") && all(i + 2, "0123456789abcdefABCDEF_"))
+                base = 16, i += 2;
+            else if(i < text.size() && text[i] == '0' && all(i + 1, "01234567_"))
+                base = 8, i += 1;
+            else if(i < text.size() && text[i] >= '1' && text[i] <= '9' && all(i, "0123456789_"))
+                base = 10;
+            else if(i < text.size() && text[i] >= '1' && text[i] <= '9'
+                    && all(i, "0123456789_:"))
+            {
+                // Sexagesimal, as in 1:30
+                uint64_t total = 0, part = 0;
+                for(size_t j = i; j <= text.size(); ++j)
+                {
+                    if(j == text.size() || text[j] == ':')
+                    {
+                        total = total * 60 + part;
+                        part  = 0;
+                    }
+                    else if(text[j] != '_')
+                        part = part * 10 + (text[j] - '0');
+                }
+                value = neg ? -int64_t(total) : int64_t(total);
+                return true;
+            }
+            else
+                return false;
+
+            uint64_t v = 0;
+            for(; i < text.size(); ++i)
+                if(text[i] != '_')
+                    v = v * base + (isdigit((unsigned char)text[i]) ? text[i] - '0'
+                                                                    : tolower(text[i]) - 'a' + 10);
+            value = neg ? -int64_t(v) : int64_t(v);
+            return true;
+        }
+
+        // Floating-point forms of the YAML 1.1 resolver used by PyYAML, which require a '.'
+        static bool resolve_float(const std::string& text, double& value)
+        {
+            size_t n    = text.size();
+            bool   sign = n && (text[0] == '-' || text[0] == '+');
+            size_t j    = sign;
+            auto   rest = text.substr(j);
+
+            if(rest == ".inf" || rest == ".Inf" || rest == ".INF")
+            {
+                value = text[0] == '-' ? -std::numeric_limits<double>::infinity()
+                                       : std::numeric_limits<double>::infinity();
+                return true;
+            }
+            if(!sign && (rest == ".nan" || rest == ".NaN" || rest == ".NAN"))
+            {
+                // PyYAML computes NaN as -inf / inf, which is negative on x86
+                value = std::copysign(std::numeric_limits<double>::quiet_NaN(), -1.0);
+                return true;
+            }
+
+            auto digits = [&] {
+                size_t k = j;
+                while(j < n && (isdigit((unsigned char)text[j]) || text[j] == '_'))
+                    ++j;
+                return j > k;
+            };
+
+            if(j < n && isdigit((unsigned char)text[j]))
+            {
+                digits();
+                if(j == n || text[j++] != '.')
+                    return false;
+                digits();
+            }
+            else if(!sign && j < n && text[j] == '.')
+            {
+                ++j;
+                if(!digits())
+                    return false;
+            }
+            else
+                return false;
+
+            if(j < n && (text[j] == 'e' || text[j] == 'E'))
+            {
+                if(++j == n || (text[j] != '-' && text[j] != '+'))
+                    return false;
+                size_t k = ++j;
+                while(j < n && isdigit((unsigned char)text[j]))
+                    ++j;
+                if(j == k)
+                    return false;
+            }
+            if(j != n)
+                return false;
+
+            std::string clean;
+            for(char c : text)
+                if(c != '_')
+                    clean += c;
+            value = strtod(clean.c_str(), nullptr);
+            return true;
+        }
+
+        static yaml_ptr resolve(std::string text, bool quoted)
+        {
+            auto v = std::make_shared<yaml_value>();
+            if(quoted)
+            {
+                v->kind = yaml_value::string;
+                v->s    = std::move(text);
+                return v;
+            }
+
+            static const char* const nulls[]  = {"", "~", "null", "Null", "NULL"};
+            static const char* const trues[]
+                = {"yes", "Yes", "YES", "true", "True", "TRUE", "on", "On", "ON"};
+            static const char* const falses[]
+                = {"no", "No", "NO", "false", "False", "FALSE", "off", "Off", "OFF"};
+            auto any = [&](const auto& words) {
+                return std::any_of(std::begin(words), std::end(words), [&](const char* w) {
+                    return text == w;
+                });
+            };
+
+            if(any(nulls))
+                return make_null();
+            if(any(trues) || any(falses))
+            {
+                v->kind = yaml_value::boolean;
+                v->i    = any(trues);
+            }
+            else if(resolve_int(text, v->i))
+                v->kind = yaml_value::integer;
+            else if(resolve_float(text, v->f))
+                v->kind = yaml_value::real;
+            else
+            {
+                v->kind = yaml_value::string;
+                v->s    = std::move(text);
+            }
+            return v;
+        }
+
+        // Adds a pair to a map being parsed; the values of << merge keys are kept aside
+        void add_pair(yaml_value&            node,
+                      std::vector<yaml_ptr>& merges,
+                      std::string            key,
+                      bool                   quoted,
+                      yaml_ptr               value)
+        {
+            if(key == "<<" && !quoted)
+            {
+                bool ok = value->kind == yaml_value::map;
+                if(value->kind == yaml_value::list)
+                {
+                    ok = true;
+                    for(const auto& item : value->items)
+                        ok = ok && item->kind == yaml_value::map;
+                }
+                if(!ok)
+                    error("expected a mapping or list of mappings for merging");
+                merges.push_back(std::move(value));
+            }
+            else
+                map_set(node.pairs, key, std::move(value));
+        }
+
+        // Merged pairs come first and are overridden by the pairs of the map itself; in a list of
+        // merged maps, the earlier maps take precedence, as in PyYAML
+        static yaml_ptr finish_map(std::shared_ptr<yaml_value> node,
+                                   const std::vector<yaml_ptr>& merges)
+        {
+            if(merges.empty())
+                return node;
+
+            std::vector<yaml_pair> pairs;
+            for(const auto& merge : merges)
+                if(merge->kind == yaml_value::map)
+                    for(const auto& p : merge->pairs)
+                        map_set(pairs, p.first, p.second);
+                else
+                    for(auto it = merge->items.rbegin(); it != merge->items.rend(); ++it)
+                        for(const auto& p : (*it)->pairs)
+                            map_set(pairs, p.first, p.second);
+            for(auto& p : node->pairs)
+                map_set(pairs, p.first, std::move(p.second));
+            node->pairs = std::move(pairs);
+            return node;
+        }
+
+        static std::shared_ptr<yaml_value> new_collection(yaml_value::kind_t kind)
+        {
+            auto node  = std::make_shared<yaml_value>();
+            node->kind = kind;
+            return node;
+        }
+
+        void skip_flow_space()
+        {
+            skip_to_token();
+            if(at_end())
+                error("found unexpected end of stream in a flow collection");
+        }
+
+        yaml_ptr parse_flow_node()
+        {
+            switch(peek())
+            {
+            case '&':
+            {
+                std::string name = read_name();
+                skip_flow_space();
+                return anchors[name] = parse_flow_node();
+            }
+            case '*':
+                return read_alias();
+            case '[':
+            case '{':
+                return parse_flow();
+            }
+            bool        quoted;
+            std::string text = read_scalar(true, quoted);
+            return resolve(std::move(text), quoted);
+        }
+
+        yaml_ptr parse_flow()
+        {
+            bool                  is_map = peek() == '{';
+            char                  close  = is_map ? '}' : ']';
+            auto node = new_collection(is_map ? yaml_value::map : yaml_value::list);
+            std::vector<yaml_ptr> merges;
+
+            for(advance();;)
+            {
+                skip_flow_space();
+                if(peek() == close)
+                    break;
+
+                if(is_map)
+                {
+                    if(strchr("[{&*", peek()))
+                        error("only scalar keys are supported");
+                    bool        quoted;
+                    std::string key   = read_scalar(true, quoted);
+                    yaml_ptr    value = make_null();
+                    skip_flow_space();
+                    if(peek() == ':')
+                    {
+                        advance();
+                        skip_flow_space();
+                        if(peek() != ',' && peek() != close)
+                            value = parse_flow_node();
+                    }
+                    add_pair(*node, merges, std::move(key), quoted, std::move(value));
+                }
+                else
+                    node->items.push_back(parse_flow_node());
+
+                skip_flow_space();
+                if(peek() == ',')
+                    advance();
+                else if(peek() != close)
+                    error(std::string("expected ',' or '") + close + "'");
+            }
+            advance();
+            return finish_map(std::move(node), merges);
+        }
+
+        // Reads the end of the line after a node of a block collection, unless a nested
+        // collection has already read it
+        void end_line()
+        {
+            skip_to_token();
+            for(size_t i = src.line_start[line]; i < pos && !at_end(); ++i)
+                if(!is_blank(src.text[i]))
+                    error("expected the end of the line");
+        }
+
+        yaml_ptr parse_block_sequence(int indent)
+        {
+            auto node = new_collection(yaml_value::list);
+            for(;;)
+            {
+                advance();
+                node->items.push_back(parse_node(indent, false, true));
+                end_line();
+                if(at_end() || at_marker() || column() < indent)
+                    break;
+                if(!at_entry())
+                {
+                    if(column() == indent)
+                        break;
+                    error("expected a sequence entry");
+                }
+                if(column() > indent)
+                    error("bad indentation of a sequence entry");
+            }
+            return node;
+        }
+
+        yaml_ptr parse_block_mapping(int indent, std::string key, bool quoted)
+        {
+            auto                  node = new_collection(yaml_value::map);
+            std::vector<yaml_ptr> merges;
+            for(;;)
+            {
+                advance();
+                add_pair(*node, merges, std::move(key), quoted, parse_node(indent, true, false));
+                end_line();
+                if(at_end() || at_marker() || column() < indent)
+                    break;
+                if(column() > indent)
+                    error("bad indentation of a mapping entry");
+                if(at_entry() || strchr("[{&*|>!?", peek()))
+                    error("expected a simple key");
+
+                key = read_scalar(false, quoted);
+                skip_line_space();
+                if(peek() != ':' || !is_blankz(peek(1)))
+                    error("could not find expected ':'");
+            }
+            return finish_map(std::move(node), merges);
+        }
+
+        // Parses the node following a document start, a sequence entry indicator or a mapping
+        // key. Content on later lines belongs to the node if it is indented past the enclosing
+        // collection, or for the value of a key, if it is a sequence at the indentation of the
+        // key. Block collections may only start on the line of the indicator after a '-'.
+        yaml_ptr parse_node(int parent, bool indentless, bool block_inline)
+        {
+            if(skip_to_token())
+            {
+                if(at_end() || at_marker()
+                   || !(column() > parent || (indentless && column() == parent && at_entry())))
+                    return make_null();
+                block_inline = true;
+            }
+            else if(at_end())
+                return make_null();
+
+            switch(peek())
+            {
+            case '&':
+            {
+                std::string name = read_name();
+                return anchors[name] = parse_node(parent, indentless, block_inline);
+            }
+            case '*':
+                return read_alias();
+            case '[':
+            case '{':
+                return parse_flow();
+            case '|':
+            case '>':
+                error("block scalars are not supported");
+            case '!':
+                error("tags are not supported");
+            case '?':
+                if(is_blankz(peek(1)))
+                    error("complex keys are not supported");
+            }
+
+            int indent = column();
+            if(at_entry())
+            {
+                if(!block_inline)
+                    error("block sequence entries are not allowed here");
+                return parse_block_sequence(indent);
+            }
+
+            bool        quoted;
+            std::string text = read_scalar(false, quoted);
+            skip_line_space();
+            if(peek() == ':' && is_blankz(peek(1)))
+            {
+                if(!block_inline)
+                    error("mapping values are not allowed here");
+                return parse_block_mapping(indent, std::move(text), quoted);
+            }
+            return resolve(std::move(text), quoted);
+        }
+
+    public:
+        explicit yaml_parser(const yaml_source& src)
+            : src(src)
+        {
+        }
+
+        // Parses the next document of the stream. Returns false at the end of the stream.
+        bool next_document(yaml_ptr& doc)
+        {
+            anchors.clear();
+            for(skip_to_token(); at_marker("..."); skip_to_token())
+                advance(3);
+            if(at_end())
+                return false;
+            if(at_marker("---"))
+                advance(3);
+
+            doc = parse_node(-1, false, true);
+
+            skip_to_token();
+            if(!at_end() && !at_marker())
+                error("expected the end of the document");
+            return true;
+        }
+    };
+
+    /**************************************************************************
+     * Test case being expanded: its arguments sorted by name, the order in   *
+     * which rocblas_gentest.py visits them                                   *
+     **************************************************************************/
+    class test_case
+    {
+        std::vector<yaml_pair> args;
+
+        auto lower_bound(const std::string& key) const
+        {
+            return std::lower_bound(
+                args.begin(), args.end(), key, [](const auto& p, const auto& k) {
+                    return p.first < k;
+                });
+        }
+
+    public:
+        size_t size() const
+        {
+            return args.size();
+        }
+
+        const yaml_pair& operator[](size_t i) const
+        {
+            return args[i];
+        }
+
+        yaml_ptr& value(size_t i)
+        {
+            return args[i].second;
+        }
+
+        const yaml_ptr* find(const std::string& key) const
+        {
+            auto it = lower_bound(key);
+            return it != args.end() && it->first == key ? &it->second : nullptr;
+        }
+
+        bool has(const std::string& key) const
+        {
+            return find(key) != nullptr;
+        }
+
+        const yaml_ptr& ptr(const std::string& key) const
+        {
+            const yaml_ptr* v = find(key);
+            if(!v)
+            {
+                std::ostringstream msg;
+                msg << "Undefined value '" << key << "'\n" << *this;
+                gentest_error(msg.str());
+            }
+            return *v;
+        }
+
+        const yaml_value& at(const std::string& key) const
+        {
+            return *ptr(key);
+        }
+
+        const std::string& str(const std::string& key) const
+        {
+            const yaml_value& v = at(key);
+            if(v.kind != yaml_value::string)
+            {
+                std::ostringstream msg;
+                msg << "Expected a string for " << key << ", found " << v << "\n" << *this;
+                gentest_error(msg.str());
+            }
+            return v.s;
+        }
+
+        void set(const std::string& key, yaml_ptr value)
+        {
+            auto it = args.begin() + (lower_bound(key) - args.cbegin());
+            if(it != args.end() && it->first == key)
+                it->second = std::move(value);
+            else
+                args.emplace(it, key, std::move(value));
+        }
+
+        void setdefault(const std::string& key, yaml_ptr value)
+        {
+            if(!has(key))
+                set(key, std::move(value));
+        }
+
+        void erase(const std::string& key)
+        {
+            auto it = lower_bound(key);
+            if(it != args.end() && it->first == key)
+                args.erase(it);
+        }
+
+        void update(const yaml_value& map)
+        {
+            for(const auto& p : map.pairs)
+                set(p.first, p.second);
+        }
+
+        friend std::ostream& operator<<(std::ostream& os, const test_case& test)
+        {
+            yaml_value v;
+            v.kind  = yaml_value::map;
+            v.pairs = test.args;
+            return os << v;
+        }
+    };
+
+    // Python arithmetic on the int and float values in setdefaults
+    struct py_number
+    {
+        bool    real;
+        int64_t i;
+        double  f;
+
+        py_number(const yaml_value& v)
+            : real(v.kind == yaml_value::real)
+            , i(v.i)
+            , f(v.f)
+        {
+            if(!v.is_number())
+            {
+                std::ostringstream msg;
+                msg << "Expected a number, found " << v;
+                gentest_error(msg.str());
+            }
+        }
+
+        py_number(int64_t i)
+            : real(false)
+            , i(i)
+            , f(0)
+        {
+        }
+
+        double value() const
+        {
+            return real ? f : double(i);
+        }
+
+        py_number operator*(const py_number& b) const
+        {
+            py_number r(int64_t(0));
+            r.real = real || b.real;
+            if(r.real)
+                r.f = value() * b.value();
+            else
+                r.i = int64_t(uint64_t(i) * uint64_t(b.i));
+            return r;
+        }
+
+        py_number abs() const
+        {
+            py_number r = *this;
+            r.i         = i < 0 ? -i : i;
+            r.f         = std::abs(f);
+            return r;
+        }
+
+        // Python int()
+        yaml_ptr to_int() const
+        {
+            return make_int(real ? int64_t(f) : i);
+        }
+
+        yaml_ptr to_value() const
+        {
+            if(!real)
+                return make_int(i);
+            auto v  = std::make_shared<yaml_value>();
+            v->kind = yaml_value::real;
+            v->f    = f;
+            return v;
+        }
+    };
+
+    // Shell-style wildcards of fnmatch.fnmatchcase: *, ?, [seq] and [!seq]
+    bool wildcard_match(const char* s, const char* p)
+    {
+        for(;; ++s, ++p)
+        {
+            if(*p == '*')
+            {
+                while(p[1] == '*')
+                    ++p;
+                for(;; ++s)
+                {
+                    if(wildcard_match(s, p + 1))
+                        return true;
+                    if(!*s)
+                        return false;
+                }
+            }
+            if(!*p)
+                return !*s;
+            if(!*s)
+                return false;
+            if(*p == '[')
+            {
+                const char* q      = p + 1;
+                bool        negate = *q == '!';
+                q += negate;
+                const char* set = q;
+                if(*q == ']')
+                    ++q;
+                while(*q && *q != ']')
+                    ++q;
+                if(*q)
+                {
+                    bool found = false;
+                    for(const char* r = set; r < q; ++r)
+                        if(r + 2 < q && r[1] == '-')
+                        {
+                            found = found || (r[0] <= *s && *s <= r[2]);
+                            r += 2;
+                        }
+                        else
+                            found = found || *r == *s;
+                    if(found == negate)
+                        return false;
+                    p = q;
+                    continue;
+                }
+            }
+            if(*p != '?' && *p != *s)
+                return false;
+        }
+    }
+
+    // A..B[..C] integer range, with optional whitespace around the numbers
+    bool int_range(const std::string& s, int64_t& first, int64_t& last, int64_t& step)
+    {
+        size_t i     = 0;
+        auto   space = [&] {
+            while(i < s.size() && isspace((unsigned char)s[i]))
+                ++i;
+        };
+        auto number = [&](int64_t& x) {
+            size_t begin = i;
+            i += i < s.size() && s[i] == '-';
+            size_t digits = i;
+            while(i < s.size() && isdigit((unsigned char)s[i]))
+                ++i;
+            x = strtoll(s.c_str() + begin, nullptr, 10);
+            return i > digits;
+        };
+        auto dots = [&] {
+            if(s.compare(i, 2, ".."))
+                return false;
+            i += 2;
+            return true;
+        };
+
+        space();
+        if(!number(first) || (space(), !dots()) || (space(), !number(last)))
+            return false;
+        space();
+        step = 1;
+        if(dots() && (space(), !number(step)))
+            return false;
+        space();
+        return i == s.size();
+    }
+
+    // Type name, or type*count for an array, as rocblas_gentest.py TYPE_RE accepts
+    bool type_decl(const std::string& decl, std::string& name, size_t& count)
+    {
+        size_t i = 0;
+        if(decl.empty() || !(isalpha((unsigned char)decl[0]) || decl[0] == '_'))
+            return false;
+        while(i < decl.size() && (isalnum((unsigned char)decl[i]) || decl[i] == '_'))
+            ++i;
+        name  = decl.substr(0, i);
+        count = 0;
+        if(i == decl.size())
+            return true;
+
+        i += decl[i] == ':';
+        while(i < decl.size() && isspace((unsigned char)decl[i]))
+            ++i;
+        if(i == decl.size() || decl[i++] != '*')
+            return false;
+        while(i < decl.size() && isspace((unsigned char)decl[i]))
+            ++i;
+        size_t digits = i;
+        while(i < decl.size() && isdigit((unsigned char)decl[i]))
+            ++i;
+        count = strtoull(decl.c_str() + digits, nullptr, 10);
+        return i > digits && i == decl.size();
+    }
+
+    /**************************************************************************
+     * Conversion of the values of a test case to the fields of Arguments, as *
+     * ctypes converts them in rocblas_gentest.py                             *
+     **************************************************************************/
+    template <size_t N>
+    bool convert_field(char (&field)[N], const yaml_value& v)
+    {
+        if(v.kind != yaml_value::string || v.s.size() > N)
+            return false;
+        memcpy(field, v.s.data(), v.s.size());
+        return true;
+    }
+
+    bool convert_field(char& field, const yaml_value& v)
+    {
+        if(v.kind != yaml_value::string || v.s.size() != 1)
+            return false;
+        field = v.s[0];
+        return true;
+    }
+
+    bool convert_field(bool& field, const yaml_value& v)
+    {
+        field = bool(v);
+        return true;
+    }
+
+    template <typename T>
+    bool convert_field(T& field, const yaml_value& v)
+    {
+        if constexpr(std::is_floating_point<T>{})
+        {
+            if(!v.is_number())
+                return false;
+            field = T(v.as_double());
+        }
+        else
+        {
+            if(v.kind != yaml_value::integer && v.kind != yaml_value::boolean)
+                return false;
+            field = T(v.i);
+        }
+        return true;
+    }
+
+    /**************************************************************************
+     * Expansion of the test documents, following rocblas_gentest.py          *
+     **************************************************************************/
+    class gentest
+    {
+        // Type or constant of the Datatypes of a document
+        struct datatype
+        {
+            bool    is_type;
+            bool    is_enum; // a type derived in Datatypes
+            size_t  size;
+            int64_t value;
+        };
+
+        std::map<std::string, datatype>                       datatypes;
+        std::vector<std::string>                              arg_names;
+        std::set<std::string>                                 enum_args;
+        std::vector<yaml_ptr>                                 dict_lists_to_expand;
+        std::vector<yaml_ptr>                                 lists_to_not_expand;
+        std::vector<yaml_ptr>                                 known_bugs;
+        std::unordered_map<std::string, const yaml_value*>    functions;
+        std::fstream                                          out;
+        std::string                                           out_name;
+        uint64_t                                              out_size = 0;
+        std::unordered_multimap<size_t, uint64_t>             records;
+
+        static std::vector<yaml_ptr> list_of(const yaml_ptr* v, const char* name)
+        {
+            if(!v || !**v)
+                return {};
+            if((*v)->kind != yaml_value::list)
+                gentest_error(std::string(name) + " must be a list");
+            return (*v)->items;
+        }
+
+        // Sizes of the fields of Arguments, in declaration order
+        static std::vector<std::pair<const char*, size_t>> argument_fields()
+        {
+            std::vector<std::pair<const char*, size_t>> fields;
+            Arguments                                   arg;
+#define FIELD_SIZE(NAME) fields.emplace_back(#NAME, sizeof(arg.NAME))
+            FOR_EACH_ARGUMENT(FIELD_SIZE, ;);
+#undef FIELD_SIZE
+            return fields;
+        }
+
+        void get_datatypes(const yaml_value& doc)
+        {
+            static const std::pair<const char*, size_t> ctypes[]
+                = {{"c_bool", 1},
+                   {"c_char", 1},
+                   {"c_byte", 1},
+                   {"c_ubyte", 1},
+                   {"c_int8", 1},
+                   {"c_uint8", 1},
+                   {"c_short", 2},
+                   {"c_ushort", 2},
+                   {"c_int16", 2},
+                   {"c_uint16", 2},
+                   {"c_int", 4},
+                   {"c_uint", 4},
+                   {"c_int32", 4},
+                   {"c_uint32", 4},
+                   {"c_float", 4},
+                   {"c_int64", 8},
+                   {"c_uint64", 8},
+                   {"c_longlong", 8},
+                   {"c_ulonglong", 8},
+                   {"c_double", 8},
+                   {"c_long", sizeof(long)},
+                   {"c_ulong", sizeof(long)},
+                   {"c_size_t", sizeof(size_t)},
+                   {"c_ssize_t", sizeof(size_t)},
+                   {"c_longdouble", sizeof(long double)},
+                   {"c_wchar", sizeof(wchar_t)}};
+
+            datatypes.clear();
+            for(const auto& t : ctypes)
+                datatypes[t.first] = {true, false, t.second, 0};
+
+            for(const yaml_ptr& declaration : list_of(doc.find("Datatypes"), "Datatypes"))
+                for(const auto& [name, decl] : declaration->pairs)
+                {
+                    std::string base;
+                    size_t      count;
+                    if(decl->kind == yaml_value::map)
+                    {
+                        datatype type{true, true, 0, 0};
+                        if(const yaml_ptr* bases = decl->find("bases"))
+                            for(const yaml_ptr& b : list_of(bases, "bases"))
+                                if(b->kind == yaml_value::string && type_decl(b->s, base, count)
+                                   && datatypes.count(base) && !type.size)
+                                    type.size = datatypes[base].size * (count ? count : 1);
+                        datatypes[name] = type;
+
+                        if(const yaml_ptr* attr = decl->find("attr"))
+                            for(const auto& [sub, value] : (*attr)->pairs)
+                                if(type_decl(sub, base, count) && !count)
+                                {
+                                    if(value->kind != yaml_value::integer)
+                                        gentest_error("Unrecognized value of " + name + "." + sub);
+                                    datatypes[sub] = {false, false, 0, value->i};
+                                }
+                    }
+                    else if(decl->kind == yaml_value::string && type_decl(decl->s, base, count)
+                            && datatypes.count(base))
+                    {
+                        datatype type = datatypes[base];
+                        if(count)
+                            type.size *= count, type.is_enum = false;
+                        datatypes[name] = type;
+                    }
+                    else
+                    {
+                        std::ostringstream msg;
+                        msg << "Unrecognized data type " << name << ": " << *decl;
+                        gentest_error(msg.str());
+                    }
+                }
+        }
+
+        // The YAML Arguments declarations, which must match the fields of Arguments
+        void get_arguments(const yaml_value& doc)
+        {
+            auto fields = argument_fields();
+            arg_names.clear();
+            enum_args.clear();
+
+            for(const yaml_ptr& decl : list_of(doc.find("Arguments"), "Arguments"))
+            {
+                std::string base;
+                size_t      count;
+                if(decl->pairs.size() != 1 || decl->pairs[0].second->kind != yaml_value::string
+                   || !type_decl(decl->pairs[0].second->s, base, count))
+                    continue;
+
+                const std::string& name = decl->pairs[0].first;
+                auto               it   = datatypes.find(base);
+                if(it == datatypes.end() || !it->second.is_type)
+                    gentest_error("Unrecognized type " + decl->pairs[0].second->s + " of " + name);
+
+                size_t i    = arg_names.size();
+                size_t size = it->second.size * (count ? count : 1);
+                if(i >= fields.size() || size != fields[i].second)
+                    gentest_error(
+                        "Arguments field \"" + name
+                        + "\" does not match format.\n\n"
+                          "Fatal error: YAML Arguments do not match rocblas_arguments.hpp.\n"
+                          "Ensure that rocblas_arguments.hpp and rocblas_common.yaml\n"
+                          "define exactly the same Arguments.");
+
+                arg_names.push_back(name);
+                if(it->second.is_enum && !count)
+                    enum_args.insert(name);
+            }
+
+            if(arg_names.size() != fields.size())
+                gentest_error("Arguments field \"" + std::string(fields[arg_names.size()].first)
+                              + "\" is missing from the YAML Arguments.\n\n"
+                                "Ensure that rocblas_arguments.hpp and rocblas_common.yaml\n"
+                                "define exactly the same Arguments.");
+        }
+
+        // Dynamic defaults of setdefaults() in rocblas_gentest.py. As there, a name which is
+        // checked on its own, rather than in a list of names, matches any part of it.
+        static void setdefaults(test_case& test)
+        {
+            const std::string& function = test.str("function");
+
+            auto one_of = [&](std::initializer_list<const char*> names) {
+                return std::any_of(names.begin(), names.end(), [&](const char* name) {
+                    return function == name;
+                });
+            };
+            auto part_of = [&](const char* name) {
+                return strstr(name, function.c_str()) != nullptr;
+            };
+            auto upper = [&](const char* key) {
+                std::string s = test.str(key);
+                for(char& c : s)
+                    c = toupper((unsigned char)c);
+                return s;
+            };
+            auto product = [&](std::initializer_list<const char*> keys) {
+                py_number p(int64_t(1));
+                for(const char* key : keys)
+                    p = p * py_number(test.at(key));
+                return p;
+            };
+            auto has_all = [&](std::initializer_list<const char*> keys) {
+                return std::all_of(
+                    keys.begin(), keys.end(), [&](const char* k) { return test.has(k); });
+            };
+            // Sets key to the absolute product of the values of keys, if they are all present
+            auto setkey_product = [&](const char* key, std::initializer_list<const char*> keys) {
+                if(has_all(keys))
+                    test.set(key, product(keys).abs().to_int());
+            };
+
+            if(one_of({"asum_strided_batched",    "nrm2_strided_batched",
+                       "scal_strided_batched",    "swap_strided_batched",
+                       "copy_strided_batched",    "dot_strided_batched",
+                       "dotc_strided_batched",    "dot_strided_batched_ex",
+                       "dotc_strided_batched_ex", "rot_strided_batched",
+                       "rot_strided_batched_ex",  "rotm_strided_batched",
+                       "iamax_strided_batched",   "iamin_strided_batched",
+                       "axpy_strided_batched",    "axpy_strided_batched_ex",
+                       "nrm2_strided_batched_ex", "scal_strided_batched_ex"}))
+            {
+                setkey_product("stride_x", {"N", "incx", "stride_scale"});
+                setkey_product("stride_y", {"N", "incy", "stride_scale"});
+            }
+            else if(part_of("tpmv_strided_batched"))
+            {
+                setkey_product("stride_x", {"N", "incx", "stride_scale"});
+                // N * N (> N * (N + 1) / 2) is the stride of the packed format
+                setkey_product("stride_a", {"N", "N", "stride_scale"});
+            }
+            else if(part_of("trmv_strided_batched"))
+            {
+                setkey_product("stride_x", {"N", "incx", "stride_scale"});
+                setkey_product("stride_a", {"N", "lda", "stride_scale"});
+            }
+            else if(part_of("trsv_strided_batched"))
+            {
+                setkey_product("stride_x", {"N", "incx", "stride_scale"});
+                setkey_product("stride_a", {"lda", "N", "stride_scale"});
+            }
+            else if(one_of({"gemv_strided_batched",
+                            "gbmv_strided_batched",
+                            "ger_strided_batched",
+                            "geru_strided_batched",
+                            "gerc_strided_batched"}))
+            {
+                if(one_of({"ger_strided_batched", "geru_strided_batched", "gerc_strided_batched"})
+                   || test.str("transA") == "T" || test.str("transA") == "C")
+                {
+                    setkey_product("stride_x", {"M", "incx", "stride_scale"});
+                    setkey_product("stride_y", {"N", "incy", "stride_scale"});
+                }
+                else
+                {
+                    setkey_product("stride_x", {"N", "incx", "stride_scale"});
+                    setkey_product("stride_y", {"M", "incy", "stride_scale"});
+                }
+                if(part_of("gbmv_strided_batched"))
+                    setkey_product("stride_a", {"lda", "N", "stride_scale"});
+            }
+            else if(one_of(
+                        {"hemv_strided_batched", "hbmv_strided_batched", "sbmv_strided_batched"}))
+            {
+                if(has_all({"N", "incx", "incy", "stride_scale"}))
+                {
+                    setkey_product("stride_x", {"N", "incx", "stride_scale"});
+                    setkey_product("stride_y", {"N", "incy", "stride_scale"});
+                    setkey_product("stride_a", {"N", "lda", "stride_scale"});
+                }
+            }
+            else if(part_of("hpmv_strided_batched"))
+            {
+                if(has_all({"N", "incx", "incy", "stride_scale"}))
+                {
+                    setkey_product("stride_x", {"N", "incx", "stride_scale"});
+                    setkey_product("stride_y", {"N", "incy", "stride_scale"});
+                    py_number N(test.at("N")), N1 = N;
+                    N1.i += 1;
+                    N1.f += 1;
+                    double ldN = (N * N1 * py_number(test.at("stride_scale"))).value() / 2;
+                    test.setdefault("stride_a", make_int(int64_t(ldN)));
+                }
+            }
+            else if(one_of({"spr_strided_batched",
+                            "spr2_strided_batched",
+                            "hpr_strided_batched",
+                            "hpr2_strided_batched",
+                            "tpsv_strided_batched"}))
+            {
+                setkey_product("stride_x", {"N", "incx", "stride_scale"});
+                setkey_product("stride_y", {"N", "incy", "stride_scale"});
+                setkey_product("stride_a", {"N", "N", "stride_scale"});
+            }
+            else if(one_of({"her_strided_batched", "her2_strided_batched", "syr2_strided_batched"}))
+            {
+                setkey_product("stride_x", {"N", "incx", "stride_scale"});
+                setkey_product("stride_y", {"N", "incy", "stride_scale"});
+                setkey_product("stride_a", {"N", "lda", "stride_scale"});
+            }
+            else if(part_of("rotg_strided_batched"))
+            {
+                // stride_c is used for c and stride_d for s, single values in each batch
+                if(test.has("stride_scale"))
+                {
+                    yaml_ptr scale = py_number(test.at("stride_scale")).to_int();
+                    for(const char* key : {"stride_a", "stride_b", "stride_c", "stride_d"})
+                        test.setdefault(key, scale);
+                }
+            }
+            else if(part_of("rotmg_strided_batched"))
+            {
+                // stride_a is used for d1, stride_b for d2 and stride_c for the 5 element param
+                if(test.has("stride_scale"))
+                {
+                    int64_t scale = py_number(test.at("stride_scale")).to_int()->i;
+                    test.setdefault("stride_a", make_int(scale));
+                    test.setdefault("stride_b", make_int(scale));
+                    test.setdefault("stride_c", make_int(scale * 5));
+                    test.setdefault("stride_x", make_int(scale));
+                    test.setdefault("stride_y", make_int(scale));
+                }
+            }
+            else if(part_of("dgmm_strided_batched"))
+            {
+                setkey_product("stride_c", {"N", "ldc", "stride_scale"});
+                setkey_product("stride_a", {"N", "lda", "stride_scale"});
+                if(upper("side") == "L")
+                    setkey_product("stride_x", {"M", "incx", "stride_scale"});
+                else
+                    setkey_product("stride_x", {"N", "incx", "stride_scale"});
+            }
+            else if(part_of("geam_strided_batched"))
+            {
+                setkey_product("stride_c", {"N", "ldc", "stride_scale"});
+                if(upper("transA") == "N")
+                    setkey_product("stride_a", {"N", "lda", "stride_scale"});
+                else
+                    setkey_product("stride_a", {"M", "lda", "stride_scale"});
+                if(upper("transB") == "N")
+                    setkey_product("stride_b", {"N", "ldb", "stride_scale"});
+                else
+                    setkey_product("stride_b", {"M", "ldb", "stride_scale"});
+            }
+            else if(part_of("trmm_strided_batched"))
+            {
+                setkey_product("stride_b", {"N", "ldb", "stride_scale"});
+                setkey_product("stride_c", {"N", "ldc", "stride_scale"});
+                if(upper("side") == "L")
+                    setkey_product("stride_a", {"M", "lda", "stride_scale"});
+                else
+                    setkey_product("stride_a", {"N", "lda", "stride_scale"});
+            }
+            else if(one_of({"trsm_strided_batched", "trsm_strided_batched_ex"}))
+            {
+                setkey_product("stride_b", {"N", "ldb", "stride_scale"});
+                if(upper("side") == "L")
+                    setkey_product("stride_a", {"M", "lda", "stride_scale"});
+                else
+                    setkey_product("stride_a", {"N", "lda", "stride_scale"});
+            }
+            else if(part_of("tbmv_strided_batched"))
+            {
+                if(has_all({"N", "lda", "stride_scale"}))
+                    test.setdefault("stride_a", product({"N", "lda", "stride_scale"}).to_int());
+                if(has_all({"N", "incx", "stride_scale"}))
+                    test.setdefault("stride_x",
+                                    (py_number(test.at("N")) * py_number(test.at("incx")).abs()
+                                     * py_number(test.at("stride_scale")))
+                                        .to_int());
+            }
+            else if(part_of("tbsv_strided_batched"))
+            {
+                setkey_product("stride_a", {"N", "lda", "stride_scale"});
+                setkey_product("stride_x", {"N", "incx", "stride_scale"});
+            }
+
+            test.setdefault("stride_x", make_int(0));
+            test.setdefault("stride_y", make_int(0));
+
+            if(test.str("transA") == "*" || test.str("transB") == "*")
+            {
+                for(const char* key : {"lda", "ldb", "ldc", "ldd"})
+                    test.setdefault(key, make_int(0));
+            }
+            else
+            {
+                // gemm defaults
+                auto nonzero = [&](const char* key) {
+                    const yaml_ptr& v = test.ptr(key);
+                    return py_equal(*v, *make_int(0)) ? make_int(1) : v;
+                };
+                test.setdefault("lda", upper("transA") == "N" ? nonzero("M") : nonzero("K"));
+                test.setdefault("ldb", upper("transB") == "N" ? nonzero("K") : nonzero("N"));
+                test.setdefault("ldc", nonzero("M"));
+                test.setdefault("ldd", nonzero("M"));
+                if(py_number(test.at("batch_count")).value() > 0)
+                {
+                    bool na = upper("transA") == "N", nb = upper("transB") == "N";
+                    test.setdefault("stride_a", product({"lda", na ? "K" : "M"}).to_value());
+                    test.setdefault("stride_b", product({"ldb", nb ? "N" : "K"}).to_value());
+                    test.setdefault("stride_c", product({"ldc", "N"}).to_value());
+                    test.setdefault("stride_d", product({"ldd", "N"}).to_value());
+                    return;
+                }
+            }
+
+            for(const char* key : {"stride_a", "stride_b", "stride_c", "stride_d"})
+                test.setdefault(key, make_int(0));
+        }
+
+        // Constant named by a string value of an enum argument
+        yaml_ptr enum_value(const yaml_ptr& v) const
+        {
+            if(v->kind == yaml_value::string)
+            {
+                auto it = datatypes.find(v->s);
+                if(it != datatypes.end() && !it->second.is_type)
+                    return make_int(it->second.value);
+            }
+            return v;
+        }
+
+        void match_known_bugs(test_case& test) const
+        {
+            static const std::string known_bug = "known_bug";
+            std::set<std::string>    platforms;
+
+            if(known_bug.find(test.str("category")) == std::string::npos)
+                for(const yaml_ptr& bug : known_bugs)
+                {
+                    if(bug->kind != yaml_value::map)
+                        gentest_error("Known bugs must be a list of mappings");
+
+                    bool match = true;
+                    for(const auto& [key, value] : bug->pairs)
+                    {
+                        if(key == "known_bug_platforms" || key == "category")
+                            continue;
+                        const yaml_ptr* v = test.find(key);
+                        if(key == "function")
+                            match = v && value->kind == yaml_value::string
+                                    && wildcard_match(test.str(key).c_str(), value->s.c_str());
+                        else
+                            match = v
+                                    && py_equal(**v,
+                                                *(enum_args.count(key) ? enum_value(value)
+                                                                       : value));
+                        if(!match)
+                            break;
+                    }
+                    if(!match)
+                        continue;
+
+                    // A bug limited to some platforms adds them to known_bug_platforms
+                    const yaml_ptr* p = bug->find("known_bug_platforms");
+                    std::string     list
+                        = p && (*p)->kind == yaml_value::string ? (*p)->s : std::string();
+                    static const char* const separators = " :,\f\n\r\t\v";
+                    for(size_t b = list.find_first_not_of(separators); b != std::string::npos;)
+                    {
+                        size_t e = list.find_first_of(separators, b);
+                        platforms.insert(list.substr(b, e - b));
+                        b = list.find_first_not_of(separators, e);
+                    }
+                    if(platforms.empty())
+                        test.set("category", make_string(known_bug));
+                    break;
+                }
+
+            std::string joined;
+            if(known_bug.find(test.str("category")) == std::string::npos)
+                for(const auto& platform : platforms)
+                    joined += (joined.empty() ? "" : " ") + platform;
+            test.set("known_bug_platforms", make_string(joined));
+        }
+
+        void write_test(const test_case& test)
+        {
+            Arguments arg;
+            memset(&arg, 0, sizeof(arg));
+
+            size_t i       = 0;
+            auto   convert = [&](auto& field) {
+                const std::string& name = arg_names[i++];
+                const yaml_value&  v    = test.at(name);
+                if(!convert_field(field, v))
+                {
+                    std::ostringstream msg;
+                    msg << "Cannot convert " << v << " to the type of " << name << "\n" << test;
+                    gentest_error(msg.str());
+                }
+            };
+#define CONVERT_FIELD(NAME) convert(arg.NAME)
+            FOR_EACH_ARGUMENT(CONVERT_FIELD, ;);
+#undef CONVERT_FIELD
+
+            // Duplicate test cases are written once. Only the offsets of the records are kept in
+            // memory, by hash, and a record with the same hash is read back to compare it.
+            const char* bytes = reinterpret_cast<const char*>(&arg);
+            size_t      hash  = std::hash<std::string_view>{}(std::string_view(bytes, sizeof(arg)));
+            auto        range = records.equal_range(hash);
+            if(range.first != range.second)
+            {
+                bool duplicate = false;
+                char record[sizeof(Arguments)];
+                for(auto it = range.first; !duplicate && it != range.second; ++it)
+                    duplicate = out.seekg(it->second).read(record, sizeof(record))
+                                && !memcmp(record, bytes, sizeof(record));
+                if(!out.seekp(0, std::ios_base::end))
+                    gentest_error("Cannot read back " + out_name);
+                if(duplicate)
+                    return;
+            }
+            records.emplace(hash, out_size);
+            write(bytes, sizeof(arg));
+        }
+
+        void write(const char* bytes, size_t size)
+        {
+            if(!out.write(bytes, size))
+                gentest_error("Cannot write " + out_name);
+            out_size += size;
+        }
+
+        void instantiate(test_case test)
+        {
+            setdefaults(test);
+
+            // For enum arguments, replace names with values
+            for(const std::string& name : enum_args)
+                test.set(name, enum_value(test.ptr(name)));
+
+            match_known_bugs(test);
+            write_test(test);
+        }
+
+        // Generates test combinations by iterating across lists recursively
+        void generate(test_case test)
+        {
+            // Named dictionary lists are merged into the test one item at a time. A map of one
+            // pair makes the argument named by its key take the keys of its value, paired with
+            // the argument named by the pair's value, in alphabetic order.
+            for(const yaml_ptr& argname : dict_lists_to_expand)
+            {
+                if(argname->kind == yaml_value::map)
+                {
+                    if(argname->pairs.size() != 1)
+                        continue;
+                    const std::string& arg    = argname->pairs[0].first;
+                    const yaml_value&  target = *argname->pairs[0].second;
+                    const yaml_ptr*    value  = test.find(arg);
+                    if(!value || (*value)->kind != yaml_value::map)
+                        continue;
+                    if(target.kind != yaml_value::string)
+                        gentest_error("Dictionary lists to expand: " + arg
+                                      + " must be paired with an argument name");
+
+                    yaml_ptr map   = *value;
+                    auto     pairs = map->pairs;
+                    std::stable_sort(pairs.begin(), pairs.end(), [](const auto& a, const auto& b) {
+                        return a.first < b.first;
+                    });
+                    for(const auto& p : pairs)
+                    {
+                        test.set(arg, make_string(p.first));
+                        test.set(target.s, p.second);
+                        generate(test);
+                    }
+                    return;
+                }
+                else if(argname->kind == yaml_value::string)
+                {
+                    const yaml_ptr* value = test.find(argname->s);
+                    if(!value
+                       || ((*value)->kind != yaml_value::list && (*value)->kind != yaml_value::map))
+                        continue;
+
+                    yaml_ptr ilist = *value;
+                    test.erase(argname->s);
+                    auto apply = [&](const yaml_ptr& item) {
+                        if(item->kind != yaml_value::map)
+                        {
+                            std::ostringstream msg;
+                            msg << "Cannot merge " << *item << " for " << argname->s
+                                << "\nA name listed in \"Dictionary lists to expand\" must be"
+                                   " defined as a dictionary.";
+                            gentest_error(msg.str());
+                        }
+                        test_case c = test;
+                        c.update(*item);
+                        generate(std::move(c));
+                    };
+
+                    // A bare dictionary is applied once
+                    if(ilist->kind == yaml_value::map)
+                        apply(ilist);
+                    else
+                        for(const yaml_ptr& item : ilist->items)
+                            apply(item);
+                    return;
+                }
+            }
+
+            for(size_t i = 0; i < test.size(); ++i)
+            {
+                yaml_ptr value = test[i].second;
+
+                // Integer arguments which are ranges (A..B[..C]) are expanded
+                int64_t first, last, step;
+                if(value->kind == yaml_value::string && int_range(value->s, first, last, step))
+                {
+                    if(!step)
+                        gentest_error("The step of the range " + value->s + " must not be zero");
+                    for(int64_t v = first; step > 0 ? v <= last : v > last + 1; v += step)
+                    {
+                        test.value(i) = make_int(v);
+                        generate(test);
+                    }
+                    return;
+                }
+
+                // Sequence arguments are expanded into scalars
+                if(value->kind == yaml_value::list
+                   && std::none_of(lists_to_not_expand.begin(),
+                                   lists_to_not_expand.end(),
+                                   [&](const yaml_ptr& name) {
+                                       return name->kind == yaml_value::string
+                                              && name->s == test[i].first;
+                                   }))
+                {
+                    for(const yaml_ptr& item : value->items)
+                    {
+                        test.value(i) = item;
+                        generate(test);
+                    }
+                    return;
+                }
+            }
+
+            // Typed function names are replaced with generic functions and types
+            if(test.has("rocblas_function"))
+            {
+                std::string func = test.str("rocblas_function");
+                test.erase("rocblas_function");
+
+                auto it = functions.find(func);
+                if(it != functions.end())
+                    test.update(*it->second);
+                else
+                {
+                    size_t p = func.rfind("rocblas_");
+                    test.set("function",
+                             make_string(p == std::string::npos ? func : func.substr(p + 8)));
+                }
+                generate(std::move(test));
+                return;
+            }
+
+            instantiate(std::move(test));
+        }
+
+    public:
+        explicit gentest(const std::string& output)
+            : out(output,
+                  std::ios_base::in | std::ios_base::out | std::ios_base::trunc
+                      | std::ios_base::binary)
+            , out_name(output)
+        {
+            if(!out)
+                gentest_error("Cannot create " + out_name);
+
+            // The signature which Arguments::validate() checks: each byte of a field is its index
+            // xor a value which advances by 89 with each field, between header and trailer
+            Arguments arg;
+            memset(&arg, 0, sizeof(arg));
+            unsigned sig  = 0;
+            auto     sign = [&](auto& field) {
+                auto bytes = reinterpret_cast<unsigned char*>(&field);
+                for(size_t i = 0; i < sizeof(field); ++i)
+                    bytes[i] = sig ^ i;
+                sig = (sig + 89) % 256;
+            };
+#define SIGN_FIELD(NAME) sign(arg.NAME)
+            FOR_EACH_ARGUMENT(SIGN_FIELD, ;);
+#undef SIGN_FIELD
+
+            write("rocBLAS", 8);
+            write(reinterpret_cast<const char*>(&arg), sizeof(arg));
+            write("ROCblas", 8);
+        }
+
+        void process_doc(const yaml_value& doc)
+        {
+            // Ignore empty documents
+            if(!doc)
+                return;
+            if(doc.kind != yaml_value::map)
+                gentest_error("A YAML test document must be a mapping");
+            const yaml_ptr* tests = doc.find("Tests");
+            if(!tests || !**tests)
+                return;
+
+            get_datatypes(doc);
+            get_arguments(doc);
+            dict_lists_to_expand = list_of(doc.find("Dictionary lists to expand"),
+                                           "Dictionary lists to expand");
+            lists_to_not_expand  = list_of(doc.find("Lists to not expand"), "Lists to not expand");
+            known_bugs           = list_of(doc.find("Known bugs"), "Known bugs");
+
+            functions.clear();
+            if(const yaml_ptr* f = doc.find("Functions"))
+                for(const auto& [name, value] : (*f)->pairs)
+                {
+                    if(value->kind != yaml_value::map)
+                        gentest_error("Functions: " + name + " must be a mapping");
+                    functions[name] = value.get();
+                }
+
+            test_case defaults;
+            if(const yaml_ptr* d = doc.find("Defaults"))
+                defaults.update(**d);
+
+            // Instantiate all of the tests, starting with defaults
+            for(const yaml_ptr& test : list_of(tests, "Tests"))
+            {
+                if(test->kind != yaml_value::map)
+                {
+                    std::ostringstream msg;
+                    msg << "A test must be a mapping, found " << *test;
+                    gentest_error(msg.str());
+                }
+                test_case c = defaults;
+                c.update(*test);
+                generate(std::move(c));
+            }
+        }
+
+        void close()
+        {
+            records.clear();
+            out.close();
+            if(out.fail())
+                gentest_error("Cannot write " + out_name);
+        }
+    };
+}
+
+void rocblas_gentest(const std::string&              yaml,
+                     const std::string&              output,
+                     const std::string&              template_file,
+                     const std::vector<std::string>& include_dirs)
+{
+    yaml_source source;
+    source.include_dirs = include_dirs;
+    if(!template_file.empty())
+        source.read(template_file);
+    source.read(yaml);
+    if(source.text.empty())
+        source.line_start.push_back(0), source.line_origin.emplace_back(yaml, 1);
+
+    yaml_parser parser(source);
+    gentest     gen(output);
+    yaml_ptr    doc;
+    while(parser.next_document(doc))
+        gen.process_doc(*doc);
+    gen.close();
+}
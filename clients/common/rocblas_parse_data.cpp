@@ -21,49 +21,54 @@
  * ************************************************************************ */
 
 #include "rocblas_parse_data.hpp"
+#include "cblas_backend.hpp"
 #include "rocblas_data.hpp"
+#include "rocblas_gentest.hpp"
 #include "utility.hpp"
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
-#include <fcntl.h>
 #include <iostream>
 #include <string>
-#include <sys/types.h>
 
-// Parse YAML data
-static std::string rocblas_parse_yaml(const std::string& yaml)
-{
-    std::string tmp     = rocblas_tempname();
-    auto        exepath = rocblas_exepath();
-    auto cmd = exepath + "rocblas_gentest.py --template " + exepath + "rocblas_template.yaml -o "
-               + tmp + " " + yaml;
-    rocblas_cerr << cmd << std::endl;
-
-#ifdef WIN32
-    int status = std::system(cmd.c_str());
-    if(status == -1)
-        exit(EXIT_FAILURE);
-#else
-    int status = system(cmd.c_str());
-    if(status == -1 || !WIFEXITED(status) || WEXITSTATUS(status))
-        exit(EXIT_FAILURE);
-#endif
-
-    return tmp;
-}
-
-// Parse --data and --yaml command-line arguments
+// Parse --data, --yaml and --cblas command-line arguments
 bool rocblas_parse_data(int& argc, char** argv, const std::string& default_file)
 {
     std::string filename;
     char**      argv_p = argv + 1;
     bool        help = false, yaml = false;
 
-    // Scan, process and remove any --yaml or --data options
+    // Scan, process and remove any --yaml, --data, --cblas, --shard or --worker options
     for(int i = 1; argv[i]; ++i)
     {
-        if(!strcmp(argv[i], "--data") || !strcmp(argv[i], "--yaml"))
+        if(!strcmp(argv[i], "--cblas"))
+        {
+            if(!argv[i + 1] || !argv[i + 1][0])
+            {
+                rocblas_cerr << "The " << argv[i] << " option requires an argument" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            cblas_backend_set(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "--shard") || !strcmp(argv[i], "--worker"))
+        {
+            size_t index, count;
+            char   extra;
+            if(!argv[i + 1]
+               || sscanf(argv[i + 1], "%zu/%zu%c", &index, &count, &extra) != 2
+               || index >= count)
+            {
+                rocblas_cerr << "The " << argv[i]
+                             << " option requires an argument i/N, with 0 <= i < N" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            if(!strcmp(argv[i], "--shard"))
+                RocBLAS_TestData::set_shard(index, count);
+            else
+                RocBLAS_TestData::set_worker(index, count);
+            ++i;
+        }
+        else if(!strcmp(argv[i], "--data") || !strcmp(argv[i], "--yaml"))
         {
             if(!strcmp(argv[i], "--yaml"))
             {
@@ -91,7 +96,16 @@ bool rocblas_parse_data(int& argc, char** argv, const std::string& default_file)
             {
                 help = true;
                 rocblas_cout << "\n"
-                             << argv[0] << " [ --data <path> | --yaml <path> ] <options> ...\n"
+                             << argv[0]
+                             << " [ --data <path> | --yaml <path> ] [ --cblas <name> ]"
+                                " [ --shard <i>/<N> ] [ --worker <i>/<N> ] <options> ...\n"
+                             << "\n--cblas selects the host reference BLAS: linked, openblas, blis,"
+                                " mkl, builtin or a library path; only the gemm references use"
+                                " it\n"
+                             << "--shard keeps only slice i, counting from 0, of N equal"
+                                " contiguous slices of the test data\n"
+                             << "--worker keeps the tests which a schedule balanced by their"
+                                " estimated cost assigns to worker i of N\n"
                              << std::endl;
             }
         }
@@ -106,12 +120,18 @@ bool rocblas_parse_data(int& argc, char** argv, const std::string& default_file)
     else if(filename == "")
         filename = default_file;
 
-    if(yaml)
-        filename = rocblas_parse_yaml(filename);
-
     if(filename != "")
     {
-        RocBLAS_TestData::set_filename(filename, yaml);
+        // YAML is expanded into a temporary data file, preceded by the template which defines the
+        // Arguments. The file is removed at exit, including when the expansion fails.
+        if(yaml)
+        {
+            std::string tmp = rocblas_tempname();
+            RocBLAS_TestData::set_filename(tmp, true);
+            rocblas_gentest(filename, tmp, rocblas_exepath() + "rocblas_template.yaml");
+        }
+        else
+            RocBLAS_TestData::set_filename(filename);
         return true;
     }
 
@@ -21,6 +21,7 @@
  * ************************************************************************ */
 
 #include "rocblas_random.hpp"
+#include <cstring>
 
 // Random number generator
 // Note: We do not use random_device to initialize the RNG, because we want
@@ -47,20 +48,22 @@ static thread_local double t_rand_d_array[RANDBUF];
 
 /* ============================================================================================ */
 
-float rocblas_uniform_int_1_10()
+// The runs below copy windows of a per-thread table of values
+static void rocblas_uniform_int_1_10_table()
 {
-    if(!t_rand_init)
+    for(int i = 0; i < RANDBUF; i++)
     {
-        for(int i = 0; i < RANDBUF; i++)
-        {
-            t_rand_f_array[i]
-                = (float)std::uniform_int_distribution<unsigned>(1, 10)(t_rocblas_rng);
-            t_rand_d_array[i] = (double)t_rand_f_array[i];
-        }
-        t_rand_init = 1;
+        t_rand_f_array[i] = (float)std::uniform_int_distribution<unsigned>(1, 10)(t_rocblas_rng);
+        t_rand_d_array[i] = (double)t_rand_f_array[i];
     }
-    t_rocblas_rand_idx = (t_rocblas_rand_idx + 1) & (RANDLEN - 1);
-    return t_rand_f_array[t_rocblas_rand_idx];
+    t_rand_init = 1;
+}
+
+// Single values are drawn directly, so they follow any rocblas_rng_stream::seek; the multiply maps
+// one 32-bit draw to [1, 10] with a bias below 1e-8
+float rocblas_uniform_int_1_10()
+{
+    return float(1 + ((uint64_t(t_rocblas_rng()) * 10) >> 32));
 }
 
 inline int pseudo_rand_ptr_offset()
@@ -72,7 +75,7 @@ inline int pseudo_rand_ptr_offset()
 void rocblas_uniform_int_1_10_run_float(float* ptr, size_t num)
 {
     if(!t_rand_init)
-        rocblas_uniform_int_1_10();
+        rocblas_uniform_int_1_10_table();
 
     for(size_t i = 0; i < num; i += RANDLEN)
     {
@@ -86,7 +89,7 @@ void rocblas_uniform_int_1_10_run_float(float* ptr, size_t num)
 void rocblas_uniform_int_1_10_run_double(double* ptr, size_t num)
 {
     if(!t_rand_init)
-        rocblas_uniform_int_1_10();
+        rocblas_uniform_int_1_10_table();
 
     for(size_t i = 0; i < num; i += RANDLEN)
     {
@@ -100,7 +103,7 @@ void rocblas_uniform_int_1_10_run_double(double* ptr, size_t num)
 void rocblas_uniform_int_1_10_run_float_complex(rocblas_float_complex* ptr, size_t num)
 {
     if(!t_rand_init)
-        rocblas_uniform_int_1_10();
+        rocblas_uniform_int_1_10_table();
 
     constexpr int rand_len = RANDLEN / 2;
     for(size_t i = 0; i < num; i += rand_len)
@@ -115,7 +118,7 @@ void rocblas_uniform_int_1_10_run_float_complex(rocblas_float_complex* ptr, size
 void rocblas_uniform_int_1_10_run_double_complex(rocblas_double_complex* ptr, size_t num)
 {
     if(!t_rand_init)
-        rocblas_uniform_int_1_10();
+        rocblas_uniform_int_1_10_table();
 
     constexpr int rand_len = RANDLEN / 2;
     for(size_t i = 0; i < num; i += rand_len)
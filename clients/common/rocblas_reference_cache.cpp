@@ -0,0 +1,434 @@
+/* ************************************************************************
+ * Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell cop-
+ * ies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM-
+ * PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNE-
+ * CTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ************************************************************************ */
+
+#include "rocblas_reference_cache.hpp"
+#include "cblas_backend.hpp"
+#include "utility.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef WIN32
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if !defined(ROCBLAS_BENCH) && !defined(WIN32)
+
+// Version strings of the host BLAS library, whichever one is linked
+extern "C" {
+char*       openblas_get_config(void) __attribute__((weak));
+const char* bli_info_get_version_str(void) __attribute__((weak));
+}
+
+namespace
+{
+    constexpr char c_magic[8] = "rbref02";
+
+    struct cache_header
+    {
+        char     magic[8];
+        uint64_t key[2];
+        uint64_t bytes;
+    };
+
+    struct cache_config
+    {
+        std::string dir;
+        uint64_t    budget = 0;
+    };
+
+    const cache_config& config()
+    {
+        static const cache_config cfg = [] {
+            cache_config c;
+            const char*  dir = getenv("ROCBLAS_CLIENT_REF_CACHE");
+            if(!dir || !*dir)
+                return c;
+
+            size_t      gb     = 16;
+            const char* gb_str = getenv("ROCBLAS_CLIENT_REF_CACHE_GB");
+            if(gb_str && sscanf(gb_str, "%zu", &gb) != 1)
+                gb = 16;
+
+            mkdir(dir, 0755);
+            struct stat st;
+            if(stat(dir, &st) || !S_ISDIR(st.st_mode))
+            {
+                rocblas_cerr << "Warning: ROCBLAS_CLIENT_REF_CACHE " << dir
+                             << " is not a directory, reference cache disabled" << std::endl;
+                return c;
+            }
+
+            c.dir    = dir;
+            c.budget = uint64_t(gb) << 30;
+            rocblas_cout << "rocBLAS reference cache: " << c.dir << " (" << gb << " GB)"
+                         << std::endl;
+            return c;
+        }();
+        return cfg;
+    }
+
+    // 128-bit key as two FNV-1a hashes with different offset bases
+    class cache_hasher
+    {
+        uint64_t m_h[2] = {0xcbf29ce484222325ull, 0x84222325cbf29ce4ull};
+
+        static uint64_t rotl(uint64_t x, int r)
+        {
+            return x << r | x >> (64 - r);
+        }
+
+    public:
+        void add_bytes(const void* p, size_t n)
+        {
+            auto* b = static_cast<const unsigned char*>(p);
+            for(size_t i = 0; i < n; i++)
+                for(auto& h : m_h)
+                    h = (h ^ b[i]) * 0x100000001b3ull;
+        }
+
+        // strings end at their terminator, so stale bytes after it do not change the key
+        void add(const char* s, size_t max_len)
+        {
+            size_t n = strnlen(s, max_len);
+            add_bytes(&n, sizeof(n));
+            add_bytes(s, n);
+        }
+
+        template <size_t N>
+        void add(const char (&s)[N])
+        {
+            add(s, N);
+        }
+
+        template <typename T>
+        void add(const T& x)
+        {
+            add_bytes(&x, sizeof(x));
+        }
+
+        // Hashes large data, such as the inputs of a reference, a word at a time in each lane,
+        // which is several times faster than add_bytes
+        void add_data(const void* p, size_t n)
+        {
+            auto*    b     = static_cast<const unsigned char*>(p);
+            uint64_t h0    = m_h[0] ^ n;
+            uint64_t h1    = m_h[1] ^ n;
+            size_t   words = n / sizeof(uint64_t);
+            for(size_t i = 0; i < words; i++)
+            {
+                uint64_t w;
+                memcpy(&w, b + i * sizeof(w), sizeof(w));
+                h0 = rotl((h0 ^ w) * 0x100000001b3ull, 31);
+                h1 = rotl((h1 ^ w) * 0x9e3779b97f4a7c15ull, 29);
+            }
+            m_h[0] = h0;
+            m_h[1] = h1;
+            add_bytes(b + words * sizeof(uint64_t), n % sizeof(uint64_t));
+        }
+
+        const uint64_t* key() const
+        {
+            return m_h;
+        }
+    };
+
+    // Fields which cannot change the data generated or the reference result
+    bool key_ignores(const char* name)
+    {
+        static const char* const ignored[] = {"name",
+                                              "category",
+                                              "known_bug_platforms",
+                                              "iters",
+                                              "cold_iters",
+                                              "timing",
+                                              "norm_check",
+                                              "unit_check",
+                                              "res_check"};
+        for(const char* n : ignored)
+            if(!strcmp(n, name))
+                return true;
+        return false;
+    }
+
+    const std::string& library_versions()
+    {
+        static const std::string versions = [] {
+            size_t size;
+            rocblas_get_version_string_size(&size);
+            std::string str(size - 1, '\0');
+            rocblas_get_version_string(str.data(), size);
+
+            // The gemm references may run on a backend selected at run time
+            str += '|';
+            str += cblas_backend_name();
+            str += '|';
+            if(openblas_get_config)
+                str += openblas_get_config();
+            else if(bli_info_get_version_str)
+                str += bli_info_get_version_str();
+            return str;
+        }();
+        return versions;
+    }
+
+    std::string cache_path(const uint64_t* key)
+    {
+        char name[40];
+        snprintf(name,
+                 sizeof(name),
+                 "%016llx%016llx.ref",
+                 (unsigned long long)key[0],
+                 (unsigned long long)key[1]);
+        return config().dir + "/" + name;
+    }
+
+    size_t total_bytes(const rocblas_reference_span* spans, size_t count)
+    {
+        size_t bytes = 0;
+        for(size_t i = 0; i < count; i++)
+            bytes += spans[i].bytes;
+        return bytes;
+    }
+
+    // Remove the least recently used results, by modification time, until the directory fits in
+    // the budget. A hit refreshes the modification time of its file.
+    void evict()
+    {
+        static std::mutex           mutex;
+        std::lock_guard<std::mutex> lock(mutex);
+
+        struct entry
+        {
+            timespec    mtime;
+            uint64_t    bytes;
+            std::string path;
+        };
+        std::vector<entry> entries;
+        uint64_t           used = 0;
+
+        DIR* dir = opendir(config().dir.c_str());
+        if(!dir)
+            return;
+        while(dirent* d = readdir(dir))
+        {
+            size_t len = strlen(d->d_name);
+            if(len < 4 || strcmp(d->d_name + len - 4, ".ref"))
+                continue;
+            std::string path = config().dir + "/" + d->d_name;
+            struct stat st;
+            if(!stat(path.c_str(), &st))
+            {
+                entries.push_back({st.st_mtim, uint64_t(st.st_size), std::move(path)});
+                used += st.st_size;
+            }
+        }
+        closedir(dir);
+
+        if(used <= config().budget)
+            return;
+
+        std::sort(entries.begin(), entries.end(), [](const entry& a, const entry& b) {
+            return a.mtime.tv_sec != b.mtime.tv_sec ? a.mtime.tv_sec < b.mtime.tv_sec
+                                                    : a.mtime.tv_nsec < b.mtime.tv_nsec;
+        });
+        for(const auto& e : entries)
+        {
+            if(used <= config().budget)
+                break;
+            if(!unlink(e.path.c_str()))
+                used -= e.bytes;
+        }
+    }
+}
+
+bool rocblas_reference_cache_enabled()
+{
+    return !config().dir.empty();
+}
+
+rocblas_reference_key rocblas_reference_cache_key(const Arguments&              arg,
+                                                  const char*                   tag,
+                                                  const rocblas_reference_span* inputs,
+                                                  size_t                        input_count,
+                                                  const rocblas_reference_span* outputs,
+                                                  size_t                        output_count)
+{
+    cache_hasher h;
+
+#define HASH_ARGUMENT(NAME) \
+    if(!key_ignores(#NAME)) \
+    h.add(arg.NAME)
+
+    // cppcheck-suppress unknownMacro
+    FOR_EACH_ARGUMENT(HASH_ARGUMENT, ;);
+
+#undef HASH_ARGUMENT
+
+    h.add(tag, strlen(tag));
+
+    // the input data itself, so that any change to how the clients generate it changes the key
+    for(size_t i = 0; i < input_count; i++)
+        h.add_data(inputs[i].data, inputs[i].bytes);
+
+    for(size_t i = 0; i < output_count; i++)
+        h.add(outputs[i].bytes);
+
+    const std::string& versions = library_versions();
+    h.add(versions.c_str(), versions.size());
+    return {{h.key()[0], h.key()[1]}};
+}
+
+bool rocblas_reference_cache_load(const rocblas_reference_key&  key,
+                                  const rocblas_reference_span* spans,
+                                  size_t                        count)
+{
+    const size_t bytes = total_bytes(spans, count);
+    const size_t size  = sizeof(cache_header) + bytes;
+
+    int fd = open(cache_path(key.h).c_str(), O_RDONLY);
+    if(fd < 0)
+        return false;
+
+    bool        hit = false;
+    struct stat st;
+    if(!fstat(fd, &st) && size_t(st.st_size) == size)
+    {
+        void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(map != MAP_FAILED)
+        {
+            const cache_header* header = static_cast<const cache_header*>(map);
+            hit = !memcmp(header->magic, c_magic, sizeof(c_magic)) && header->key[0] == key.h[0]
+                  && header->key[1] == key.h[1] && header->bytes == bytes;
+            if(hit)
+            {
+                const char* src = static_cast<const char*>(map) + sizeof(cache_header);
+                for(size_t i = 0; i < count; i++)
+                {
+                    memcpy(spans[i].data, src, spans[i].bytes);
+                    src += spans[i].bytes;
+                }
+            }
+            munmap(map, size);
+        }
+    }
+
+    // mark as recently used
+    if(hit)
+        futimens(fd, nullptr);
+
+    close(fd);
+    return hit;
+}
+
+void rocblas_reference_cache_store(const rocblas_reference_key&  key,
+                                   const rocblas_reference_span* spans,
+                                   size_t                        count)
+{
+    const size_t bytes = total_bytes(spans, count);
+    const size_t size  = sizeof(cache_header) + bytes;
+
+    if(size > config().budget)
+        return;
+
+    // written under a unique name and renamed, so concurrent runs never see a partial result
+    const std::string path = cache_path(key.h);
+    const size_t      tid  = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    const std::string tmp
+        = path + "." + std::to_string(getpid()) + "." + std::to_string(tid) + ".tmp";
+
+    int fd = open(tmp.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0)
+        return;
+
+    bool written = false;
+    if(!ftruncate(fd, size))
+    {
+        void* map = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if(map != MAP_FAILED)
+        {
+            cache_header* header = static_cast<cache_header*>(map);
+            memcpy(header->magic, c_magic, sizeof(c_magic));
+            header->key[0] = key.h[0];
+            header->key[1] = key.h[1];
+            header->bytes  = bytes;
+
+            char* dst = static_cast<char*>(map) + sizeof(cache_header);
+            for(size_t i = 0; i < count; i++)
+            {
+                memcpy(dst, spans[i].data, spans[i].bytes);
+                dst += spans[i].bytes;
+            }
+            written = !munmap(map, size);
+        }
+    }
+    close(fd);
+
+    if(!written || rename(tmp.c_str(), path.c_str()))
+    {
+        unlink(tmp.c_str());
+        return;
+    }
+
+    evict();
+}
+
+#else
+
+bool rocblas_reference_cache_enabled()
+{
+    return false;
+}
+
+rocblas_reference_key rocblas_reference_cache_key(const Arguments&,
+                                                  const char*,
+                                                  const rocblas_reference_span*,
+                                                  size_t,
+                                                  const rocblas_reference_span*,
+                                                  size_t)
+{
+    return {};
+}
+
+bool rocblas_reference_cache_load(const rocblas_reference_key&,
+                                  const rocblas_reference_span*,
+                                  size_t)
+{
+    return false;
+}
+
+void rocblas_reference_cache_store(const rocblas_reference_key&,
+                                   const rocblas_reference_span*,
+                                   size_t)
+{
+}
+
+#endif
@@ -0,0 +1,220 @@
+/* ************************************************************************
+ * Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell cop-
+ * ies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM-
+ * PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNE-
+ * CTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ************************************************************************ */
+
+
+#include "rocblas_replay.hpp"
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Split a line of a profile YAML log into its (key, value) pairs, stripping YAML quotes
+static std::vector<std::pair<std::string, std::string>>
+    rocblas_replay_yaml_pairs(const std::string& line)
+{
+    std::vector<std::pair<std::string, std::string>> pairs;
+
+    size_t begin = line.find('{'), end = line.rfind('}');
+    if(begin == std::string::npos || end == std::string::npos || end < begin)
+        return pairs;
+
+    std::string item;
+    char        quote = 0;
+    auto        add   = [&] {
+        size_t colon = item.find(':');
+        if(colon != std::string::npos)
+        {
+            auto trim = [](std::string str) {
+                str.erase(0, str.find_first_not_of(" \t"));
+                str.erase(str.find_last_not_of(" \t") + 1);
+                if(str.size() >= 2 && (str[0] == '"' || str[0] == '\'') && str.back() == str[0])
+                    str = str.substr(1, str.size() - 2);
+                return str;
+            };
+            pairs.emplace_back(trim(item.substr(0, colon)), trim(item.substr(colon + 1)));
+        }
+        item.clear();
+    };
+
+    for(size_t i = begin + 1; i < end; ++i)
+    {
+        char c = line[i];
+        if(quote)
+            quote = c == quote ? 0 : quote;
+        else if(c == '"' || c == '\'')
+            quote = c;
+        else if(c == ',')
+        {
+            add();
+            continue;
+        }
+        item += c;
+    }
+    add();
+    return pairs;
+}
+
+// Convert a rocBLAS function name from the profile log, e.g. rocblas_sgemm_strided_batched,
+// into rocblas-bench options selecting the function and its precision
+static bool rocblas_replay_function(std::string name, std::vector<std::string>& tokens)
+{
+    // Some _ex functions are logged without the prefix, e.g. nrm2_ex
+    static constexpr char prefix[] = "rocblas_";
+    if(!name.compare(0, sizeof(prefix) - 1, prefix))
+        name.erase(0, sizeof(prefix) - 1);
+    else if(name.find("_ex") == std::string::npos)
+        return false;
+
+    // ILP64 functions are benchmarked with the C_64 API
+    if(name.size() > 3 && !name.compare(name.size() - 3, 3, "_64"))
+    {
+        name.erase(name.size() - 3);
+        tokens.insert(tokens.end(), {"--api", "1"});
+    }
+
+    // The _ex functions have no precision prefix; their types are separate arguments
+    if(name.find("_ex") != std::string::npos)
+    {
+        tokens.insert(tokens.end(), {"-f", name});
+        return true;
+    }
+
+    // Mixed real/complex prefixes, e.g. rocblas_csscal, rocblas_scasum, rocblas_zdrot
+    static const std::map<std::string, std::vector<std::string>> mixed = {
+        {"cs", {"--a_type", "f32_c", "--b_type", "f32_r", "--c_type", "f32_r"}},
+        {"zd", {"--a_type", "f64_c", "--b_type", "f64_r", "--c_type", "f64_r"}},
+        {"sc", {"-r", "f32_c"}},
+        {"dz", {"-r", "f64_c"}},
+    };
+
+    static const std::map<char, const char*> precision = {
+        {'h', "f16_r"}, {'s', "f32_r"}, {'d', "f64_r"}, {'c', "f32_c"}, {'z', "f64_c"}};
+
+    // isamax, icamin, ... have the precision after the leading i
+    bool index = name.size() > 2 && name[0] == 'i' && precision.count(name[1]);
+    if(index)
+        name.erase(0, 1);
+
+    auto it = mixed.find(name.substr(0, 2));
+    if(it != mixed.end())
+    {
+        for(const char* base : {"scal", "rot", "asum", "nrm2"})
+            if(!name.compare(2, strlen(base), base))
+            {
+                tokens.insert(tokens.end(), {"-f", name.substr(2)});
+                tokens.insert(tokens.end(), it->second.begin(), it->second.end());
+                return true;
+            }
+    }
+
+    auto prec = precision.find(name[0]);
+    if(prec == precision.end())
+        return false;
+
+    tokens.insert(tokens.end(), {"-f", (index ? "i" : "") + name.substr(1), "-r", prec->second});
+    return true;
+}
+
+bool rocblas_replay_parse_line(const std::string&        line,
+                               std::vector<std::string>& tokens,
+                               size_t&                   count)
+{
+    tokens.clear();
+    count = 1;
+
+    // Bench log: ./rocblas-bench -f gemm -r f32_r ...
+    static constexpr char bench[] = "rocblas-bench";
+    size_t                pos     = line.find(bench);
+    if(pos != std::string::npos)
+    {
+        std::istringstream is(line.substr(pos + sizeof(bench) - 1));
+        for(std::string token; is >> token;)
+            tokens.push_back(token);
+        return !tokens.empty();
+    }
+
+    // Profile log: - { rocblas_function: "rocblas_sgemm", atomics_mode: ..., call_count: 3 }
+    auto pairs = rocblas_replay_yaml_pairs(line);
+    auto func  = std::find_if(pairs.begin(), pairs.end(), [](const auto& p) {
+        return p.first == "rocblas_function";
+    });
+    if(func == pairs.end() || !rocblas_replay_function(func->second, tokens))
+        return false;
+
+    // Profile keys which are named differently by rocblas-bench
+    static const std::map<std::string, std::string> renamed = {{"M", "-m"},
+                                                               {"N", "-n"},
+                                                               {"K", "-k"},
+                                                               {"m", "-m"},
+                                                               {"n", "-n"},
+                                                               {"k", "-k"},
+                                                               {"transA", "--transposeA"},
+                                                               {"transa", "--transposeA"},
+                                                               {"trans", "--transposeA"},
+                                                               {"transB", "--transposeB"},
+                                                               {"stride_A", "--stride_a"},
+                                                               {"stride_B", "--stride_b"},
+                                                               {"bsa", "--stride_a"},
+                                                               {"bsinvA", "--stride_b"},
+                                                               {"batch", "--batch_count"}};
+
+    // Profile keys which rocblas-bench has no option for: the timings of the calls, and the
+    // leading dimension of the trtri inverse, which rocblas-bench sets to lda
+    static const std::set<std::string> ignored
+        = {"timed_calls", "gpu_us_min", "gpu_us_p50", "gpu_us_p99", "gpu_us_max", "ldinvA"};
+
+    for(const auto& p : pairs)
+    {
+        const std::string& key   = p.first;
+        const std::string& value = p.second;
+        if(key == "rocblas_function" || ignored.count(key))
+            continue;
+        else if(key == "call_count")
+            count = std::stoull(value);
+        else if(key == "atomics_mode")
+        {
+            if(value == "atomics_not_allowed")
+                tokens.push_back("--atomics_not_allowed");
+        }
+        else if((key == "alpha" || key == "beta") && !value.empty() && value[0] == '(')
+        {
+            // Complex scalars are logged as (real,imag)
+            size_t comma = value.find_first_of(",:");
+            tokens.insert(tokens.end(), {"--" + key, value.substr(1, comma - 1)});
+            if(comma != std::string::npos)
+            {
+                std::string imag = value.substr(comma + 1, value.size() - comma - 2);
+                tokens.insert(tokens.end(), {"--" + key + "i", imag});
+            }
+        }
+        else
+        {
+            auto it = renamed.find(key);
+            tokens.insert(tokens.end(), {it != renamed.end() ? it->second : "--" + key, value});
+        }
+    }
+    return true;
+}
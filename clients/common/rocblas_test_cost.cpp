@@ -0,0 +1,223 @@
+/* ************************************************************************
+ * Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell cop-
+ * ies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM-
+ * PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNE-
+ * CTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ************************************************************************ */
+
+#include "rocblas_test_cost.hpp"
+#include "bytes.hpp"
+#include "flops.hpp"
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+namespace
+{
+    // Fixed overhead of a test, in seconds: handle, allocations and launches
+    constexpr double c_test_overhead = 2e-3;
+
+    // Rough host throughputs of the reference BLAS, and of the initialization and comparison of
+    // the data, in GFLOP/s and GB/s
+    constexpr double c_host_gflops = 10;
+    constexpr double c_host_gbytes = 1;
+
+    // Removes the first occurrence of suffix from name, and returns whether it was found
+    bool remove(std::string& name, const char* suffix)
+    {
+        size_t pos = name.find(suffix);
+        if(pos == std::string::npos)
+            return false;
+        name.erase(pos, strlen(suffix));
+        return true;
+    }
+
+    template <typename T>
+    double elements_gbyte(double elements)
+    {
+        return elements * sizeof(T) / 1e9;
+    }
+
+    // Work of one problem of the function family fn, in GFLOP and GB
+    template <typename T>
+    void test_work(const std::string& fn, const Arguments& arg, double& gflop, double& gbyte)
+    {
+        int64_t M  = std::max<int64_t>(arg.M, 0);
+        int64_t N  = std::max<int64_t>(arg.N, 0);
+        int64_t K  = std::max<int64_t>(arg.K, 0);
+        int64_t KL = std::max<int64_t>(arg.KL, 0);
+        int64_t KU = std::max<int64_t>(arg.KU, 0);
+
+        rocblas_operation transA = char2rocblas_operation(arg.transA);
+        rocblas_side      side   = char2rocblas_side(arg.side);
+        int64_t           k_side = side == rocblas_side_left ? M : N;
+
+        // Level 3, whose data is counted in matrix elements
+        if(fn == "gemm" || fn == "gemmt")
+        {
+            gflop = gemm_gflop_count<T>(M, N, K);
+            gbyte = elements_gbyte<T>(double(M) * K + double(K) * N + 2.0 * M * N);
+        }
+        else if(fn == "geam")
+        {
+            // geam_ex computes the min-plus or plus-min product of A and B
+            bool ex = strstr(arg.function, "_ex");
+            gflop   = ex ? geam_min_plus_gflop_count<T>(M, N, K) : geam_gflop_count<T>(M, N);
+            gbyte   = elements_gbyte<T>(ex ? double(M) * K + double(K) * N + 2.0 * M * N
+                                           : 3.0 * M * N);
+        }
+        else if(fn == "symm" || fn == "hemm")
+        {
+            gflop = symm_gflop_count<T>(side, M, N);
+            gbyte = elements_gbyte<T>(double(k_side) * k_side + 2.0 * M * N);
+        }
+        else if(fn == "trmm" || fn == "trsm")
+        {
+            gflop = trsm_gflop_count<T>(M, N, k_side);
+            gbyte = elements_gbyte<T>(double(k_side) * k_side + 2.0 * M * N);
+        }
+        else if(fn == "syrk" || fn == "herk" || fn == "syr2k" || fn == "her2k" || fn == "syrkx"
+                || fn == "herkx")
+        {
+            gflop = syr2k_gflop_count<T>(N, K);
+            gbyte = elements_gbyte<T>(2.0 * N * K + double(N) * N);
+        }
+        else if(fn == "trtri")
+        {
+            gflop = trtri_gflop_count<T>(N);
+            gbyte = elements_gbyte<T>(2.0 * N * N);
+        }
+        else if(fn == "dgmm")
+        {
+            gflop = dgmm_gflop_count<T>(M, N);
+            gbyte = elements_gbyte<T>(2.0 * M * N + k_side);
+        }
+        // Level 2
+        else if(fn == "gemv")
+        {
+            gflop = gemv_gflop_count<T>(transA, M, N);
+            gbyte = gemv_gbyte_count<T>(transA, M, N);
+        }
+        else if(fn == "ger" || fn == "geru" || fn == "gerc")
+        {
+            gflop = ger_gflop_count<T>(M, N);
+            gbyte = ger_gbyte_count<T>(M, N);
+        }
+        else if(fn == "gbmv")
+        {
+            gflop = gbmv_gflop_count<T>(transA, M, N, KL, KU);
+            gbyte = elements_gbyte<T>(double(KL + KU + 1) * N + M + N);
+        }
+        else if(fn == "sbmv" || fn == "hbmv" || fn == "tbmv" || fn == "tbsv")
+        {
+            gflop = sbmv_gflop_count<T>(N, K);
+            gbyte = sbmv_gbyte_count<T>(N, K);
+        }
+        else if(fn == "symv" || fn == "hemv" || fn == "spmv" || fn == "hpmv" || fn == "trmv"
+                || fn == "tpmv" || fn == "trsv" || fn == "tpsv" || fn == "syr" || fn == "her"
+                || fn == "spr" || fn == "hpr" || fn == "syr2" || fn == "her2" || fn == "spr2"
+                || fn == "hpr2")
+        {
+            gflop = symv_gflop_count<T>(N);
+            gbyte = symv_gbyte_count<T>(N);
+        }
+        // Data transfers
+        else if(fn == "set_get_matrix_sync" || fn == "set_get_matrix_async")
+        {
+            gflop = 0;
+            gbyte = set_get_matrix_gbyte_count<T>(M, N);
+        }
+        else if(fn == "set_get_vector_sync" || fn == "set_get_vector_async")
+        {
+            gflop = 0;
+            gbyte = set_get_vector_gbyte_count<T>(N);
+        }
+        // Level 1, and the other tests, cost about as much as an axpy of size N
+        else
+        {
+            gflop = axpy_gflop_count<T>(N);
+            gbyte = axpy_gbyte_count<T>(N);
+        }
+    }
+
+    template <typename T>
+    double test_cost(const std::string& fn, const Arguments& arg, int64_t batch_count)
+    {
+        double gflop, gbyte;
+        test_work<T>(fn, arg, gflop, gbyte);
+
+        // The host reference computes in double precision at about half the rate
+        if(std::is_same<T, double>{} || std::is_same<T, rocblas_double_complex>{})
+            gflop *= 2;
+
+        return c_test_overhead + batch_count * (gflop / c_host_gflops + gbyte / c_host_gbytes);
+    }
+}
+
+double rocblas_test_cost(const Arguments& arg)
+{
+    std::string fn = arg.function;
+
+    // Argument checks and queries run no problem
+    if(remove(fn, "_bad_arg") || remove(fn, "_get_solutions"))
+        return c_test_overhead;
+
+    bool batched = remove(fn, "_strided_batched") || remove(fn, "_batched");
+    if(!remove(fn, "_ex3"))
+        remove(fn, "_ex");
+
+    int64_t batch_count = batched ? std::max<int64_t>(arg.batch_count, 1) : 1;
+
+    switch(arg.a_type)
+    {
+    case rocblas_datatype_f64_r:
+        return test_cost<double>(fn, arg, batch_count);
+    case rocblas_datatype_f32_c:
+        return test_cost<rocblas_float_complex>(fn, arg, batch_count);
+    case rocblas_datatype_f64_c:
+        return test_cost<rocblas_double_complex>(fn, arg, batch_count);
+    default:
+        return test_cost<float>(fn, arg, batch_count);
+    }
+}
+
+std::vector<size_t> rocblas_test_schedule(const std::vector<double>& costs,
+                                          std::vector<double>&       totals)
+{
+    std::vector<size_t> order(costs.size());
+    for(size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::stable_sort(
+        order.begin(), order.end(), [&](size_t a, size_t b) { return costs[a] > costs[b]; });
+
+    std::vector<size_t> worker(costs.size());
+    std::vector<double> load(totals.size());
+    for(size_t i : order)
+    {
+        // Least loaded worker, and on ties the one with the least total
+        size_t best = 0;
+        for(size_t w = 1; w < load.size(); ++w)
+            if(load[w] < load[best] || (load[w] == load[best] && totals[w] < totals[best]))
+                best = w;
+        worker[i] = best;
+        load[best] += costs[i];
+        totals[best] += costs[i];
+    }
+    return worker;
+}
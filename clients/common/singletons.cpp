@@ -21,6 +21,13 @@
  * ************************************************************************ */
 
 #include "singletons.hpp"
+#include "rocblas_test.hpp"
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 // global for device memory padding see d_vector.hpp
 size_t g_DVEC_PAD = 4096;
@@ -29,3 +36,229 @@ void d_vector_set_pad_length(size_t pad)
 {
     g_DVEC_PAD = pad;
 }
+
+// global cache of device memory blocks see d_vector.hpp
+namespace
+{
+    struct d_vector_cache_t
+    {
+        std::mutex                        mutex;
+        bool                              enabled = false;
+        std::multimap<size_t, void*>      free_blocks; // size -> block available for reuse
+        std::unordered_map<void*, size_t> used_blocks; // block -> size handed out
+        size_t                            reused    = 0;
+        size_t                            allocated = 0;
+
+        static void free_block(void* ptr)
+        {
+            CHECK_HIP_ERROR((hipFree)(ptr));
+        }
+
+        // Free all blocks which are not in use
+        void trim()
+        {
+            for(auto& block : free_blocks)
+                free_block(block.second);
+            free_blocks.clear();
+        }
+    };
+
+    d_vector_cache_t& d_vector_cache()
+    {
+        static d_vector_cache_t cache;
+        return cache;
+    }
+}
+
+void d_vector_cache_enable(bool enable)
+{
+    auto&                       cache = d_vector_cache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.enabled = enable;
+    if(!enable)
+    {
+        cache.trim();
+        cache.reused = cache.allocated = 0;
+    }
+}
+
+bool d_vector_cache_enabled()
+{
+    auto&                       cache = d_vector_cache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    return cache.enabled;
+}
+
+void* d_vector_cache_acquire(size_t bytes)
+{
+    auto&                       cache = d_vector_cache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+
+    // Reuse the smallest free block which fits, unless it would waste more than half of it
+    auto it = cache.free_blocks.lower_bound(bytes);
+    if(it != cache.free_blocks.end() && it->first / 2 <= bytes)
+    {
+        void* ptr = it->second;
+        cache.used_blocks.emplace(ptr, it->first);
+        cache.free_blocks.erase(it);
+        ++cache.reused;
+        return ptr;
+    }
+
+    // Allocate a new block, releasing the free blocks first if device memory is exhausted
+    void* ptr = nullptr;
+    if((hipMalloc)(&ptr, bytes) != hipSuccess)
+    {
+        (void)hipGetLastError();
+        cache.trim();
+        if((hipMalloc)(&ptr, bytes) != hipSuccess)
+            return nullptr;
+    }
+    cache.used_blocks.emplace(ptr, bytes);
+    ++cache.allocated;
+    return ptr;
+}
+
+bool d_vector_cache_release(void* ptr)
+{
+    auto&                       cache = d_vector_cache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+
+    auto it = cache.used_blocks.find(ptr);
+    if(it == cache.used_blocks.end())
+        return false; // not allocated by the cache
+
+    if(cache.enabled)
+        cache.free_blocks.emplace(it->second, ptr);
+    else
+        cache.free_block(ptr);
+    cache.used_blocks.erase(it);
+    return true;
+}
+
+void d_vector_cache_stats(size_t& reused, size_t& allocated)
+{
+    auto&                       cache = d_vector_cache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    reused    = cache.reused;
+    allocated = cache.allocated;
+}
+
+// guard regions around the blocks of d_vector see d_vector.hpp
+namespace
+{
+    // Pinned copies of the guard patterns, kept for the lifetime of the process so that they
+    // outlive the asynchronous copies from them
+    struct d_vector_guard_patterns_t
+    {
+        std::mutex                             mutex;
+        std::unordered_map<const void*, void*> pinned;
+    };
+
+    const void* d_vector_guard_pinned(const void* pattern, size_t pattern_size)
+    {
+        static d_vector_guard_patterns_t patterns;
+        std::lock_guard<std::mutex>      lock(patterns.mutex);
+
+        void*& pinned = patterns.pinned[pattern];
+        if(!pinned)
+        {
+            if(hipHostMalloc(&pinned, pattern_size, hipHostMallocDefault) != hipSuccess)
+            {
+                pinned = nullptr;
+                return pattern; // copies from pageable memory complete before returning
+            }
+            memcpy(pinned, pattern, pattern_size);
+        }
+        return pinned;
+    }
+
+    // Pinned buffer of the thread into which the guards are read back
+    class d_vector_guard_arena_t
+    {
+        void*             pinned = nullptr;
+        size_t            size   = 0;
+        std::vector<char> pageable; // fallback if pinned memory cannot be allocated
+
+    public:
+        ~d_vector_guard_arena_t()
+        {
+            if(pinned)
+                (void)hipHostFree(pinned);
+        }
+
+        char* get(size_t bytes)
+        {
+            if(bytes > size)
+            {
+                if(pinned)
+                    (void)hipHostFree(pinned);
+                if(hipHostMalloc(&pinned, bytes, hipHostMallocDefault) != hipSuccess)
+                {
+                    pinned = nullptr;
+                    pageable.resize(bytes);
+                    return pageable.data();
+                }
+                size = bytes;
+            }
+            return static_cast<char*>(pinned);
+        }
+    };
+
+    // Offset of the first byte at which a and b differ, or bytes if they are equal. The words are
+    // compared in one vectorized pass, and the bytes are only scanned once a difference is found.
+    size_t first_difference(const char* a, const char* b, size_t bytes)
+    {
+        size_t   words = bytes / sizeof(uint64_t);
+        uint64_t diff  = 0;
+#ifdef _OPENMP
+#pragma omp simd reduction(| : diff)
+#endif
+        for(size_t i = 0; i < words; i++)
+        {
+            uint64_t x, y;
+            memcpy(&x, a + i * sizeof(x), sizeof(x));
+            memcpy(&y, b + i * sizeof(y), sizeof(y));
+            diff |= x ^ y;
+        }
+
+        size_t i = diff ? 0 : words * sizeof(uint64_t);
+        while(i < bytes && a[i] == b[i])
+            i++;
+        return i;
+    }
+}
+
+void d_vector_guard_write(
+    void* before, void* after, const void* pattern, size_t pattern_size, size_t bytes)
+{
+    const void* src = d_vector_guard_pinned(pattern, pattern_size);
+
+    // Copy the guard pattern to device memory before and after the block
+    if(hipMemcpyAsync(before, src, bytes, hipMemcpyDefault, 0) != hipSuccess)
+        rocblas_cerr << "Error: hipMemcpy pre-guard copy failure." << std::endl;
+    if(hipMemcpyAsync(after, src, bytes, hipMemcpyDefault, 0) != hipSuccess)
+        rocblas_cerr << "Error: hipMemcpy post-guard copy failure." << std::endl;
+}
+
+bool d_vector_guard_check(
+    const void* before, const void* after, const void* pattern, size_t bytes, size_t& offset)
+{
+    static thread_local d_vector_guard_arena_t arena;
+    char*                                      guards = arena.get(2 * bytes);
+
+    // Copy both guards back to host memory, after the work which may have corrupted them
+    if(hipMemcpyAsync(guards, before, bytes, hipMemcpyDefault, 0) != hipSuccess
+       || hipMemcpyAsync(guards + bytes, after, bytes, hipMemcpyDefault, 0) != hipSuccess
+       || hipStreamSynchronize(0) != hipSuccess)
+    {
+        rocblas_cerr << "Error: hipMemcpy guard copy failure." << std::endl;
+        return true;
+    }
+
+    auto guard = static_cast<const char*>(pattern);
+    offset     = first_difference(guards, guard, bytes);
+    if(offset == bytes)
+        offset += first_difference(guards + bytes, guard, bytes);
+    return offset == 2 * bytes;
+}
@@ -24,14 +24,26 @@
 
 #include "../../library/src/include/check_numerics_matrix.hpp"
 #include "../../library/src/include/check_numerics_vector.hpp"
+#include "cblas_backend.hpp"
 #include "rocblas_data.hpp"
 #include "rocblas_float8.h"
+#include "near.hpp"
 #include "rocblas_matrix.hpp"
+#include "rocblas_replay.hpp"
+#include "rocblas_test_cost.hpp"
 #include "rocblas_vector.hpp"
 #include "type_dispatch.hpp"
+#include "unit.hpp"
 
 #include "include/utility.hpp"
 
+#include <algorithm>
+#include <gtest/gtest-spi.h>
+#include <limits>
+#include <numeric>
+#include <set>
+#include <sstream>
+
 namespace
 {
     template <typename T>
@@ -391,6 +403,822 @@ namespace
     }
     INSTANTIATE_TEST_CATEGORIES(helper_utilities);
 
+    //
+    // schedule of the tests over parallel workers
+
+    void testing_test_schedule(const Arguments& arg)
+    {
+        // Costs over several orders of magnitude, in a scrambled order, with repeated values
+        std::vector<double> costs;
+        for(int i = 0; i < 1000; i++)
+            costs.push_back(1e-3 * std::exp2((i * 7919 % 1000) / 100.0));
+
+        double max_cost = *std::max_element(costs.begin(), costs.end());
+        double sum      = std::accumulate(costs.begin(), costs.end(), 0.0);
+
+        for(size_t workers : {1, 3, 8})
+        {
+            std::vector<double> totals(workers);
+            std::vector<size_t> worker = rocblas_test_schedule(costs, totals);
+            ASSERT_EQ(worker.size(), costs.size());
+
+            // Every test goes to exactly one worker, and the loads add up to the total cost
+            std::vector<double> load(workers);
+            for(size_t i = 0; i < costs.size(); i++)
+            {
+                ASSERT_LT(worker[i], workers);
+                load[worker[i]] += costs[i];
+            }
+            EXPECT_NEAR(std::accumulate(load.begin(), load.end(), 0.0), sum, sum * 1e-12);
+            for(size_t w = 0; w < workers; w++)
+                EXPECT_NEAR(totals[w], load[w], sum * 1e-12);
+
+            // The last test added to the most loaded worker went to the least loaded one, so the
+            // loads differ by at most the largest cost
+            auto minmax = std::minmax_element(load.begin(), load.end());
+            EXPECT_LE(*minmax.second - *minmax.first, max_cost);
+
+            // The schedule is a function of the costs and totals only
+            std::vector<double> totals2(workers);
+            EXPECT_EQ(rocblas_test_schedule(costs, totals2), worker);
+        }
+
+        // Ties go to the worker with the least total, so groups of single tests are spread over
+        // all of the workers instead of piling onto the first
+        std::vector<double> totals(4);
+        for(int group = 0; group < 4; group++)
+            rocblas_test_schedule({1.0, 1.0, 1.0}, totals);
+        for(double total : totals)
+            EXPECT_EQ(total, 3.0);
+
+        EXPECT_TRUE(rocblas_test_schedule({}, totals).empty());
+    }
+
+    template <typename...>
+    struct test_schedule_testing : rocblas_test_valid
+    {
+        void operator()(const Arguments& arg)
+        {
+            if(!strcmp(arg.function, "test_schedule"))
+                testing_test_schedule(arg);
+            else
+                FAIL() << "Internal error: Test called with unknown function: " << arg.function;
+        }
+    };
+
+    struct test_schedule : RocBLAS_Test<test_schedule, test_schedule_testing>
+    {
+        // Filter for which types apply to this suite
+        static bool type_filter(const Arguments& arg)
+        {
+            return true;
+        }
+
+        // Filter for which functions apply to this suite
+        static bool function_filter(const Arguments& arg)
+        {
+            return !strcmp(arg.function, "test_schedule");
+        }
+
+        // Google Test name suffix based on parameters
+        static std::string name_suffix(const Arguments& arg)
+        {
+            return RocBLAS_TestName<test_schedule>(arg.name);
+        }
+    };
+
+    TEST_P(test_schedule, auxiliary)
+    {
+        CATCH_SIGNALS_AND_EXCEPTIONS_AS_FAILURES(
+            rocblas_simple_dispatch<test_schedule_testing>(GetParam()));
+    }
+    INSTANTIATE_TEST_CATEGORIES(test_schedule);
+
+    //
+    // bulk comparison of UNIT_CHECK and NEAR_CHECK
+
+    // Runs check, which calls UNIT_CHECK or NEAR_CHECK, and returns the message of the failure it
+    // raised, or an empty string if it passed
+    template <typename F>
+    std::string bulk_check_failure(F&& check)
+    {
+        testing::TestPartResultArray results;
+        {
+            testing::ScopedFakeTestPartResultReporter reporter(
+                testing::ScopedFakeTestPartResultReporter::INTERCEPT_ONLY_CURRENT_THREAD, &results);
+            check();
+        }
+        if(!results.size())
+            return "";
+        EXPECT_EQ(results.size(), 1);
+        EXPECT_TRUE(results.GetTestPartResult(0).fatally_failed());
+        return results.GetTestPartResult(0).message();
+    }
+
+    void testing_bulk_check(const Arguments& arg)
+    {
+        const float nan = std::numeric_limits<float>::quiet_NaN();
+
+        // Equal matrices pass, whatever is in the padding beyond M
+        {
+            float cpu[] = {1, 2, 3, -1, 4, 5, 6, -1};
+            float gpu[] = {1, 2, 3, -2, 4, 5, 6, -2};
+            auto  check = [&] { UNIT_CHECK(3, 2, 4, 0, cpu, gpu, 1, ASSERT_FLOAT_EQ); };
+            EXPECT_EQ(bulk_check_failure(check), "");
+        }
+
+        // Mismatches are reported in order of batch, column and row, with the largest errors
+        {
+            float cpu[] = {1, 2, 3, 4, 5, 6, 1, 2, 3, 4, 5, 6};
+            float gpu[] = {1, 2, 3, 3, 5, 6, 1, 2, 5, 4, 5, 6};
+            auto  check = [&] { UNIT_CHECK(3, 2, 3, 6, cpu, gpu, 2, ASSERT_FLOAT_EQ); };
+            EXPECT_EQ(bulk_check_failure(check),
+                      "Failed\n"
+                      "2 of 12 elements differ, max abs error 2, max rel error 0.666666667\n"
+                      "  batch 0, row 0, col 1: expected 4, got 3\n"
+                      "  batch 1, row 2, col 0: expected 3, got 5");
+        }
+
+        // Only the first mismatches are listed
+        {
+            std::vector<double> cpu(12, 1.0), gpu(12, 2.0);
+            auto        check   = [&] { UNIT_CHECK(12, 1, 12, 0, cpu, gpu, 1, ASSERT_DOUBLE_EQ); };
+            std::string failure = bulk_check_failure(check);
+            EXPECT_EQ(failure.substr(0, failure.find('\n', 7)),
+                      "Failed\n12 of 12 elements differ, max abs error 1, max rel error 1");
+            EXPECT_NE(failure.find("  batch 0, row 9, col 0: expected 1, got 2\n  ..."),
+                      std::string::npos);
+            EXPECT_EQ(failure.find("row 10"), std::string::npos);
+        }
+
+        // A NaN in the reference must be matched by a NaN, and NaNs are left out of the errors
+        {
+            float cpu[] = {nan, nan, 1};
+            float gpu[] = {nan, 1, nan};
+            auto  check = [&] { UNIT_CHECK(3, 1, 3, 0, cpu, gpu, 1, ASSERT_FLOAT_EQ); };
+            EXPECT_EQ(bulk_check_failure(check),
+                      "Failed\n"
+                      "2 of 3 elements differ, max abs error 0, max rel error 0\n"
+                      "  batch 0, row 1, col 0: expected nan, got 1\n"
+                      "  batch 0, row 2, col 0: expected 1, got nan");
+        }
+
+        // A vector with a negative increment is stored backwards, so index 0 is element 2
+        {
+            float cpu[] = {3, 0, 2, 0, 1};
+            float gpu[] = {4, 9, 2, 9, 1};
+            auto  check = [&] { UNIT_CHECK(1, 3, -2, 0, cpu, gpu, 1, ASSERT_FLOAT_EQ); };
+            EXPECT_EQ(bulk_check_failure(check),
+                      "Failed\n"
+                      "1 of 3 elements differ, max abs error 1, max rel error 0.333333333\n"
+                      "  batch 0, row 0, col 2: expected 3, got 4");
+        }
+
+        // The tolerance of ASSERT_FLOAT_EQ is 4 ULP
+        {
+            float ulp4 = 1;
+            for(int i = 0; i < 4; i++)
+                ulp4 = std::nextafter(ulp4, 2.0f);
+
+            float cpu[] = {1, 1};
+            float gpu[] = {ulp4, 1};
+            auto  check = [&] { UNIT_CHECK(2, 1, 2, 0, cpu, gpu, 1, ASSERT_FLOAT_EQ); };
+            EXPECT_EQ(bulk_check_failure(check), "");
+
+            gpu[1] = std::nextafter(ulp4, 2.0f);
+            EXPECT_EQ(bulk_check_failure(check),
+                      "Failed\n"
+                      "1 of 2 elements differ, max abs error 5.96046448e-07, max rel error "
+                      "5.96046448e-07\n"
+                      "  batch 0, row 1, col 0: expected 1, got 1.0000006");
+        }
+
+        // A bfloat16 result may match the rounded or the truncated float reference
+        {
+            float            cpu[] = {1.005859375f, 1.005859375f, 1.005859375f};
+            rocblas_bfloat16 gpu[] = {rocblas_bfloat16(1.0f),
+                                      rocblas_bfloat16(1.0078125f),
+                                      rocblas_bfloat16(1.015625f)};
+            auto check_rounded_truncated
+                = [&] { UNIT_CHECK(2, 1, 2, 0, cpu, gpu, 1, ASSERT_FLOAT_BF16_EQ); };
+            EXPECT_EQ(bulk_check_failure(check_rounded_truncated), "");
+
+            auto check = [&] { UNIT_CHECK(3, 1, 3, 0, cpu, gpu, 1, ASSERT_FLOAT_BF16_EQ); };
+            EXPECT_EQ(bulk_check_failure(check),
+                      "Failed\n"
+                      "1 of 3 elements differ, max abs error 0.009765625, max rel error "
+                      "0.00970873786\n"
+                      "  batch 0, row 2, col 0: expected 1.00585938, got 1.015625");
+        }
+
+        // NEAR_CHECK compares with an absolute tolerance, and complex values report both parts
+        {
+            rocblas_double_complex cpu[] = {{1, 2}, {3, 4}};
+            rocblas_double_complex gpu[] = {{1.05, 2}, {3, 4.5}};
+            auto check = [&] { NEAR_CHECK(2, 1, 2, 0, cpu, gpu, 1, 0.25, NEAR_ASSERT_COMPLEX); };
+            EXPECT_EQ(bulk_check_failure(check),
+                      "Failed\n"
+                      "1 of 2 elements differ, max abs error 0.5, max rel error "
+                      "0.10000000000000001\n"
+                      "  batch 0, row 1, col 0: expected (3,4), got (3,4.5)");
+        }
+    }
+
+    template <typename...>
+    struct bulk_check_testing : rocblas_test_valid
+    {
+        void operator()(const Arguments& arg)
+        {
+            if(!strcmp(arg.function, "bulk_check"))
+                testing_bulk_check(arg);
+            else
+                FAIL() << "Internal error: Test called with unknown function: " << arg.function;
+        }
+    };
+
+    struct bulk_check : RocBLAS_Test<bulk_check, bulk_check_testing>
+    {
+        // Filter for which types apply to this suite
+        static bool type_filter(const Arguments& arg)
+        {
+            return true;
+        }
+
+        // Filter for which functions apply to this suite
+        static bool function_filter(const Arguments& arg)
+        {
+            return !strcmp(arg.function, "bulk_check");
+        }
+
+        // Google Test name suffix based on parameters
+        static std::string name_suffix(const Arguments& arg)
+        {
+            return RocBLAS_TestName<bulk_check>(arg.name);
+        }
+    };
+
+    TEST_P(bulk_check, auxiliary)
+    {
+        CATCH_SIGNALS_AND_EXCEPTIONS_AS_FAILURES(
+            rocblas_simple_dispatch<bulk_check_testing>(GetParam()));
+    }
+    INSTANTIATE_TEST_CATEGORIES(bulk_check);
+
+    //
+    // parsing of the logs replayed by rocblas-bench --replay
+
+    void testing_replay_parse(const Arguments& arg)
+    {
+        // The options which rocblas-bench defines, and which a replayed line may use
+        std::set<std::string> bench_options;
+        std::istringstream    options(
+            "-f -r -m -n -k --kl --ku --lda --ldb --ldc --ldd --stride_a --stride_b --stride_c "
+            "--stride_d --stride_x --stride_y --incx --incy --alpha --alphai --beta --betai "
+            "--a_type --b_type --c_type --d_type --compute_type --transposeA --transposeB --side "
+            "--uplo --diag --batch_count --algo --solution_index --flags --geam_ex_op "
+            "--atomics_not_allowed --api");
+        for(std::string option; options >> option;)
+            bench_options.insert(option);
+
+        // One profile line for each set of keys which the library logs, e.g. rocblas_trmm logs
+        // m, n and transa where rocblas_gemm logs M, N and transA
+        static const std::pair<const char*, const char*> profiles[] = {
+            {"rocblas_sasum", "N incx"},
+            {"rocblas_sasum_batched", "N incx batch_count"},
+            {"rocblas_sasum_strided_batched", "N incx stride_x batch_count"},
+            {"rocblas_saxpy_batched", "N incx incy batch"},
+            {"rocblas_saxpy", "N incx incy"},
+            {"rocblas_saxpy_strided_batched", "N incx stride_x incy stride_y batch"},
+            {"rocblas_scopy_batched", "N incx incy batch_count"},
+            {"rocblas_scopy_strided_batched", "N incx stride_x incy stride_y batch_count"},
+            {"rocblas_srotg_batched", "batch_count"},
+            {"rocblas_srotg", ""},
+            {"rocblas_srotg_strided_batched", "stride_a stride_b stride_c stride_d batch_count"},
+            {"rocblas_srotmg_strided_batched",
+             "stride_a stride_b stride_c stride_x stride_y batch_count"},
+            {"rocblas_sgbmv", "transA M N kl ku lda incx incy"},
+            {"rocblas_sgbmv_batched", "transA M N kl ku lda incx incy batch_count"},
+            {"rocblas_sgbmv_strided_batched",
+             "transA M N kl ku lda stride_a incx stride_x incy stride_y batch_count"},
+            {"rocblas_sgemv", "transA M N lda incx incy"},
+            {"rocblas_sgemv_batched", "transA M N lda incx incy batch_count"},
+            {"rocblas_sgemv_strided_batched",
+             "transA M N lda stride_a incx stride_x incy stride_y batch_count"},
+            {"rocblas_sger", "M N incx incy lda"},
+            {"rocblas_sger_batched", "M N incx incy lda batch_count"},
+            {"rocblas_sger_strided_batched",
+             "M N incx stride_x incy stride_y lda stride_a batch_count"},
+            {"rocblas_chbmv", "uplo N K lda incx incy"},
+            {"rocblas_chbmv_batched", "uplo N K lda incx incy batch_count"},
+            {"rocblas_chbmv_strided_batched",
+             "uplo N k lda stride_a incx stride_x incy stride_y batch_count"},
+            {"rocblas_chemv", "uplo N lda incx incy"},
+            {"rocblas_chemv_batched", "uplo N lda incx incy batch_count"},
+            {"rocblas_chemv_strided_batched",
+             "uplo N lda stride_a incx stride_x incy stride_y batch_count"},
+            {"rocblas_cher", "uplo N incx lda"},
+            {"rocblas_cher2", "uplo N incx incy lda"},
+            {"rocblas_cher2_batched", "uplo N incx incy lda batch_count"},
+            {"rocblas_cher2_strided_batched",
+             "uplo N incx stride_x incy stride_y lda stride_a batch_count"},
+            {"rocblas_cher_batched", "uplo N incx lda batch_count"},
+            {"rocblas_cher_strided_batched", "uplo N incx stride_x lda stride_a batch_count"},
+            {"rocblas_chpmv", "uplo N incx incy"},
+            {"rocblas_chpmv_batched", "uplo N incx incy batch_count"},
+            {"rocblas_chpmv_strided_batched",
+             "uplo N stride_a incx stride_x incy stride_y batch_count"},
+            {"rocblas_chpr", "uplo N incx"},
+            {"rocblas_chpr2_strided_batched",
+             "uplo N incx stride_x incy stride_y stride_a batch_count"},
+            {"rocblas_chpr_batched", "uplo N incx batch_count"},
+            {"rocblas_chpr_strided_batched", "uplo N incx stride_x stride_a batch_count"},
+            {"rocblas_ssbmv_strided_batched",
+             "uplo N K lda stride_a incx stride_x incy stride_y batch_count"},
+            {"rocblas_sspr2_strided_batched",
+             "uplo N incx incy stride_x stride_y stride_a batch_count"},
+            {"rocblas_ssyr2_strided_batched",
+             "uplo N incx incy lda stride_x stride_y stride_a batch_count"},
+            {"rocblas_stbmv", "uplo transA diag N k lda incx"},
+            {"rocblas_stbmv_batched", "uplo transA diag N k lda incx batch_count"},
+            {"rocblas_stbmv_strided_batched",
+             "uplo transA diag N k lda stride_a incx stride_x batch_count"},
+            {"rocblas_stbsv", "uplo transA diag N K lda incx"},
+            {"rocblas_stbsv_batched", "uplo transA diag N K lda incx batch_count"},
+            {"rocblas_stbsv_strided_batched",
+             "uplo transA diag N K lda stride_a incx stride_x batch_count"},
+            {"rocblas_stpmv", "uplo transA diag N incx"},
+            {"rocblas_stpmv_batched", "uplo transA diag N incx batch_count"},
+            {"rocblas_stpmv_strided_batched",
+             "uplo transA diag N stride_a incx stride_x batch_count"},
+            {"rocblas_strmv", "uplo transA diag N lda incx"},
+            {"rocblas_strmv_batched", "uplo transA diag N lda incx batch_count"},
+            {"rocblas_strmv_strided_batched",
+             "uplo transA diag N lda stride_a incx stride_x batch_count"},
+            {"rocblas_sgemm", "transA transB M N K alpha lda ldb beta ldc"},
+            {"rocblas_sgemm_batched", "transA transB M N K alpha lda ldb beta ldc batch_count"},
+            {"rocblas_sgemm_strided_batched",
+             "transA transB M N K alpha lda stride_a ldb stride_b beta ldc stride_c batch_count"},
+            {"rocblas_sdgmm", "side M N lda incx ldc"},
+            {"rocblas_sgeam", "transA transB M N lda ldb ldc"},
+            {"rocblas_chemm", "side uplo M N lda ldb ldc"},
+            {"rocblas_chemm_batched", "side uplo M N lda ldb ldc batch_count"},
+            {"rocblas_chemm_strided_batched",
+             "side uplo M N lda stride_a ldb stride_b ldc stride_c batch_count"},
+            {"rocblas_cher2k", "uplo trans N K lda ldb ldc"},
+            {"rocblas_cher2k_batched", "uplo trans N K lda ldb ldc batch_count"},
+            {"rocblas_cher2k_strided_batched",
+             "uplo trans N K lda stride_a ldb stride_b ldc stride_c batch_count"},
+            {"rocblas_cherk", "uplo transA N K lda ldc"},
+            {"rocblas_cherk_batched", "uplo transA N K lda ldc batch_count"},
+            {"rocblas_cherk_strided_batched",
+             "uplo transA N K lda stride_a ldc stride_c batch_count"},
+            {"rocblas_ssyr2k", "uplo transA N K lda ldb ldc"},
+            {"rocblas_ssyr2k_batched", "uplo transA N K lda ldb ldc batch_count"},
+            {"rocblas_ssyr2k_strided_batched",
+             "uplo transA N K lda stride_a ldb stride_b ldc stride_c batch_count"},
+            {"rocblas_strmm", "side uplo transa diag m n lda ldb ldc"},
+            {"rocblas_strmm_batched", "side uplo transa diag m n lda ldb ldc batch_count"},
+            {"rocblas_strmm_strided_batched",
+             "side uplo transa diag m n lda stride_a ldb stride_b ldc stride_c batch_count"},
+            {"rocblas_strsm", "side uplo transA diag m n lda ldb"},
+            {"rocblas_strsm_batched", "side uplo transA diag m n lda ldb batch_count"},
+            {"rocblas_strsm_strided_batched",
+             "side uplo transA diag m n lda stride_A ldb stride_B batch_count"},
+            {"rocblas_strtri", "uplo diag N lda ldinvA"},
+            {"rocblas_strtri_batched", "uplo diag N lda ldinvA batch_count"},
+            {"rocblas_strtri_strided_batched", "uplo diag N lda bsa ldinvA bsinvA batch_count"},
+            {"rocblas_axpy_batched_ex",
+             "N a_type b_type incx c_type incy batch_count compute_type"},
+            {"rocblas_axpy_ex", "N a_type b_type incx c_type incy compute_type"},
+            {"rocblas_axpy_strided_batched_ex",
+             "N a_type b_type incx stride_x c_type incy stride_y batch_count compute_type"},
+            {"rocblas_dot_batched_ex", "N a_type incx b_type incy batch_count c_type compute_type"},
+            {"rocblas_dot_ex", "N a_type incx b_type incy c_type compute_type"},
+            {"rocblas_dot_strided_batched_ex",
+             "N a_type incx stride_x b_type incy stride_y batch_count c_type compute_type"},
+            {"rocblas_geam_ex",
+             "a_type b_type c_type d_type compute_type transA transB M N K alpha lda ldb beta ldc "
+             "ldd geam_ex_op"},
+            {"rocblas_geam_ex",
+             "a_type b_type c_type d_type compute_type transA transB M N K lda ldb ldc ldd "
+             "geam_ex_op"},
+            {"rocblas_gemm_batched_ex",
+             "a_type b_type c_type d_type compute_type transA transB M N K alpha lda ldb beta ldc "
+             "ldd batch_count algo solution_index flags"},
+            {"rocblas_gemm_ex",
+             "a_type b_type c_type d_type compute_type transA transB M N K alpha lda ldb beta ldc "
+             "ldd algo solution_index flags"},
+            {"rocblas_gemm_strided_batched_ex",
+             "a_type b_type c_type d_type compute_type transA transB M N K alpha lda stride_a ldb "
+             "stride_b beta ldc stride_c ldd stride_d batch_count algo solution_index flags"},
+            {"rocblas_sgemmt", "uplo N K lda ldb ldc"},
+            {"rocblas_sgemmt_strided_batched",
+             "uplo N K lda stride_a ldb stride_b ldc stride_c batch_count"},
+            {"nrm2_batched_ex", "N a_type incx b_type batch_count compute_type"},
+            {"nrm2_ex", "N a_type incx b_type compute_type"},
+            {"nrm2_strided_batched_ex", "N a_type incx stride_x b_type batch_count compute_type"},
+            {"rocblas_rot_batched_ex", "N a_type incx b_type incy c_type batch_count compute_type"},
+            {"rocblas_rot_strided_batched_ex",
+             "N a_type incx stride_x b_type incy stride_y c_type batch_count compute_type"},
+            {"rocblas_scal_batched_ex", "N a_type b_type incx batch_count compute_type"},
+            {"rocblas_scal_ex", "N a_type b_type incx compute_type"},
+            {"rocblas_scal_strided_batched_ex",
+             "N a_type b_type incx stride_x batch_count compute_type"},
+            {"rocblas_trsv_batched_ex", "uplo transA diag M lda incx batch_count"},
+            {"rocblas_trsv_ex", "uplo transA diag M lda incx"},
+            {"rocblas_trsv_strided_batched_ex",
+             "uplo transA diag M lda stride_a incx stride_x batch_count"},
+        };
+
+        auto value = [](const std::string& key) -> std::string {
+            if(key == "transA" || key == "transa" || key == "trans" || key == "diag")
+                return "'N'";
+            if(key == "transB")
+                return "'T'";
+            if(key == "uplo")
+                return "'U'";
+            if(key == "side")
+                return "'L'";
+            if(key.find("_type") != std::string::npos)
+                return "\"f32_r\"";
+            if(key == "batch" || key == "batch_count")
+                return "3";
+            return "64";
+        };
+
+        for(const auto& profile : profiles)
+        {
+            std::string line = std::string("- { rocblas_function: \"") + profile.first
+                               + "\", atomics_mode: atomics_allowed";
+            std::istringstream keys(profile.second);
+            for(std::string key; keys >> key;)
+                line += ", " + key + ": " + value(key);
+            line += ", call_count: 5, timed_calls: 5, gpu_us_min: 1.5, gpu_us_p50: 2, gpu_us_p99: "
+                    "3, gpu_us_max: 3.5 }";
+
+            std::vector<std::string> tokens;
+            size_t                   count = 0;
+            ASSERT_TRUE(rocblas_replay_parse_line(line, tokens, count)) << line;
+            EXPECT_EQ(count, 5u) << line;
+            ASSERT_GE(tokens.size(), 2u) << line;
+            EXPECT_EQ(tokens[0], "-f") << line;
+
+            // Options alternate with their values, except for the flag --atomics_not_allowed
+            for(size_t i = 0; i < tokens.size(); ++i)
+            {
+                EXPECT_TRUE(bench_options.count(tokens[i]))
+                    << "rocblas-bench has no option " << tokens[i] << " for " << line;
+                if(tokens[i] != "--atomics_not_allowed")
+                    ++i;
+            }
+        }
+
+        // Renamed keys keep their values
+        auto joined = [](const std::vector<std::string>& tokens) {
+            std::string str;
+            for(const auto& token : tokens)
+                str += (str.empty() ? "" : " ") + token;
+            return str;
+        };
+
+        std::vector<std::string> tokens;
+        size_t                   count;
+        ASSERT_TRUE(rocblas_replay_parse_line(
+            "- { rocblas_function: \"rocblas_dtrtri_strided_batched\", atomics_mode: "
+            "atomics_not_allowed, uplo: 'L', diag: 'U', N: 7, lda: 9, bsa: 63, ldinvA: 9, bsinvA: "
+            "70, batch_count: 2, call_count: 4 }",
+            tokens,
+            count));
+        EXPECT_EQ(count, 4u);
+        EXPECT_EQ(joined(tokens),
+                  "-f trtri_strided_batched -r f64_r --atomics_not_allowed --uplo L --diag U -n 7 "
+                  "--lda 9 --stride_a 63 --stride_b 70 --batch_count 2");
+
+        ASSERT_TRUE(rocblas_replay_parse_line(
+            "- { rocblas_function: \"rocblas_ctrmm\", atomics_mode: atomics_allowed, side: 'R', "
+            "uplo: 'U', transa: 'C', diag: 'N', m: 5, n: 6, lda: 6, ldb: 5, ldc: 5, alpha: "
+            "'(1.5,-2)', call_count: 1 }",
+            tokens,
+            count));
+        EXPECT_EQ(joined(tokens),
+                  "-f trmm -r f32_c --side R --uplo U --transposeA C --diag N -m 5 -n 6 --lda 6 "
+                  "--ldb 5 --ldc 5 --alpha 1.5 --alphai -2");
+
+        ASSERT_TRUE(rocblas_replay_parse_line(
+            "- { rocblas_function: \"nrm2_ex\", atomics_mode: atomics_allowed, N: 10, a_type: "
+            "\"f32_c\", incx: 1, b_type: \"f32_r\", compute_type: \"f32_r\", call_count: 1 }",
+            tokens,
+            count));
+        EXPECT_EQ(joined(tokens),
+                  "-f nrm2_ex -n 10 --a_type f32_c --incx 1 --b_type f32_r --compute_type f32_r");
+
+        // Lines which log no call are skipped
+        EXPECT_FALSE(rocblas_replay_parse_line("- { gpu_us_min: 1 }", tokens, count));
+        EXPECT_FALSE(rocblas_replay_parse_line("rocblas_sgemm,N,N,1,1,1", tokens, count));
+    }
+
+    template <typename...>
+    struct replay_parse_testing : rocblas_test_valid
+    {
+        void operator()(const Arguments& arg)
+        {
+            if(!strcmp(arg.function, "replay_parse"))
+                testing_replay_parse(arg);
+            else
+                FAIL() << "Internal error: Test called with unknown function: " << arg.function;
+        }
+    };
+
+    struct replay_parse : RocBLAS_Test<replay_parse, replay_parse_testing>
+    {
+        // Filter for which types apply to this suite
+        static bool type_filter(const Arguments& arg)
+        {
+            return true;
+        }
+
+        // Filter for which functions apply to this suite
+        static bool function_filter(const Arguments& arg)
+        {
+            return !strcmp(arg.function, "replay_parse");
+        }
+
+        // Google Test name suffix based on parameters
+        static std::string name_suffix(const Arguments& arg)
+        {
+            return RocBLAS_TestName<replay_parse>(arg.name);
+        }
+    };
+
+    TEST_P(replay_parse, auxiliary)
+    {
+        CATCH_SIGNALS_AND_EXCEPTIONS_AS_FAILURES(
+            rocblas_simple_dispatch<replay_parse_testing>(GetParam()));
+    }
+    INSTANTIATE_TEST_CATEGORIES(replay_parse);
+
+    //
+    // builtin host reference gemm against the linked CBLAS
+
+    template <typename T>
+    void testing_cblas_backend(const Arguments& arg)
+    {
+        // Not multiples of the builtin blocking, with leading dimensions past the last row
+        const int64_t M = 37, N = 29, K = 41;
+        const int64_t lda = 48, ldb = 48, ldc = 40;
+
+        rocblas_seedrand();
+        const T alpha = random_generator<T>(), beta = random_generator<T>();
+        std::vector<T> A(lda * std::max(M, K)), B(ldb * std::max(K, N)), C(ldc * N);
+        for(auto* v : {&A, &B, &C})
+            for(auto& x : *v)
+                x = random_generator<T>();
+
+        // The inputs are small integers, so both results are exact and must be equal
+        std::vector<rocblas_operation> ops{rocblas_operation_none, rocblas_operation_transpose};
+        if(rocblas_is_complex<T>)
+            ops.push_back(rocblas_operation_conjugate_transpose);
+
+        for(auto transA : ops)
+            for(auto transB : ops)
+            {
+                SCOPED_TRACE(std::string("transA ") + rocblas_transpose_letter(transA)
+                             + ", transB " + rocblas_transpose_letter(transB));
+
+                std::vector<T> linked(C), builtin(C);
+                cblas_backend_gemm<T>("linked",
+                                      transA,
+                                      transB,
+                                      M,
+                                      N,
+                                      K,
+                                      alpha,
+                                      A.data(),
+                                      lda,
+                                      B.data(),
+                                      ldb,
+                                      beta,
+                                      linked.data(),
+                                      ldc);
+                cblas_backend_gemm<T>("builtin",
+                                      transA,
+                                      transB,
+                                      M,
+                                      N,
+                                      K,
+                                      alpha,
+                                      A.data(),
+                                      lda,
+                                      B.data(),
+                                      ldb,
+                                      beta,
+                                      builtin.data(),
+                                      ldc);
+
+                unit_check_general<T>(M, N, ldc, linked.data(), builtin.data());
+
+                // The rows past M are left alone
+                for(int64_t j = 0; j < N; j++)
+                    for(int64_t i = M; i < ldc; i++)
+                        ASSERT_EQ(builtin[i + j * ldc], C[i + j * ldc]);
+            }
+    }
+
+    // By default, arbitrary type combinations are invalid.
+    // The unnamed second parameter is used for enable_if_t below.
+    template <typename, typename = void>
+    struct cblas_backend_testing : rocblas_test_invalid
+    {
+    };
+
+    // When the condition in the second argument is satisfied, the type combination
+    // is valid. When the condition is false, this specialization does not apply.
+    template <typename T>
+    struct cblas_backend_testing<
+        T,
+        std::enable_if_t<std::is_same_v<T, float> || std::is_same_v<T, double>
+                         || std::is_same_v<T, rocblas_float_complex>
+                         || std::is_same_v<T, rocblas_double_complex>>> : rocblas_test_valid
+    {
+        void operator()(const Arguments& arg)
+        {
+            if(!strcmp(arg.function, "cblas_backend"))
+                testing_cblas_backend<T>(arg);
+            else
+                FAIL() << "Internal error: Test called with unknown function: " << arg.function;
+        }
+    };
+
+    struct cblas_backend : RocBLAS_Test<cblas_backend, cblas_backend_testing>
+    {
+        // Filter for which types apply to this suite
+        static bool type_filter(const Arguments& arg)
+        {
+            return true;
+        }
+
+        // Filter for which functions apply to this suite
+        static bool function_filter(const Arguments& arg)
+        {
+            return !strcmp(arg.function, "cblas_backend");
+        }
+
+        // Google Test name suffix based on parameters
+        static std::string name_suffix(const Arguments& arg)
+        {
+            RocBLAS_TestName<cblas_backend> name(arg.name);
+            name << rocblas_datatype2string(arg.a_type);
+            return std::move(name);
+        }
+    };
+
+    TEST_P(cblas_backend, auxiliary)
+    {
+        CATCH_SIGNALS_AND_EXCEPTIONS_AS_FAILURES(
+            rocblas_simple_dispatch<cblas_backend_testing>(GetParam()));
+    }
+    INSTANTIATE_TEST_CATEGORIES(cblas_backend);
+
+    //
+    // random matrix and vector initialization
+
+    // Rows i0 to i0 + 2999 of column 7 of batch member 2, filled in bulk, against single elements
+    template <typename T>
+    void random_fill_check(T rand_gen())
+    {
+        rocblas_seedrand();
+        rocblas_random_source<T> random(rand_gen);
+
+        for(int64_t i0 : {0, 1, 3, 1023, 1029})
+            for(int64_t inc : {1, 3})
+            {
+                std::vector<T> x(3000 * inc);
+                random.fill(2, 7, i0, 3000, x.data(), inc);
+                for(int64_t k = 0; k < 3000; k++)
+                {
+                    T value = random(2, i0 + k, 7);
+                    ASSERT_EQ(memcmp(&x[k * inc], &value, sizeof(T)), 0)
+                        << "row " << i0 + k << ", inc " << inc;
+                }
+            }
+    }
+
+    template <typename T>
+    void testing_random_init(const Arguments& arg)
+    {
+        // The bulk Philox blocks are the words of the sequential generator
+        uint32_t words[4 * 21];
+        rocblas_philox_rng::blocks(0x123456789abcdef, 77, 5, 21, words);
+        rocblas_philox_rng rng(0x123456789abcdef, 77);
+        rng.discard(4 * 5);
+        for(uint32_t word : words)
+            ASSERT_EQ(word, rng());
+
+        EXPECT_NE(rocblas_random_bulk_find(random_generator<T>).words, 0);
+        EXPECT_NE(rocblas_random_bulk_find(random_hpl_generator<T>).words, 0);
+        EXPECT_EQ(rocblas_random_bulk_find(random_nan_generator<T>).words, 0);
+
+        random_fill_check(random_generator<T>);
+        random_fill_check(random_hpl_generator<T>);
+        random_fill_check(random_nan_generator<T>);
+
+        // The values follow the distributions of the generators
+        rocblas_seedrand();
+        const int64_t  N = 100000;
+        std::vector<T> x(N);
+        rocblas_init_vector(random_generator<T>, x.data(), N, 1);
+        int64_t count[11] = {};
+        auto    tally     = [&](double part) {
+            ASSERT_TRUE(part >= 1 && part <= 10 && part == int(part)) << part;
+            count[int(part)]++;
+        };
+        for(T value : x)
+        {
+            tally(std::real(value));
+            if(rocblas_is_complex<T>)
+                tally(std::imag(value));
+        }
+        int64_t draws = rocblas_is_complex<T> ? 2 * N : N;
+        for(int v = 1; v <= 10; v++)
+            EXPECT_NEAR(count[v], draws / 10.0, 6 * std::sqrt(draws / 10.0)) << v;
+
+        rocblas_init_vector(random_hpl_generator<T>, x.data(), N, 1);
+        for(T value : x)
+            ASSERT_TRUE(std::real(value) > -0.5 && std::real(value) < 0.5 && std::imag(value) == 0);
+
+        // The matrices do not depend on the number of threads
+        const int64_t  M = 70, lda = 80, batch_count = 3;
+        host_vector<T> A(lda * M * batch_count), B(lda * M * batch_count);
+        for(auto type : {rocblas_client_general_matrix,
+                         rocblas_client_triangular_matrix,
+                         rocblas_client_symmetric_matrix})
+        {
+            rocblas_seedrand();
+            rocblas_init_matrix(type, 'U', random_generator<T>, A, M, M, lda, lda * M, batch_count);
+#ifdef _OPENMP
+            int threads = omp_get_max_threads();
+            omp_set_num_threads(1);
+#endif
+            rocblas_seedrand();
+            rocblas_init_matrix(type, 'U', random_generator<T>, B, M, M, lda, lda * M, batch_count);
+#ifdef _OPENMP
+            omp_set_num_threads(threads);
+#endif
+            EXPECT_EQ(memcmp(A.data(), B.data(), A.size() * sizeof(T)), 0) << type;
+        }
+    }
+
+    template <typename, typename = void>
+    struct random_init_testing : rocblas_test_invalid
+    {
+    };
+
+    template <typename T>
+    struct random_init_testing<
+        T,
+        std::enable_if_t<std::is_same_v<T, float> || std::is_same_v<T, double>
+                         || std::is_same_v<T, rocblas_float_complex>
+                         || std::is_same_v<T, rocblas_double_complex>>> : rocblas_test_valid
+    {
+        void operator()(const Arguments& arg)
+        {
+            if(!strcmp(arg.function, "random_init"))
+                testing_random_init<T>(arg);
+            else
+                FAIL() << "Internal error: Test called with unknown function: " << arg.function;
+        }
+    };
+
+    struct random_init : RocBLAS_Test<random_init, random_init_testing>
+    {
+        // Filter for which types apply to this suite
+        static bool type_filter(const Arguments& arg)
+        {
+            return true;
+        }
+
+        // Filter for which functions apply to this suite
+        static bool function_filter(const Arguments& arg)
+        {
+            return !strcmp(arg.function, "random_init");
+        }
+
+        // Google Test name suffix based on parameters
+        static std::string name_suffix(const Arguments& arg)
+        {
+            RocBLAS_TestName<random_init> name(arg.name);
+            name << rocblas_datatype2string(arg.a_type);
+            return std::move(name);
+        }
+    };
+
+    TEST_P(random_init, auxiliary)
+    {
+        CATCH_SIGNALS_AND_EXCEPTIONS_AS_FAILURES(
+            rocblas_simple_dispatch<random_init_testing>(GetParam()));
+    }
+    INSTANTIATE_TEST_CATEGORIES(random_init);
+
     //
     // check numerics
 
@@ -20,13 +20,17 @@
  *
  * ************************************************************************ */
 
+#include "../../library/src/include/profile_estimate.hpp"
 #include "rocblas_data.hpp"
 #include "rocblas_datatype2string.hpp"
 #include "rocblas_test.hpp"
 #include "testing_logging.hpp"
 #include "type_dispatch.hpp"
 #include <cctype>
+#include <cmath>
 #include <cstring>
+#include <map>
+#include <string>
 #include <type_traits>
 
 namespace
@@ -47,7 +51,7 @@ namespace
     {
         void operator()(const Arguments& arg)
         {
-            if(!strcmp(arg.function, "logging"))
+            if(!strcmp(arg.function, "logging") || !strcmp(arg.function, "logging_deferred"))
                 testing_logging<T>(arg);
             else
                 FAIL() << "Internal error: Test called with unknown function: " << arg.function;
@@ -65,7 +69,7 @@ namespace
         // Filter for which functions apply to this suite
         static bool function_filter(const Arguments& arg)
         {
-            return !strcmp(arg.function, "logging");
+            return !strcmp(arg.function, "logging") || !strcmp(arg.function, "logging_deferred");
         }
 
         // Google Test name suffix based on parameters
@@ -82,4 +86,258 @@ namespace
     }
     INSTANTIATE_TEST_CATEGORIES(logging);
 
+    //
+    // JSON profile output
+
+    // Parser of the JSON syntax of RFC 8259, which records the members of the outermost object as
+    // their JSON text
+    class json_parser
+    {
+        const char*                         p;
+        std::map<std::string, std::string>* members;
+        int                                 depth;
+
+        void space()
+        {
+            while(*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')
+                ++p;
+        }
+
+        bool literal(const char* word)
+        {
+            size_t len = strlen(word);
+            if(strncmp(p, word, len))
+                return false;
+            p += len;
+            return true;
+        }
+
+        bool digits()
+        {
+            const char* begin = p;
+            while(isdigit(uint8_t(*p)))
+                ++p;
+            return p != begin;
+        }
+
+        bool number()
+        {
+            if(*p == '-')
+                ++p;
+            if(*p == '0')
+                ++p;
+            else if(!digits())
+                return false;
+            if(*p == '.')
+            {
+                ++p;
+                if(!digits())
+                    return false;
+            }
+            if(*p == 'e' || *p == 'E')
+            {
+                ++p;
+                if(*p == '+' || *p == '-')
+                    ++p;
+                if(!digits())
+                    return false;
+            }
+            return true;
+        }
+
+        bool string(std::string* str = nullptr)
+        {
+            if(*p++ != '"')
+                return false;
+            for(; *p != '"'; ++p)
+            {
+                // Control characters must be escaped
+                if(uint8_t(*p) < 0x20)
+                    return false;
+                if(*p == '\\')
+                {
+                    ++p;
+                    if(*p == 'u')
+                    {
+                        for(int i = 0; i < 4; ++i)
+                            if(!isxdigit(uint8_t(*++p)))
+                                return false;
+                    }
+                    else if(!*p || !strchr("\"\\/bfnrt", *p))
+                        return false;
+                }
+                if(str)
+                    *str += *p;
+            }
+            ++p;
+            return true;
+        }
+
+        bool value()
+        {
+            space();
+            if(*p == '{' || *p == '[')
+            {
+                char close = *p++ == '{' ? '}' : ']';
+                ++depth;
+                space();
+                if(*p != close)
+                {
+                    for(;;)
+                    {
+                        std::string key;
+                        if(close == '}')
+                        {
+                            space();
+                            if(!string(&key))
+                                return false;
+                            space();
+                            if(*p++ != ':')
+                                return false;
+                        }
+                        space();
+                        const char* begin = p;
+                        if(!value())
+                            return false;
+                        if(depth == 1 && close == '}')
+                            (*members)[key] = std::string(begin, p);
+                        space();
+                        if(*p != ',')
+                            break;
+                        ++p;
+                    }
+                }
+                --depth;
+                return *p++ == close;
+            }
+            if(*p == '"')
+                return string();
+            if(*p == '-' || isdigit(uint8_t(*p)))
+                return number();
+            return literal("true") || literal("false") || literal("null");
+        }
+
+    public:
+        // Parses text, which must be one JSON value, and returns whether its syntax is valid
+        bool operator()(const std::string& text, std::map<std::string, std::string>& members)
+        {
+            p             = text.c_str();
+            depth         = 0;
+            this->members = &members;
+            members.clear();
+            if(!value())
+                return false;
+            space();
+            return !*p;
+        }
+    };
+
+    void testing_logging_profile_json(const Arguments& arg)
+    {
+        json_parser                        parse;
+        std::map<std::string, std::string> members;
+
+        // The parser itself rejects what the profile output must not contain
+        EXPECT_TRUE(parse("{\"a\": [1, -2.5e+3, \"x\\ty\"], \"b\": {\"c\": null}}", members));
+        EXPECT_EQ(members["a"], "[1, -2.5e+3, \"x\\ty\"]");
+        EXPECT_FALSE(parse("{\"a\": nan}", members));
+        EXPECT_FALSE(parse("{\"a\": inf}", members));
+        EXPECT_FALSE(parse("{\"a\": \"x\ty\"}", members));
+        EXPECT_FALSE(parse("{\"a\": 1,}", members));
+
+        // Arguments with non-finite values, a value which strtod() reads as hexadecimal, and
+        // strings with quotes and control characters
+        rocblas_profile_args args;
+        args.add_text("rocblas_function", "rocblas_sgemm");
+        args.add_text("transA", "N");
+        args.add_text("transB", "T");
+        args.add_number("M", 64, "64");
+        args.add_number("N", 32, "32");
+        args.add_number("K", 16, "16");
+        args.add_number("alpha", NAN, "nan");
+        args.add_number("beta", INFINITY, "inf");
+        args.add_number("lda", 64, "0x40");
+        args.add_text("name", "tab\there, \"quoted\"\x01\n");
+
+        rocblas_profile_timing timing;
+        timing.count = 4;
+        timing.min   = 1;
+        timing.p50   = 2;
+        timing.p99   = 3;
+        timing.max   = 3;
+        timing.total = 8;
+
+        rocblas_internal_ostream os;
+        rocblas_profile_print(os, rocblas_profile_format::json, args, 10, timing);
+        std::string line = os.str();
+
+        ASSERT_FALSE(line.empty());
+        EXPECT_EQ(line.back(), '\n');
+        line.pop_back();
+        EXPECT_EQ(line.find('\n'), std::string::npos) << "One object per line: " << line;
+        ASSERT_TRUE(parse(line, members)) << "Invalid JSON: " << line;
+
+        EXPECT_EQ(members["rocblas_function"], "\"rocblas_sgemm\"");
+        EXPECT_EQ(members["call_count"], "10");
+        EXPECT_EQ(members["timed_calls"], "4");
+
+        // gemm of 64x32x16 does 2 * 64 * 32 * 16 flops, and with beta nonzero reads and writes C
+        double gflop = 2.0 * 64 * 32 * 16 / 1e9;
+        double gbyte = 4.0 * (64 * 16 + 16 * 32 + 2 * 64 * 32) / 1e9;
+        EXPECT_NEAR(std::stod(members["gflop"]), gflop, gflop * 1e-5);
+        EXPECT_NEAR(std::stod(members["gbyte"]), gbyte, gbyte * 1e-5);
+
+        // 4 timed calls in 8 us
+        EXPECT_NEAR(std::stod(members["achieved_gflops"]), gflop * 4 / 8e-6, gflop * 1e1);
+        EXPECT_NEAR(std::stod(members["achieved_gbps"]), gbyte * 4 / 8e-6, gbyte * 1e1);
+
+        std::map<std::string, std::string> arguments;
+        ASSERT_TRUE(parse(members["arguments"], arguments));
+        EXPECT_EQ(arguments["M"], "64");
+        EXPECT_EQ(arguments["alpha"], "\"nan\"");
+        EXPECT_EQ(arguments["beta"], "\"inf\"");
+        EXPECT_EQ(arguments["lda"], "\"0x40\"");
+        EXPECT_EQ(arguments["name"], "\"tab\\u0009here, \\\"quoted\\\"\\u0001\\u000a\"");
+    }
+
+    template <typename...>
+    struct logging_profile_json_testing : rocblas_test_valid
+    {
+        void operator()(const Arguments& arg)
+        {
+            if(!strcmp(arg.function, "logging_profile_json"))
+                testing_logging_profile_json(arg);
+            else
+                FAIL() << "Internal error: Test called with unknown function: " << arg.function;
+        }
+    };
+
+    struct logging_profile_json : RocBLAS_Test<logging_profile_json, logging_profile_json_testing>
+    {
+        // Filter for which types apply to this suite
+        static bool type_filter(const Arguments& arg)
+        {
+            return true;
+        }
+
+        // Filter for which functions apply to this suite
+        static bool function_filter(const Arguments& arg)
+        {
+            return !strcmp(arg.function, "logging_profile_json");
+        }
+
+        // Google Test name suffix based on parameters
+        static std::string name_suffix(const Arguments& arg)
+        {
+            return RocBLAS_TestName<logging_profile_json>(arg.name);
+        }
+    };
+
+    TEST_P(logging_profile_json, auxiliary)
+    {
+        CATCH_SIGNALS_AND_EXCEPTIONS_AS_FAILURES(
+            rocblas_simple_dispatch<logging_profile_json_testing>(GetParam()));
+    }
+    INSTANTIATE_TEST_CATEGORIES(logging_profile_json);
+
 } // namespace
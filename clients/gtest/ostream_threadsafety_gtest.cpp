@@ -34,6 +34,8 @@ namespace
         {
             if(!strcmp(arg.function, "ostream_threadsafety"))
                 testing_ostream_threadsafety(arg);
+            else if(!strcmp(arg.function, "ostream_queue_drop"))
+                testing_ostream_queue_drop(arg);
             else
                 FAIL() << "Internal error: Test called with unknown function: " << arg.function;
         }
@@ -50,7 +52,8 @@ namespace
         // Filter for which functions apply to this suite
         static bool function_filter(const Arguments& arg)
         {
-            return !strcmp(arg.function, "ostream_threadsafety");
+            return !strcmp(arg.function, "ostream_threadsafety")
+                   || !strcmp(arg.function, "ostream_queue_drop");
         }
 
         // Google Test name suffix based on parameters
@@ -0,0 +1,75 @@
+/* ************************************************************************
+ * Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell cop-
+ * ies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM-
+ * PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNE-
+ * CTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ************************************************************************ */
+
+#include "rocblas_arguments.hpp"
+#include "rocblas_gentest.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Command line front end of rocblas_gentest(), with the options of rocblas_gentest.py which it
+// supports, so that the test can compare the data files which they write
+int main(int argc, char** argv)
+{
+    std::string              infile, outfile, template_file;
+    std::vector<std::string> include_dirs;
+
+    for(int i = 1; i < argc; ++i)
+    {
+        if(!strncmp(argv[i], "-I", 2) && (argv[i][2] || i + 1 < argc))
+        {
+            include_dirs.push_back(argv[i][2] ? argv[i] + 2 : argv[++i]);
+            continue;
+        }
+
+        bool out = !strcmp(argv[i], "-o") || !strcmp(argv[i], "--out");
+        if(out || !strcmp(argv[i], "-t") || !strcmp(argv[i], "--template"))
+        {
+            if(i + 1 == argc || !argv[i + 1][0])
+            {
+                rocblas_cerr << "The " << argv[i] << " option requires an argument" << std::endl;
+                return EXIT_FAILURE;
+            }
+            (out ? outfile : template_file) = argv[++i];
+        }
+        else if(infile == "" && argv[i][0] != '-')
+        {
+            infile = argv[i];
+        }
+        else
+        {
+            outfile = "";
+            break;
+        }
+    }
+
+    if(infile == "" || outfile == "")
+    {
+        rocblas_cerr << "Usage: " << argv[0]
+                     << " [ -t <template> ] [ -I <dir> ... ] -o <output> <yaml>" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    rocblas_gentest(infile, outfile, template_file, include_dirs);
+    return EXIT_SUCCESS;
+}
@@ -22,6 +22,7 @@
 
 #include <string>
 
+#include "cblas_backend.hpp"
 #include "rocblas_data.hpp"
 #include "rocblas_parse_data.hpp"
 #include "rocblas_test.hpp"
@@ -280,6 +281,14 @@ int main(int argc, char** argv)
 
     rocblas_print_version();
 
+    // Run the tests in worker processes with --parallel, and report their merged results
+    int status;
+    if(rocblas_test_parallel(argc, argv, status))
+    {
+        rocblas_print_args(args);
+        return status;
+    }
+
     // Set test device
     rocblas_set_test_device();
 
@@ -288,6 +297,9 @@ int main(int argc, char** argv)
     // Set data file path
     rocblas_parse_data(argc, argv, rocblas_exepath() + "rocblas_gtest.data");
 
+    // Select the host reference BLAS now so a missing library fails before any test runs
+    rocblas_cout << cblas_backend_banner() << "\n" << std::endl;
+
     // Initialize Google Tests
     testing::InitGoogleTest(&argc, argv);
 
@@ -297,8 +309,11 @@ int main(int argc, char** argv)
     // Set Google Test listener
     rocblas_set_listener();
 
+    // Record the results for the parent process when running as a worker
+    rocblas_test_worker_listener();
+
     // Run the tests
-    int status = RUN_ALL_TESTS();
+    status = RUN_ALL_TESTS();
 
     // Failures printed at end for reporting so repeat version info
     rocblas_print_version();
@@ -0,0 +1,435 @@
+/* ************************************************************************
+ * Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell cop-
+ * ies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM-
+ * PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNE-
+ * CTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ************************************************************************ */
+
+/*
+ * Parallel runs of rocblas-test
+ *
+ * With --parallel <W>, rocblas-test runs the tests in W worker processes per device instead of
+ * running them itself. Each worker is the same executable with the same options, plus
+ * --worker <i>/<N>, so that it only instantiates the tests which the schedule of RocBLAS_TestData
+ * assigns to it; the schedule balances the tests by their cost estimated from flops.hpp and
+ * bytes.hpp. Each worker only sees its own device, through HIP_VISIBLE_DEVICES. With
+ * --devices <D>, D mock devices are used instead of the visible devices, and the workers are not
+ * bound to a device, e.g. to spread suites which mostly run on the host.
+ *
+ * The workers record their results in files, which the parent merges into one summary.
+ */
+
+#include "rocblas_test.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if __has_include(<filesystem>)
+#include <filesystem>
+namespace fs = std::filesystem;
+#elif __has_include(<experimental/filesystem>)
+#include <experimental/filesystem>
+namespace fs = std::experimental::filesystem;
+#else
+#error no filesystem found
+#endif
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+#endif
+
+namespace
+{
+    // Environment variable naming the file in which a worker records its results
+    constexpr char c_results_env[] = "ROCBLAS_TEST_WORKER_RESULTS";
+
+    // Records the start and the result of each test, one line each, so that the test which was
+    // running is known if the worker dies
+    class worker_listener : public testing::EmptyTestEventListener
+    {
+        FILE* const file;
+
+        void record(const char* what, long long ms, const testing::TestInfo& info)
+        {
+            fprintf(file, "%s %lld %s.%s\n", what, ms, info.test_suite_name(), info.name());
+            fflush(file);
+        }
+
+    public:
+        explicit worker_listener(FILE* file)
+            : file(file)
+        {
+        }
+
+        ~worker_listener() override
+        {
+            fclose(file);
+        }
+
+        void OnTestStart(const testing::TestInfo& info) override
+        {
+            record("STARTED", 0, info);
+        }
+
+        void OnTestEnd(const testing::TestInfo& info) override
+        {
+            const testing::TestResult* result = info.result();
+            record(result->Failed()    ? "FAILED"
+                   : result->Skipped() ? "SKIPPED"
+                                       : "PASSED",
+                   result->elapsed_time(),
+                   info);
+        }
+    };
+
+#ifndef WIN32
+    struct worker
+    {
+        std::string device; // empty when the worker is not bound to a device
+        std::string log, results;
+        pid_t       pid     = 0;
+        int         status  = 0;
+        double      seconds = 0; // since the start of the workers
+    };
+
+    // Results of the workers, merged
+    struct merged_results
+    {
+        size_t                   passed = 0, skipped = 0;
+        std::vector<std::string> failed;
+    };
+
+    // Inserts the worker number in the path of a --gtest_output or GTEST_OUTPUT value,
+    // <format>[:<path>], so that workers write their own reports. Without a path, Google Test
+    // writes test_detail.<format>, which becomes test_detail_worker<i>.<format>.
+    std::string worker_output(const std::string& value, size_t index)
+    {
+        size_t      colon  = value.find(':');
+        std::string format = value.substr(0, colon);
+        std::string path   = colon == std::string::npos ? "" : value.substr(colon + 1);
+        std::string suffix = "worker" + std::to_string(index);
+
+        if(path.empty())
+            return format + ":test_detail_" + suffix + "." + format;
+        if(path.back() == '/')
+            return format + ":" + path + suffix + "/";
+
+        size_t dot = path.rfind('.');
+        if(dot == std::string::npos || dot < path.rfind('/') + 1)
+            return format + ":" + path + "_" + suffix;
+        return format + ":" + path.substr(0, dot) + "_" + suffix + path.substr(dot);
+    }
+
+    // Devices of the workers, from HIP_VISIBLE_DEVICES or all of the devices
+    std::vector<std::string> visible_devices()
+    {
+        std::vector<std::string> devices;
+        const char*              visible = getenv("HIP_VISIBLE_DEVICES");
+        if(visible && *visible)
+        {
+            std::istringstream list(visible);
+            for(std::string id; std::getline(list, id, ',');)
+                if(!id.empty())
+                    devices.push_back(id);
+        }
+        else
+        {
+            int count = 0;
+            if(hipGetDeviceCount(&count) != hipSuccess)
+                count = 0;
+            for(int id = 0; id < count; ++id)
+                devices.push_back(std::to_string(id));
+        }
+        return devices;
+    }
+
+    // Starts worker index of count with the arguments args, its output going to its log
+    void spawn_worker(worker&                         w,
+                      size_t                          index,
+                      size_t                          count,
+                      const std::vector<std::string>& args,
+                      const std::string&              omp_threads)
+    {
+        std::vector<std::string> worker_args{args[0], "--worker"};
+        worker_args.push_back(std::to_string(index) + "/" + std::to_string(count));
+        for(size_t i = 1; i < args.size(); ++i)
+        {
+            if(args[i].compare(0, 15, "--gtest_output="))
+                worker_args.push_back(args[i]);
+            else
+                worker_args.push_back("--gtest_output=" + worker_output(args[i].substr(15), index));
+        }
+
+        // The environment, with the variables of the worker replacing those inherited
+        std::vector<std::string> env{std::string(c_results_env) + "=" + w.results};
+        if(!w.device.empty())
+            env.push_back("HIP_VISIBLE_DEVICES=" + w.device);
+        if(!omp_threads.empty())
+            env.push_back("OMP_NUM_THREADS=" + omp_threads);
+        const char* gtest_output = getenv("GTEST_OUTPUT");
+        if(gtest_output && *gtest_output)
+            env.push_back("GTEST_OUTPUT=" + worker_output(gtest_output, index));
+        size_t overrides = env.size();
+        for(char** e = environ; *e; ++e)
+        {
+            auto same_name = [&](const std::string& var) {
+                return !strncmp(*e, var.c_str(), var.find('=') + 1);
+            };
+            if(std::none_of(env.begin(), env.begin() + overrides, same_name))
+                env.push_back(*e);
+        }
+
+        std::vector<char*> argv_c, env_c;
+        for(auto& arg : worker_args)
+            argv_c.push_back(arg.data());
+        argv_c.push_back(nullptr);
+        for(auto& var : env)
+            env_c.push_back(var.data());
+        env_c.push_back(nullptr);
+
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_addopen(
+            &actions, STDOUT_FILENO, w.log.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO, STDERR_FILENO);
+
+        int err = posix_spawn(
+            &w.pid, "/proc/self/exe", &actions, nullptr, argv_c.data(), env_c.data());
+        posix_spawn_file_actions_destroy(&actions);
+        if(err)
+        {
+            rocblas_cerr << "rocblas-test: cannot start worker " << index << ": " << strerror(err)
+                         << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // Prints the output of worker index, and merges its results
+    void report_worker(const worker& w, size_t index, size_t count, merged_results& merged)
+    {
+        std::ifstream     log(w.log);
+        std::stringstream output;
+        output << log.rdbuf();
+
+        std::string worker_id = "worker " + std::to_string(index) + "/" + std::to_string(count);
+
+        size_t      tests   = 0;
+        long long   test_ms = 0;
+        std::string running; // test started without a result
+
+        std::ifstream results(w.results);
+        std::string   what, name;
+        long long     ms;
+        while(results >> what >> ms >> name)
+        {
+            if(what == "STARTED")
+            {
+                running = name;
+                continue;
+            }
+            running.clear();
+            tests++;
+            test_ms += ms;
+            if(what == "PASSED")
+                merged.passed++;
+            else if(what == "SKIPPED")
+                merged.skipped++;
+            else
+                merged.failed.push_back(name + " (" + worker_id + ")");
+        }
+
+        std::ostringstream exit_status;
+        if(WIFSIGNALED(w.status))
+            exit_status << "was terminated by signal " << WTERMSIG(w.status);
+        else
+            exit_status << "exited with status " << WEXITSTATUS(w.status);
+
+        // A test which started without a result is where the worker died
+        if(!running.empty())
+            merged.failed.push_back(running + " (" + worker_id + " " + exit_status.str() + ")");
+
+        rocblas_cout << "[  WORKER  ] " << index << "/" << count;
+        if(!w.device.empty())
+            rocblas_cout << " on device " << w.device;
+        rocblas_cout << " " << exit_status.str() << ": " << tests << " tests, " << test_ms
+                     << " ms in tests, " << w.seconds << " s\n"
+                     << output.str() << std::endl;
+    }
+#endif
+}
+
+void rocblas_test_worker_listener()
+{
+    const char* results = getenv(c_results_env);
+    if(!results)
+        return;
+
+    FILE* file = fopen(results, "w");
+    if(!file)
+    {
+        rocblas_cerr << "rocblas-test: cannot open " << results << ": " << strerror(errno)
+                     << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    testing::UnitTest::GetInstance()->listeners().Append(new worker_listener(file));
+}
+
+bool rocblas_test_parallel(int& argc, char** argv, int& status)
+{
+    // Scan, process and remove any --parallel or --devices options
+    int    per_device = 0, mock_devices = 0;
+    char** argv_p     = argv + 1;
+    for(int i = 1; i < argc; ++i)
+    {
+        if(!strcmp(argv[i], "--parallel") || !strcmp(argv[i], "--devices"))
+        {
+            int  value;
+            char extra;
+            if(!argv[i + 1] || sscanf(argv[i + 1], "%d%c", &value, &extra) != 1 || value < 1)
+            {
+                rocblas_cerr << "The " << argv[i] << " option requires a positive integer argument"
+                             << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            (strcmp(argv[i], "--parallel") ? mock_devices : per_device) = value;
+            ++i;
+        }
+        else
+            *argv_p++ = argv[i];
+    }
+    *argv_p = nullptr;
+    argc    = argv_p - argv;
+
+    if(!per_device && !mock_devices)
+        return false;
+    per_device = std::max(per_device, 1);
+
+#ifdef WIN32
+    rocblas_cerr << "rocblas-test: --parallel is not supported on Windows, running serially"
+                 << std::endl;
+    return false;
+#else
+    std::vector<std::string> devices
+        = mock_devices ? std::vector<std::string>(mock_devices) : visible_devices();
+    if(devices.empty())
+    {
+        rocblas_cerr << "rocblas-test: no devices found; use --devices to set a mock device count"
+                     << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // Workers are interleaved across the devices, so that any first few use different devices
+    size_t              count = devices.size() * per_device;
+    std::vector<worker> workers(count);
+
+    fs::path dir = fs::temp_directory_path() / ("rocblas-test-" + std::to_string(getpid()));
+    fs::create_directories(dir);
+
+    // Share the host threads between the workers, unless the user has chosen their number
+    std::string omp_threads;
+    if(!getenv("OMP_NUM_THREADS"))
+        omp_threads
+            = std::to_string(std::max<size_t>(std::thread::hardware_concurrency() / count, 1));
+
+    rocblas_cout << "rocblas-test: running the tests in " << count << " worker processes on "
+                 << devices.size() << (mock_devices ? " mock" : "") << " devices\n"
+                 << std::endl;
+
+    std::vector<std::string> args(argv, argv + argc);
+    std::map<pid_t, size_t>  running;
+    auto                     start   = std::chrono::steady_clock::now();
+    auto                     elapsed = [&] {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    for(size_t i = 0; i < count; ++i)
+    {
+        workers[i].device  = devices[i % devices.size()];
+        workers[i].log     = (dir / ("worker" + std::to_string(i) + ".log")).string();
+        workers[i].results = (dir / ("worker" + std::to_string(i) + ".results")).string();
+        spawn_worker(workers[i], i, count, args, omp_threads);
+        running[workers[i].pid] = i;
+    }
+
+    // Report each worker as it finishes
+    merged_results merged;
+    bool           worker_failed = false;
+    while(!running.empty())
+    {
+        int   wstatus;
+        pid_t pid = waitpid(-1, &wstatus, 0);
+        if(pid < 0)
+        {
+            if(errno == EINTR)
+                continue;
+            rocblas_cerr << "rocblas-test: waitpid failed: " << strerror(errno) << std::endl;
+            exit(EXIT_FAILURE);
+        }
+
+        auto it = running.find(pid);
+        if(it == running.end())
+            continue;
+
+        worker& w = workers[it->second];
+        w.status  = wstatus;
+        w.seconds = elapsed();
+        worker_failed |= !WIFEXITED(wstatus) || WEXITSTATUS(wstatus);
+        report_worker(w, it->second, count, merged);
+        running.erase(it);
+    }
+
+    double seconds = elapsed();
+    fs::remove_all(dir);
+
+    // Merged summary, in the format of the Google Test summary
+    size_t tests = merged.passed + merged.skipped + merged.failed.size();
+    rocblas_cout << "[==========] " << tests << " tests ran in " << count << " workers. ("
+                 << seconds << " s total)\n"
+                 << "[  PASSED  ] " << merged.passed << " tests.\n";
+    if(merged.skipped)
+        rocblas_cout << "[ SKIPPED  ] " << merged.skipped << " tests.\n";
+    if(!merged.failed.empty())
+    {
+        std::sort(merged.failed.begin(), merged.failed.end());
+        rocblas_cout << "[  FAILED  ] " << merged.failed.size() << " tests, listed below:\n";
+        for(const auto& name : merged.failed)
+            rocblas_cout << "[  FAILED  ] " << name << "\n";
+        rocblas_cout << "\n " << merged.failed.size() << " FAILED TESTS\n";
+    }
+    rocblas_cout << std::endl;
+
+    status = worker_failed || !merged.failed.empty();
+    return true;
+#endif
+}
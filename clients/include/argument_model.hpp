@@ -35,6 +35,14 @@ bool ArgumentModel_get_log_function_name();
 void ArgumentModel_set_log_datatype(bool d);
 bool ArgumentModel_get_log_datatype();
 
+// Per-call performance of the most recent log_perf, used by rocblas-bench --replay
+void ArgumentModel_set_last_perf(double gpu_us, double gflop, double gbyte);
+void ArgumentModel_get_last_perf(double& gpu_us, double& gflop, double& gbyte);
+
+// Appends the error statistics collected by the norm checks since the last line, if enabled
+void ArgumentModel_log_error_stats(rocblas_internal_ostream& name_line,
+                                   rocblas_internal_ostream& val_line);
+
 // ArgumentModel template has a variadic list of argument enums
 template <rocblas_argument... Args>
 class ArgumentModel
@@ -75,6 +83,11 @@ public:
         double rocblas_gflops = gflops * batch_count / gpu_us * 1e6;
         double rocblas_GBps   = gbytes * batch_count / gpu_us * 1e6;
 
+        ArgumentModel_set_last_perf(
+            gpu_us,
+            gflops != ArgumentLogging::NA_value ? gflops * batch_count : gflops,
+            gbytes != ArgumentLogging::NA_value ? gbytes * batch_count : gbytes);
+
         // append performance fields
         if(gflops != ArgumentLogging::NA_value)
         {
@@ -128,6 +141,7 @@ public:
                     name_line << ",norm_error_4";
                     val_line << "," << norm4;
                 }
+                ArgumentModel_log_error_stats(name_line, val_line);
             }
         }
     }
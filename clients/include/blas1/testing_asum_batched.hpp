@@ -165,10 +165,9 @@ void testing_asum_batched(const Arguments& arg)
         real_t<T> cpu_result[batch_count];
 
         cpu_time_used = get_time_us_no_sync();
-        for(int b = 0; b < batch_count; b++)
-        {
+        cblas_batched(batch_count, [&](int64_t b) {
             cblas_asum<T>(N, hx[b], incx, cpu_result + b);
-        }
+        });
         cpu_time_used = get_time_us_no_sync() - cpu_time_used;
 
         if(arg.pointer_mode_host)
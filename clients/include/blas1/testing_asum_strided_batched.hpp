@@ -170,10 +170,9 @@ void testing_asum_strided_batched(const Arguments& arg)
 
         // CPU BLAS
         cpu_time_used = get_time_us_no_sync();
-        for(int b = 0; b < batch_count; b++)
-        {
+        cblas_batched(batch_count, [&](int64_t b) {
             cblas_asum<T>(N, hx[b], incx, hr_gold + b);
-        }
+        });
         cpu_time_used = get_time_us_no_sync() - cpu_time_used;
 
         if(arg.pointer_mode_host)
@@ -121,10 +121,9 @@ void testing_copy_batched(const Arguments& arg)
 
         // CPU BLAS
         cpu_time_used = get_time_us_no_sync();
-        for(int b = 0; b < batch_count; ++b)
-        {
+        cblas_batched(batch_count, [&](int64_t b) {
             cblas_copy<T>(N, hx[b], incx, hy_gold[b], incy);
-        }
+        });
         cpu_time_used = get_time_us_no_sync() - cpu_time_used;
 
         if(arg.unit_check)
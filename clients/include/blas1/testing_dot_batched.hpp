@@ -210,10 +210,9 @@ void testing_dot_batched(const Arguments& arg)
 
         // CPU BLAS
         cpu_time_used = get_time_us_no_sync();
-        for(size_t b = 0; b < batch_count; ++b)
-        {
+        cblas_batched(batch_count, [&](int64_t b) {
             (CONJ ? cblas_dotc<T> : cblas_dot<T>)(N, hx[b], incx, hy_ptr[b], incy, &cpu_result[b]);
-        }
+        });
         cpu_time_used = get_time_us_no_sync() - cpu_time_used;
 
         // For large N, rocblas_half tends to diverge proportional to N
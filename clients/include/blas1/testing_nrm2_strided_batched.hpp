@@ -173,8 +173,9 @@ void testing_nrm2_strided_batched(const Arguments& arg)
         // CPU BLAS
         cpu_time_used = get_time_us_no_sync();
 
-        for(int b = 0; b < batch_count; b++)
+        cblas_batched(batch_count, [&](int64_t b) {
             cblas_nrm2<T>(N, hx[b], incx, cpu_result + b);
+        });
 
         cpu_time_used = get_time_us_no_sync() - cpu_time_used;
 
@@ -197,10 +197,9 @@ void testing_rot_batched(const Arguments& arg)
         }
 
         cpu_time_used = get_time_us_no_sync();
-        for(int b = 0; b < batch_count; b++)
-        {
+        cblas_batched(batch_count, [&](int64_t b) {
             cblas_rot<T, T, U, V>(N, hx_gold[b], incx, hy_gold[b], incy, hc, hs);
-        }
+        });
         cpu_time_used = get_time_us_no_sync() - cpu_time_used;
 
         if(arg.pointer_mode_host)
@@ -143,10 +143,9 @@ void testing_rotg_strided_batched(const Arguments& arg)
     hs_gold.copy_from(hs);
 
     cpu_time_used = get_time_us_no_sync();
-    for(size_t b = 0; b < batch_count; b++)
-    {
+    cblas_batched(batch_count, [&](int64_t b) {
         cblas_rotg<T, U>(ha_gold[b], hb_gold[b], hc_gold[b], hs_gold[b]);
-    }
+    });
     cpu_time_used = get_time_us_no_sync() - cpu_time_used;
 
     // Test rocblas_pointer_mode_host
@@ -196,10 +196,9 @@ void testing_rotm_strided_batched(const Arguments& arg)
             hy_gold.copy_from(hy);
 
             cpu_time_used = get_time_us_no_sync();
-            for(size_t b = 0; b < batch_count; b++)
-            {
+            cblas_batched(batch_count, [&](int64_t b) {
                 cblas_rotm<T>(N, hx_gold[b], incx, hy_gold[b], incy, hparam[b]);
-            }
+            });
             cpu_time_used = get_time_us_no_sync() - cpu_time_used;
 
             // Test rocblas_pointer_mode_host
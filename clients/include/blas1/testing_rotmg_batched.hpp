@@ -187,10 +187,9 @@ void testing_rotmg_batched(const Arguments& arg)
             hparams_gold.copy_from(hparams);
 
             cpu_time_used = get_time_us_no_sync();
-            for(size_t b = 0; b < batch_count; b++)
-            {
+            cblas_batched(batch_count, [&](int64_t b) {
                 cblas_rotmg<T>(hd1_gold[b], hd2_gold[b], hx_gold[b], hy_gold[b], hparams_gold[b]);
-            }
+            });
             cpu_time_used = get_time_us_no_sync() - cpu_time_used;
 
             if(arg.pointer_mode_host)
@@ -474,11 +474,10 @@ void testing_gbmv_batched(const Arguments& arg)
 
         // CPU BLAS
         cpu_time_used = get_time_us_no_sync();
-        for(int b = 0; b < batch_count; ++b)
-        {
+        cblas_batched(batch_count, [&](int64_t b) {
             cblas_gbmv<T>(
                 transA, M, N, KL, KU, h_alpha, hAb[b], lda, hx[b], incx, h_beta, hy_gold[b], incy);
-        }
+        });
         cpu_time_used = get_time_us_no_sync() - cpu_time_used;
 
         if(arg.pointer_mode_host)
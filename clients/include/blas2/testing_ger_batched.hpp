@@ -291,10 +291,9 @@ void testing_ger_batched(const Arguments& arg)
 
         // CPU BLAS
         cpu_time_used = get_time_us_no_sync();
-        for(int b = 0; b < batch_count; ++b)
-        {
+        cblas_batched(batch_count, [&](int64_t b) {
             cblas_ger<T, CONJ>(M, N, h_alpha, hx[b], incx, hy[b], incy, hA_gold[b], lda);
-        }
+        });
         cpu_time_used = get_time_us_no_sync() - cpu_time_used;
 
         // copy output from device to CPU
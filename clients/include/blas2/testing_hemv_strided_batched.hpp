@@ -438,8 +438,9 @@ void testing_hemv_strided_batched(const Arguments& arg)
         // CPU BLAS
         cpu_time_used = get_time_us_no_sync();
 
-        for(int b = 0; b < batch_count; b++)
+        cblas_batched(batch_count, [&](int64_t b) {
             cblas_hemv<T>(uplo, N, h_alpha, hA[b], lda, hx[b], incx, h_beta, hy_gold[b], incy);
+        });
 
         cpu_time_used = get_time_us_no_sync() - cpu_time_used;
 
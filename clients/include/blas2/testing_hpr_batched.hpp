@@ -226,10 +226,9 @@ void testing_hpr_batched(const Arguments& arg)
 
         // CPU BLAS
         cpu_time_used = get_time_us_no_sync();
-        for(int i = 0; i < batch_count; i++)
-        {
+        cblas_batched(batch_count, [&](int64_t i) {
             cblas_hpr<T>(uplo, N, h_alpha, hx[i], incx, hAp_gold[i]);
-        }
+        });
         cpu_time_used = get_time_us_no_sync() - cpu_time_used;
 
         // copy output from device to CPU
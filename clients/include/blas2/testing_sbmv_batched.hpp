@@ -405,11 +405,10 @@ void testing_sbmv_batched(const Arguments& arg)
 
         cpu_time_used = get_time_us_no_sync();
         // cpu reference
-        for(int b = 0; b < batch_count; b++)
-        {
+        cblas_batched(batch_count, [&](int64_t b) {
             cblas_sbmv<T>(
                 uplo, N, K, alpha[0], hAb[b], lda, hx[b], incx, beta[0], hy_gold[b], incy);
-        }
+        });
         cpu_time_used = get_time_us_no_sync() - cpu_time_used;
 
         if(arg.pointer_mode_host)
@@ -398,10 +398,9 @@ void testing_spmv_strided_batched(const Arguments& arg)
         // cpu reference
         cpu_time_used = get_time_us_no_sync();
 
-        for(int b = 0; b < batch_count; b++)
-        {
+        cblas_batched(batch_count, [&](int64_t b) {
             cblas_spmv<T>(uplo, N, alpha[0], hAp[b], hx[b], incx, beta[0], hy_gold[b], incy);
-        }
+        });
 
         cpu_time_used = get_time_us_no_sync() - cpu_time_used;
 
@@ -443,10 +443,9 @@ void testing_symv_strided_batched(const Arguments& arg)
         // cpu reference
         cpu_time_used = get_time_us_no_sync();
 
-        for(int b = 0; b < batch_count; b++)
-        {
+        cblas_batched(batch_count, [&](int64_t b) {
             cblas_symv<T>(uplo, N, alpha[0], hA[b], lda, hx[b], incx, beta[0], hy_gold[b], incy);
-        }
+        });
 
         cpu_time_used = get_time_us_no_sync() - cpu_time_used;
 
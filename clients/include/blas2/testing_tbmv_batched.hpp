@@ -198,8 +198,9 @@ void testing_tbmv_batched(const Arguments& arg)
 
         // CPU BLAS
         cpu_time_used = get_time_us_no_sync();
-        for(int b = 0; b < batch_count; b++)
+        cblas_batched(batch_count, [&](int64_t b) {
             cblas_tbmv<T>(uplo, transA, diag, N, K, hAb[b], lda, hx_gold[b], incx);
+        });
 
         cpu_time_used = get_time_us_no_sync() - cpu_time_used;
 
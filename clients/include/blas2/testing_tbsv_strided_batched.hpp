@@ -212,10 +212,9 @@ void testing_tbsv_strided_batched(const Arguments& arg)
     hb.copy_from(hx);
 
     // Calculate hb = hA*hx;
-    for(int b = 0; b < batch_count; b++)
-    {
+    cblas_batched(batch_count, [&](int64_t b) {
         cblas_tbmv<T>(uplo, transA, diag, N, K, hAb[b], lda, hb[b], incx);
-    }
+    });
 
     cpu_x_or_b.copy_from(hb);
     hx_or_b.copy_from(hb);
@@ -258,10 +257,9 @@ void testing_tbsv_strided_batched(const Arguments& arg)
             trsm_err_res_check<T>(max_err, N, error_eps_multiplier, eps);
 
         // hx_or_b contains A * (calculated X), so res = A * (calculated x) - b = hx_or_b - hb
-        for(int b = 0; b < batch_count; b++)
-        {
+        cblas_batched(batch_count, [&](int64_t b) {
             cblas_tbmv<T>(uplo, transA, diag, N, K, hAb[b], lda, hx_or_b[b], incx);
-        }
+        });
 
         //calculate norm 1 of res
         max_err_res = vector_norm_1<T>(N, incx, hx_or_b, hb);
@@ -317,8 +315,9 @@ void testing_tbsv_strided_batched(const Arguments& arg)
         cpu_time_used = get_time_us_no_sync();
 
         if(arg.norm_check)
-            for(int b = 0; b < batch_count; b++)
+            cblas_batched(batch_count, [&](int64_t b) {
                 cblas_tbsv<T>(uplo, transA, diag, N, K, hAb[b], lda, cpu_x_or_b[b], incx);
+            });
 
         cpu_time_used = get_time_us_no_sync() - cpu_time_used;
 
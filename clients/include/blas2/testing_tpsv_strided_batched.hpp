@@ -178,10 +178,9 @@ void testing_tpsv_strided_batched(const Arguments& arg)
     hb.copy_from(hx);
 
     // Calculate hb = hA*hx;
-    for(int b = 0; b < batch_count; b++)
-    {
+    cblas_batched(batch_count, [&](int64_t b) {
         cblas_trmv<T>(uplo, transA, diag, N, hA[b], N, hb[b], incx);
-    }
+    });
 
     // helper function to convert Regular matrix `hA` to packed matrix `hAp`
     regular_to_packed(uplo == rocblas_fill_upper, hA, hAp, N);
@@ -215,10 +214,9 @@ void testing_tpsv_strided_batched(const Arguments& arg)
             trsm_err_res_check<T>(max_err, N, error_eps_multiplier, eps);
 
         // hx_or_b contains A * (calculated X), so res = A * (calculated x) - b = hx_or_b - hb
-        for(int b = 0; b < batch_count; b++)
-        {
+        cblas_batched(batch_count, [&](int64_t b) {
             cblas_trmv<T>(uplo, transA, diag, N, hA[b], N, hx_or_b[b], incx);
-        }
+        });
 
         //calculate norm 1 of res
         max_res = vector_norm_1(N, incx, hx_or_b, hb);
@@ -270,8 +268,9 @@ void testing_tpsv_strided_batched(const Arguments& arg)
         cpu_time_used = get_time_us_no_sync();
 
         if(arg.norm_check)
-            for(int b = 0; b < batch_count; b++)
+            cblas_batched(batch_count, [&](int64_t b) {
                 cblas_tpsv<T>(uplo, transA, diag, N, hAp[b], cpu_x_or_b[b], incx);
+            });
 
         cpu_time_used = get_time_us_no_sync() - cpu_time_used;
 
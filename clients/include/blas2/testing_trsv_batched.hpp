@@ -182,11 +182,10 @@ void testing_trsv_batched(const Arguments& arg)
 
     hb.copy_from(hx);
 
-    for(int b = 0; b < batch_count; b++)
-    {
+    cblas_batched(batch_count, [&](int64_t b) {
         // Calculate hb = hA*hx;
         cblas_trmv<T>(uplo, transA, diag, N, hA[b], lda, hb[b], incx);
-    }
+    });
 
     cpu_x_or_b.copy_from(hb);
     hx_or_b.copy_from(hb);
@@ -278,8 +277,9 @@ void testing_trsv_batched(const Arguments& arg)
                 trsm_err_res_check<T>(error_host, N, error_eps_multiplier, eps);
 
             // hx_or_b contains A * (calculated X), so res = A * (calculated x) - b = hx_or_b - hb
-            for(int b = 0; b < batch_count; b++)
+            cblas_batched(batch_count, [&](int64_t b) {
                 cblas_trmv<T>(uplo, transA, diag, N, hA[b], lda, hx_or_b[b], incx);
+            });
 
             auto error_host_res = vector_norm_1(N, incx, hx_or_b, hb);
 
@@ -296,8 +296,9 @@ void testing_trsv_batched(const Arguments& arg)
             if(arg.unit_check)
                 trsm_err_res_check<T>(error_device, N, error_eps_multiplier, eps);
 
-            for(int b = 0; b < batch_count; b++)
+            cblas_batched(batch_count, [&](int64_t b) {
                 cblas_trmv<T>(uplo, transA, diag, N, hA[b], lda, hx_or_b[b], incx);
+            });
 
             auto error_device_res = vector_norm_1(N, incx, hx_or_b, hb);
 
@@ -351,8 +352,9 @@ void testing_trsv_batched(const Arguments& arg)
         cpu_time_used = get_time_us_no_sync();
 
         if(arg.norm_check)
-            for(int b = 0; b < batch_count; b++)
+            cblas_batched(batch_count, [&](int64_t b) {
                 cblas_trsv<T>(uplo, transA, diag, N, hA[b], lda, cpu_x_or_b[b], incx);
+            });
 
         cpu_time_used = get_time_us_no_sync() - cpu_time_used;
 
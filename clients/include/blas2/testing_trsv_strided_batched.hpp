@@ -194,10 +194,9 @@ void testing_trsv_strided_batched(const Arguments& arg)
     hb.copy_from(hx);
 
     // Calculate hb = hA*hx;
-    for(int b = 0; b < batch_count; b++)
-    {
+    cblas_batched(batch_count, [&](int64_t b) {
         cblas_trmv<T>(uplo, transA, diag, N, hA[b], lda, hb + stride_x * b, incx);
-    }
+    });
 
     cpu_x_or_b.copy_from(hb);
     hx_or_b.copy_from(hb);
@@ -289,8 +288,9 @@ void testing_trsv_strided_batched(const Arguments& arg)
             if(arg.unit_check)
                 trsm_err_res_check<T>(error_host, N, error_eps_multiplier, eps);
 
-            for(int b = 0; b < batch_count; b++)
+            cblas_batched(batch_count, [&](int64_t b) {
                 cblas_trmv<T>(uplo, transA, diag, N, hA[b], lda, hx_or_b[b], incx);
+            });
 
             auto error_host_res = vector_norm_1(N, incx, hx_or_b, hb);
             if(arg.unit_check)
@@ -306,8 +306,9 @@ void testing_trsv_strided_batched(const Arguments& arg)
             if(arg.unit_check)
                 trsm_err_res_check<T>(error_host, N, error_eps_multiplier, eps);
 
-            for(int b = 0; b < batch_count; b++)
+            cblas_batched(batch_count, [&](int64_t b) {
                 cblas_trmv<T>(uplo, transA, diag, N, hA[b], lda, hx_or_b[b], incx);
+            });
 
             auto error_device_res = vector_norm_1(N, incx, hx_or_b, hb);
             if(arg.unit_check)
@@ -364,8 +365,9 @@ void testing_trsv_strided_batched(const Arguments& arg)
         cpu_time_used = get_time_us_no_sync();
 
         if(arg.norm_check)
-            for(int b = 0; b < batch_count; b++)
+            cblas_batched(batch_count, [&](int64_t b) {
                 cblas_trsv<T>(uplo, transA, diag, N, hA[b], lda, cpu_x_or_b[b], incx);
+            });
 
         cpu_time_used = get_time_us_no_sync() - cpu_time_used;
 
@@ -562,8 +562,7 @@ void testing_geam_strided_batched(const Arguments& arg)
         // reference calculation for golden result
         cpu_time_used = get_time_us_no_sync();
 
-        for(size_t b = 0; b < batch_count; b++)
-        {
+        cblas_batched(batch_count, [&](int64_t b) {
             cblas_geam(transA,
                        transB,
                        M,
@@ -576,7 +575,7 @@ void testing_geam_strided_batched(const Arguments& arg)
                        ldb,
                        hC_gold[b],
                        ldc);
-        }
+        });
 
         cpu_time_used = get_time_us_no_sync() - cpu_time_used;
 
@@ -647,8 +646,7 @@ void testing_geam_strided_batched(const Arguments& arg)
                 CHECK_HIP_ERROR(dA.transfer_from(hA));
 
                 // reference calculation
-                for(int b = 0; b < batch_count; b++)
-                {
+                cblas_batched(batch_count, [&](int64_t b) {
                     cblas_geam(transA,
                                transB,
                                M,
@@ -661,7 +659,7 @@ void testing_geam_strided_batched(const Arguments& arg)
                                ldb,
                                hC_gold[b],
                                ldc);
-                }
+                });
 
                 if(arg.unit_check)
                 {
@@ -711,8 +709,7 @@ void testing_geam_strided_batched(const Arguments& arg)
 
                 CHECK_HIP_ERROR(hC.transfer_from(dC_in_place));
                 // reference calculation
-                for(int b = 0; b < batch_count; b++)
-                {
+                cblas_batched(batch_count, [&](int64_t b) {
                     cblas_geam(transA,
                                transB,
                                M,
@@ -725,7 +722,7 @@ void testing_geam_strided_batched(const Arguments& arg)
                                ldb,
                                hC_gold[b],
                                ldc);
-                }
+                });
 
                 if(arg.unit_check)
                 {
@@ -32,6 +32,7 @@
 #include "rocblas_math.hpp"
 #include "rocblas_matrix.hpp"
 #include "rocblas_random.hpp"
+#include "rocblas_reference_cache.hpp"
 #include "rocblas_test.hpp"
 #include "rocblas_vector.hpp"
 #include "unit.hpp"
@@ -356,7 +357,17 @@ void testing_gemm(const Arguments& arg)
             cpu_time_used = get_time_us_no_sync();
         }
 
-        cblas_gemm<T>(transA, transB, M, N, K, h_alpha, hA, lda, hB, ldb, h_beta, hC_gold, ldc);
+        rocblas_cached_reference(
+            arg,
+            "cblas_gemm",
+            {rocblas_reference_span_of(hA),
+             rocblas_reference_span_of(hB),
+             rocblas_reference_span_of(hC_gold)},
+            [&] {
+                cblas_gemm<T>(
+                    transA, transB, M, N, K, h_alpha, hA, lda, hB, ldb, h_beta, hC_gold, ldc);
+            },
+            hC_gold);
 
         if(arg.timing)
         {
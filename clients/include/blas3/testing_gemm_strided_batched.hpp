@@ -32,6 +32,7 @@
 #include "rocblas_math.hpp"
 #include "rocblas_matrix.hpp"
 #include "rocblas_random.hpp"
+#include "rocblas_reference_cache.hpp"
 #include "rocblas_test.hpp"
 #include "rocblas_vector.hpp"
 #include "unit.hpp"
@@ -440,11 +441,30 @@ void testing_gemm_strided_batched(const Arguments& arg)
 
         // CPU BLAS
         cpu_time_used = get_time_us_no_sync();
-        for(rocblas_int b = 0; b < batch_count; b++)
-        {
-            cblas_gemm<T>(
-                transA, transB, M, N, K, h_alpha, hA[b], lda, hB[b], ldb, h_beta, hC_gold[b], ldc);
-        }
+        rocblas_cached_reference(
+            arg,
+            "cblas_gemm",
+            {rocblas_reference_span_of(hA),
+             rocblas_reference_span_of(hB),
+             rocblas_reference_span_of(hC_gold)},
+            [&] {
+                cblas_batched(batch_count, [&](int64_t b) {
+                    cblas_gemm<T>(transA,
+                                  transB,
+                                  M,
+                                  N,
+                                  K,
+                                  h_alpha,
+                                  hA[b],
+                                  lda,
+                                  hB[b],
+                                  ldb,
+                                  h_beta,
+                                  hC_gold[b],
+                                  ldc);
+                });
+            },
+            hC_gold);
         cpu_time_used = get_time_us_no_sync() - cpu_time_used;
 
         if(arg.pointer_mode_host)
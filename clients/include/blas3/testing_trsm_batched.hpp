@@ -386,11 +386,10 @@ void testing_trsm_batched(const Arguments& arg)
 
     copy_matrix_with_different_leading_dimensions(hX, hB);
 
-    for(int b = 0; b < batch_count; b++)
-    {
+    cblas_batched(batch_count, [&](int64_t b) {
         // Calculate hB = hA*hX
         cblas_trmm<T>(side, uplo, transA, diag, M, N, 1.0 / alpha_h, hA[b], lda, hB[b], M);
-    }
+    });
 
     copy_matrix_with_different_leading_dimensions(hB, hXorB_1);
 
@@ -675,8 +674,9 @@ void testing_trsm_batched(const Arguments& arg)
         // CPU cblas
         cpu_time_used = get_time_us_no_sync();
 
-        for(int b = 0; b < batch_count; b++)
+        cblas_batched(batch_count, [&](int64_t b) {
             cblas_trsm<T>(side, uplo, transA, diag, M, N, alpha_h, hA[b], lda, hXorB_1[b], ldb);
+        });
 
         cpu_time_used = get_time_us_no_sync() - cpu_time_used;
 
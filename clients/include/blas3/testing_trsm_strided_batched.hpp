@@ -507,8 +507,9 @@ void testing_trsm_strided_batched(const Arguments& arg)
     hB.copy_from(hX);
 
     // Calculate hB = hA*hX;
-    for(int b = 0; b < batch_count; b++)
+    cblas_batched(batch_count, [&](int64_t b) {
         cblas_trmm<T>(side, uplo, transA, diag, M, N, 1.0 / alpha_h, hA[b], lda, hB[b], ldb);
+    });
 
     hXorB_1.copy_from(hB);
 
@@ -796,8 +797,9 @@ void testing_trsm_strided_batched(const Arguments& arg)
         // CPU cblas
         cpu_time_used = get_time_us_no_sync();
 
-        for(int b = 0; b < batch_count; b++)
+        cblas_batched(batch_count, [&](int64_t b) {
             cblas_trsm<T>(side, uplo, transA, diag, M, N, alpha_h, hA[b], lda, hB[b], ldb);
+        });
 
         cpu_time_used = get_time_us_no_sync() - cpu_time_used;
 
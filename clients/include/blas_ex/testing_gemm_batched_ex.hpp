@@ -531,8 +531,7 @@ void testing_gemm_batched_ex(const Arguments& arg)
         // CPU BLAS
         cpu_time_used = get_time_us_no_sync();
 
-        for(rocblas_int b = 0; b < batch_count; b++)
-        {
+        cblas_batched(batch_count, [&](int64_t b) {
             cblas_gemm<Ti, To_hpa>(transA,
                                    transB,
                                    M,
@@ -546,7 +545,7 @@ void testing_gemm_batched_ex(const Arguments& arg)
                                    h_beta_Tc,
                                    hD_gold[b],
                                    ldd);
-        }
+        });
 
         cpu_time_used = get_time_us_no_sync() - cpu_time_used;
 
@@ -551,8 +551,7 @@ void testing_gemm_strided_batched_ex(const Arguments& arg)
         cpu_time_used = get_time_us_no_sync();
 
         // CPU BLAS
-        for(rocblas_int b = 0; b < batch_count; b++)
-        {
+        cblas_batched(batch_count, [&](int64_t b) {
             cblas_gemm<Ti, To_hpa>(
                 transA,
                 transB,
@@ -570,7 +569,7 @@ void testing_gemm_strided_batched_ex(const Arguments& arg)
                 alt ? (alt_round ? rocblas_bfloat16::rocblas_truncate_t::rocblas_round_near_zero
                                  : rocblas_bfloat16::rocblas_truncate_t::rocblas_truncate)
                     : rocblas_bfloat16::rocblas_truncate_t::rocblas_round_near_even);
-        }
+        });
 
         cpu_time_used = get_time_us_no_sync() - cpu_time_used;
 
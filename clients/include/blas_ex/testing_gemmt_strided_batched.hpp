@@ -606,8 +606,7 @@ void testing_gemmt_strided_batched(const Arguments& arg)
         cpu_time_used = get_time_us_no_sync();
 
         // cpu reference
-        for(int b = 0; b < batch_count; b++)
-        {
+        cblas_batched(batch_count, [&](int64_t b) {
             cblas_gemmt<T>(uplo,
                            transA,
                            transB,
@@ -621,7 +620,7 @@ void testing_gemmt_strided_batched(const Arguments& arg)
                            h_beta[0],
                            hC_gold[b],
                            ldc);
-        }
+        });
 
         cpu_time_used = get_time_us_no_sync() - cpu_time_used;
 
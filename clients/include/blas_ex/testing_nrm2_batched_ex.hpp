@@ -221,10 +221,9 @@ void testing_nrm2_batched_ex(const Arguments& arg)
 
         // CPU BLAS
         cpu_time_used = get_time_us_no_sync();
-        for(int b = 0; b < batch_count; b++)
-        {
+        cblas_batched(batch_count, [&](int64_t b) {
             cblas_nrm2<Tx>(N, hx[b], incx, cpu_result + b);
-        }
+        });
         cpu_time_used = get_time_us_no_sync() - cpu_time_used;
 
         double abs_result = cpu_result[0] > 0 ? cpu_result[0] : -cpu_result[0];
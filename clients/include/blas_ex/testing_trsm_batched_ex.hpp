@@ -369,11 +369,10 @@ void testing_trsm_batched_ex(const Arguments& arg)
 
     hB.copy_from(hX);
 
-    for(int b = 0; b < batch_count; b++)
-    {
+    cblas_batched(batch_count, [&](int64_t b) {
         // Calculate hB = hA*hX;
         cblas_trmm<T>(side, uplo, transA, diag, M, N, 1.0 / alpha_h, hA[b], lda, hB[b], ldb);
-    }
+    });
 
     hXorB_1.copy_from(hB);
     hXorB_2.copy_from(hB);
@@ -610,10 +609,9 @@ void testing_trsm_batched_ex(const Arguments& arg)
         // CPU cblas
         cpu_time_used = get_time_us_no_sync();
 
-        for(int b = 0; b < batch_count; b++)
-        {
+        cblas_batched(batch_count, [&](int64_t b) {
             cblas_trsm<T>(side, uplo, transA, diag, M, N, alpha_h, hA[b], lda, cpuXorB[b], ldb);
-        }
+        });
 
         cpu_time_used = get_time_us_no_sync() - cpu_time_used;
 
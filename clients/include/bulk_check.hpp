@@ -0,0 +1,224 @@
+/* ************************************************************************
+ * Copyright (C) 2018-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell cop-
+ * ies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM-
+ * PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNE-
+ * CTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ************************************************************************ */
+
+#pragma once
+
+#include "rocblas.h"
+#include "rocblas_math.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+/*!\file
+ * \brief Bulk comparison of a CPU reference with a GPU result, used by UNIT_CHECK and NEAR_CHECK.
+ *
+ * All elements are compared, in parallel over the columns of all batches, and the outcome is
+ * collected in a rocblas_check_summary instead of stopping at the first mismatch, so a failing
+ * check reports one gtest failure with the number of mismatches, the largest errors and where the
+ * first mismatches are. A NaN in the reference must be matched by a NaN in the result; any other
+ * element must satisfy the predicate of the check.
+ */
+
+// Number of mismatching elements whose coordinates and values are reported
+constexpr size_t rocblas_check_reported = 10;
+
+struct rocblas_check_failure
+{
+    int64_t batch, row, col;
+    double  cpu[2], gpu[2]; // real and imaginary parts
+};
+
+struct rocblas_check_summary
+{
+    int64_t                            elements      = 0;
+    int64_t                            mismatches    = 0;
+    double                             max_abs_error = 0;
+    double                             max_rel_error = 0;
+    bool                               complex       = false;
+    int                                digits        = 9;
+    std::vector<rocblas_check_failure> failures; // the first mismatches in storage order
+
+    // Adds another summary, whose batch numbers are relative to batch
+    void merge(const rocblas_check_summary& other, int64_t batch = 0)
+    {
+        elements += other.elements;
+        mismatches += other.mismatches;
+        if(other.max_abs_error > max_abs_error)
+            max_abs_error = other.max_abs_error;
+        if(other.max_rel_error > max_rel_error)
+            max_rel_error = other.max_rel_error;
+        complex = complex || other.complex;
+        digits  = std::max(digits, other.digits);
+
+        for(rocblas_check_failure failure : other.failures)
+        {
+            failure.batch += batch;
+            failures.push_back(failure);
+        }
+        std::sort(failures.begin(), failures.end(), [](const auto& a, const auto& b) {
+            return std::tie(a.batch, a.col, a.row) < std::tie(b.batch, b.col, b.row);
+        });
+        if(failures.size() > rocblas_check_reported)
+            failures.resize(rocblas_check_reported);
+    }
+
+    std::string str() const
+    {
+        std::ostringstream os;
+        os << std::setprecision(digits) << mismatches << " of " << elements
+           << " elements differ, max abs error " << max_abs_error << ", max rel error "
+           << max_rel_error;
+
+        auto value = [&](const double(&v)[2]) {
+            if(complex)
+                os << '(' << v[0] << ',' << v[1] << ')';
+            else
+                os << v[0];
+        };
+        for(const rocblas_check_failure& failure : failures)
+        {
+            os << "\n  batch " << failure.batch << ", row " << failure.row << ", col "
+               << failure.col << ": expected ";
+            value(failure.cpu);
+            os << ", got ";
+            value(failure.gpu);
+        }
+        if(mismatches > int64_t(failures.size()))
+            os << "\n  ...";
+        return os.str();
+    }
+};
+
+// Real (part 0) or imaginary (part 1) part of a value of any client type
+template <typename T>
+inline double rocblas_check_part(const T& x, int part)
+{
+    if constexpr(rocblas_is_complex<T>)
+        return part ? std::imag(x) : std::real(x);
+    else if constexpr(std::is_integral<T>{})
+        return part ? 0 : double(x);
+    else
+        return part ? 0 : double(float(x));
+}
+
+/*! \brief Compares batch_count M x N matrices
+ *
+ * hCPU(k) and hGPU(k) return the storage of batch k, with leading dimension lda, which may be
+ * negative for vectors; pass(cpu, gpu) is the predicate of the check.
+ */
+template <typename CPU, typename GPU, typename PASS>
+rocblas_check_summary rocblas_bulk_check(
+    int64_t M, int64_t N, int64_t lda, int64_t batch_count, CPU hCPU, GPU hGPU, PASS pass)
+{
+    using T = std::remove_cv_t<std::remove_reference_t<decltype(*hGPU(0))>>;
+
+    rocblas_check_summary summary;
+    summary.complex = rocblas_is_complex<T>;
+    summary.digits  = sizeof(T) / (rocblas_is_complex<T> ? 2 : 1) > 4 ? 17 : 9;
+    if(M <= 0 || N <= 0 || batch_count <= 0)
+        return summary;
+    summary.elements = M * N * batch_count;
+
+    int64_t offset = lda >= 0 ? 0 : lda * (1 - N);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        rocblas_check_summary local = summary;
+        local.elements              = 0;
+
+#ifdef _OPENMP
+#pragma omp for collapse(2) schedule(dynamic) nowait
+#endif
+        for(int64_t k = 0; k < batch_count; k++)
+            for(int64_t j = 0; j < N; j++)
+            {
+                auto cpu = hCPU(k) + offset + j * lda;
+                auto gpu = hGPU(k) + offset + j * lda;
+
+                auto fails = [&](int64_t i) {
+                    return rocblas_isnan(cpu[i]) ? !rocblas_isnan(gpu[i]) : !pass(cpu[i], gpu[i]);
+                };
+
+                int64_t mismatches = 0;
+                double  max_abs    = local.max_abs_error;
+                double  max_rel    = local.max_rel_error;
+
+#ifdef _OPENMP
+#pragma omp simd reduction(+ : mismatches) reduction(max : max_abs, max_rel)
+#endif
+                for(int64_t i = 0; i < M; i++)
+                {
+                    mismatches += fails(i);
+
+                    double cr  = rocblas_check_part(cpu[i], 0);
+                    double ci  = rocblas_check_part(cpu[i], 1);
+                    double dr  = rocblas_check_part(gpu[i], 0) - cr;
+                    double di  = rocblas_check_part(gpu[i], 1) - ci;
+                    double ref = std::abs(cr);
+                    double err = std::abs(dr);
+                    if constexpr(rocblas_is_complex<T>)
+                    {
+                        ref = std::sqrt(cr * cr + ci * ci);
+                        err = std::sqrt(dr * dr + di * di);
+                    }
+
+                    // NaNs compare false and are left out of the maximum errors
+                    if(err > max_abs)
+                        max_abs = err;
+                    if(err > 0 && err / ref > max_rel)
+                        max_rel = err / ref;
+                }
+
+                local.max_abs_error = max_abs;
+                local.max_rel_error = max_rel;
+
+                if(!mismatches)
+                    continue;
+
+                rocblas_check_summary column;
+                column.mismatches = mismatches;
+                for(int64_t i = 0; i < M && column.failures.size() < rocblas_check_reported; i++)
+                    if(fails(i))
+                        column.failures.push_back({k,
+                                                   i,
+                                                   j,
+                                                   {rocblas_check_part(cpu[i], 0),
+                                                    rocblas_check_part(cpu[i], 1)},
+                                                   {rocblas_check_part(gpu[i], 0),
+                                                    rocblas_check_part(gpu[i], 1)}});
+                local.merge(column);
+            }
+
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+        summary.merge(local);
+    }
+
+    return summary;
+}
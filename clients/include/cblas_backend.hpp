@@ -0,0 +1,94 @@
+/* ************************************************************************
+ * Copyright (C) 2018-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell cop-
+ * ies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM-
+ * PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNE-
+ * CTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ************************************************************************/
+
+#pragma once
+
+#include "rocblas.h"
+#include <cstdint>
+#include <string>
+
+/*!\file
+ * \brief Run-time selection of the host BLAS used for the gemm references.
+ *
+ * The backend is named by the --cblas option of rocblas-test and rocblas-bench, or else by the
+ * ROCBLAS_CLIENT_CBLAS environment variable:
+ *
+ *   linked   the CBLAS the clients were linked against (default)
+ *   openblas OpenBLAS, loaded with dlopen
+ *   blis     BLIS, loaded with dlopen
+ *   mkl      the MKL single dynamic library, loaded with dlopen
+ *   builtin  a blocked OpenMP gemm compiled into the clients
+ *
+ * or a path to any shared library exporting cblas_sgemm, cblas_dgemm, cblas_cgemm and
+ * cblas_zgemm. ROCBLAS_CLIENT_CBLAS_THREADS sets the thread count of the backend independently of
+ * OMP_NUM_THREADS. The selection is made on first use and fails hard when the named library
+ * cannot be loaded, so a comparison never silently runs against a different reference.
+ *
+ * Only the gemm references, and the gemmt, herkx and f8 references built on them, use the selected
+ * backend; every other reference still calls the linked CBLAS.
+ */
+
+// Selects the backend by name, overriding ROCBLAS_CLIENT_CBLAS. Has no effect once a gemm
+// reference has run.
+void cblas_backend_set(const char* name);
+
+// Name of the selected backend
+const char* cblas_backend_name();
+
+// Client banner line naming the selected backend, and the references it computes when it is not
+// the linked one
+std::string cblas_backend_banner();
+
+// Column-major C = alpha * op(A) * op(B) + beta * C on the selected backend. Instantiated for
+// float, double, rocblas_float_complex and rocblas_double_complex.
+template <typename T>
+void cblas_backend_gemm(rocblas_operation transA,
+                        rocblas_operation transB,
+                        int64_t           m,
+                        int64_t           n,
+                        int64_t           k,
+                        T                 alpha,
+                        const T*          A,
+                        int64_t           lda,
+                        const T*          B,
+                        int64_t           ldb,
+                        T                 beta,
+                        T*                C,
+                        int64_t           ldc);
+
+// As above, on the named backend instead of the selected one, which is opened on first use. Lets
+// the tests compare the backends in one process.
+template <typename T>
+void cblas_backend_gemm(const char*       backend,
+                        rocblas_operation transA,
+                        rocblas_operation transB,
+                        int64_t           m,
+                        int64_t           n,
+                        int64_t           k,
+                        T                 alpha,
+                        const T*          A,
+                        int64_t           lda,
+                        const T*          B,
+                        int64_t           ldb,
+                        T                 beta,
+                        T*                C,
+                        int64_t           ldc);
@@ -24,9 +24,14 @@
 #pragma once
 
 #include "cblas.h"
+#include "cblas_backend.hpp"
 #include "lapack_utilities.hpp"
 #include "rocblas.h"
+#include "rocblas_convert.hpp"
 #include <type_traits>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 /*
  * ===========================================================================
@@ -1860,27 +1865,22 @@ inline void f8_to_cblas_sgemm(rocblas_operation transA,
 
     host_vector<Tc> A_float(sizeA), B_float(sizeB), C_float(sizeC);
 
-    for(size_t i = 0; i < sizeA; i++)
-        A_float[i] = static_cast<float>(A[i]);
-    for(size_t i = 0; i < sizeB; i++)
-        B_float[i] = static_cast<float>(B[i]);
+    rocblas_convert(A, A_float.data(), sizeA);
+    rocblas_convert(B, B_float.data(), sizeB);
 
-    // just directly cast, since transA, transB are integers in the enum
-    // printf("transA: rocblas =%d, cblas=%d\n", transA, static_cast<CBLAS_TRANSPOSE>(transA) );
-    cblas_sgemm(CblasColMajor,
-                static_cast<CBLAS_TRANSPOSE>(transA),
-                static_cast<CBLAS_TRANSPOSE>(transB),
-                m,
-                n,
-                k,
-                alpha,
-                A_float,
-                lda,
-                B_float,
-                ldb,
-                beta,
-                C,
-                ldc);
+    cblas_backend_gemm(transA,
+                       transB,
+                       m,
+                       n,
+                       k,
+                       alpha,
+                       A_float.data(),
+                       lda,
+                       B_float.data(),
+                       ldb,
+                       beta,
+                       C,
+                       ldc);
 }
 
 // gemm
@@ -1912,32 +1912,25 @@ inline void f8_to_cblas_sgemm(rocblas_operation transA,
 
     host_vector<Tc> A_float(sizeA), B_float(sizeB), C_float(sizeC);
 
-    for(size_t i = 0; i < sizeA; i++)
-        A_float[i] = static_cast<float>(A[i]);
-    for(size_t i = 0; i < sizeB; i++)
-        B_float[i] = static_cast<float>(B[i]);
-    for(size_t i = 0; i < sizeC; i++)
-        C_float[i] = static_cast<float>(C[i]);
+    rocblas_convert(A, A_float.data(), sizeA);
+    rocblas_convert(B, B_float.data(), sizeB);
+    rocblas_convert(C, C_float.data(), sizeC);
 
-    // just directly cast, since transA, transB are integers in the enum
-    // printf("transA: rocblas =%d, cblas=%d\n", transA, static_cast<CBLAS_TRANSPOSE>(transA) );
-    cblas_sgemm(CblasColMajor,
-                static_cast<CBLAS_TRANSPOSE>(transA),
-                static_cast<CBLAS_TRANSPOSE>(transB),
-                m,
-                n,
-                k,
-                alpha,
-                A_float,
-                lda,
-                B_float,
-                ldb,
-                beta,
-                C_float,
-                ldc);
+    cblas_backend_gemm(transA,
+                       transB,
+                       m,
+                       n,
+                       k,
+                       alpha,
+                       A_float.data(),
+                       lda,
+                       B_float.data(),
+                       ldb,
+                       beta,
+                       C_float.data(),
+                       ldc);
 
-    for(size_t i = 0; i < sizeC; i++)
-        C[i] = To(C_float[i]);
+    rocblas_convert(C_float.data(), C, sizeC);
 }
 
 template <typename Ti, typename To = Ti, typename Tc>
@@ -1973,22 +1966,7 @@ inline void cblas_gemm(rocblas_operation                    transA,
                        int64_t                              ldc,
                        rocblas_bfloat16::rocblas_truncate_t round)
 {
-    // just directly cast, since transA, transB are integers in the enum
-    // printf("transA: rocblas =%d, cblas=%d\n", transA, (CBLAS_TRANSPOSE)transA );
-    cblas_sgemm(CblasColMajor,
-                CBLAS_TRANSPOSE(transA),
-                CBLAS_TRANSPOSE(transB),
-                m,
-                n,
-                k,
-                alpha,
-                A,
-                lda,
-                B,
-                ldb,
-                beta,
-                C,
-                ldc);
+    cblas_backend_gemm(transA, transB, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
 }
 
 template <>
@@ -2007,22 +1985,7 @@ inline void cblas_gemm(rocblas_operation                    transA,
                        int64_t                              ldc,
                        rocblas_bfloat16::rocblas_truncate_t round)
 {
-    // just directly cast, since transA, transB are integers in the enum
-    // printf("transA: rocblas =%d, cblas=%d\n", transA, (CBLAS_TRANSPOSE)transA );
-    cblas_sgemm(CblasColMajor,
-                CBLAS_TRANSPOSE(transA),
-                CBLAS_TRANSPOSE(transB),
-                m,
-                n,
-                k,
-                float(alpha),
-                A,
-                lda,
-                B,
-                ldb,
-                float(beta),
-                C,
-                ldc);
+    cblas_backend_gemm(transA, transB, m, n, k, float(alpha), A, lda, B, ldb, float(beta), C, ldc);
 }
 
 template <>
@@ -2041,20 +2004,7 @@ inline void cblas_gemm(rocblas_operation                    transA,
                        int64_t                              ldc,
                        rocblas_bfloat16::rocblas_truncate_t round)
 {
-    cblas_dgemm(CblasColMajor,
-                CBLAS_TRANSPOSE(transA),
-                CBLAS_TRANSPOSE(transB),
-                m,
-                n,
-                k,
-                alpha,
-                A,
-                lda,
-                B,
-                ldb,
-                beta,
-                C,
-                ldc);
+    cblas_backend_gemm(transA, transB, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
 }
 
 template <>
@@ -2073,21 +2023,7 @@ inline void cblas_gemm(rocblas_operation                    transA,
                        int64_t                              ldc,
                        rocblas_bfloat16::rocblas_truncate_t round)
 {
-    // just directly cast, since transA, transB are integers in the enum
-    cblas_cgemm(CblasColMajor,
-                CBLAS_TRANSPOSE(transA),
-                CBLAS_TRANSPOSE(transB),
-                m,
-                n,
-                k,
-                &alpha,
-                A,
-                lda,
-                B,
-                ldb,
-                &beta,
-                C,
-                ldc);
+    cblas_backend_gemm(transA, transB, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
 }
 
 template <>
@@ -2106,20 +2042,7 @@ inline void cblas_gemm(rocblas_operation                    transA,
                        int64_t                              ldc,
                        rocblas_bfloat16::rocblas_truncate_t round)
 {
-    cblas_zgemm(CblasColMajor,
-                CBLAS_TRANSPOSE(transA),
-                CBLAS_TRANSPOSE(transB),
-                m,
-                n,
-                k,
-                &alpha,
-                A,
-                lda,
-                B,
-                ldb,
-                &beta,
-                C,
-                ldc);
+    cblas_backend_gemm(transA, transB, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
 }
 
 //GEMMT
@@ -3023,4 +2946,65 @@ inline void cblas_trmm(rocblas_side                  side,
                 B,
                 ldb);
 }
+
+/*
+ * ===========================================================================
+ *    batched reference execution
+ * ===========================================================================
+ */
+
+// Thread count of the selected host BLAS backend (see cblas_backend.hpp), for the builtin one,
+// OpenBLAS, BLIS and MKL. cblas_get_num_threads returns 0 and cblas_set_num_threads does nothing
+// when the library does not expose a control; BLIS may report -1 when no count was set, which
+// cblas_set_num_threads restores.
+int  cblas_get_num_threads();
+void cblas_set_num_threads(int n);
+
+// Pins the host BLAS library to one thread for the lifetime of the object
+class cblas_single_thread_guard
+{
+    int m_saved;
+
+public:
+    cblas_single_thread_guard()
+        : m_saved(cblas_get_num_threads())
+    {
+        if(m_saved != 1)
+            cblas_set_num_threads(1);
+    }
+
+    ~cblas_single_thread_guard()
+    {
+        if(m_saved != 1)
+            cblas_set_num_threads(m_saved);
+    }
+
+    cblas_single_thread_guard(const cblas_single_thread_guard&) = delete;
+    cblas_single_thread_guard& operator=(const cblas_single_thread_guard&) = delete;
+};
+
+// Calls ref(b) for b in [0, batch_count), with the batch members spread over the OpenMP threads.
+// The host BLAS is pinned to one thread meanwhile so the two levels do not oversubscribe the
+// cores; OpenMP regions inside ref run on the calling thread. ref must only write the outputs of
+// member b. The thread count is read before pinning, since pinning an OpenMP build of the host
+// BLAS, such as OpenBLAS, also sets the OpenMP thread count to one.
+template <typename F>
+void cblas_batched(int64_t batch_count, F&& ref)
+{
+#ifdef _OPENMP
+    const int num_threads = omp_get_max_threads();
+    if(batch_count > 1 && num_threads > 1)
+    {
+        cblas_single_thread_guard single_thread;
+
+#pragma omp parallel for schedule(dynamic) num_threads(num_threads)
+        for(int64_t b = 0; b < batch_count; b++)
+            ref(b);
+
+        return;
+    }
+#endif
+    for(int64_t b = 0; b < batch_count; b++)
+        ref(b);
+}
 /* ============================================================================================ */
@@ -0,0 +1,222 @@
+/* ************************************************************************
+ * Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell cop-
+ * ies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM-
+ * PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNE-
+ * CTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ************************************************************************ */
+
+/*!\file
+ * \brief Host reference gemm over tropical and other semirings.
+ */
+
+#pragma once
+
+#include "rocblas.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//!
+//! @brief Semirings for cblas_semiring_gemm. combine(alpha, a, b) takes the place of alpha * a * b
+//! and reduce(acc, x) the place of acc + x. reduce returns x when the two compare equal or either
+//! is NaN, which matches std::min(x, acc) and std::max(x, acc).
+//!
+template <typename T>
+struct semiring_min_plus
+{
+    static T combine(T alpha, T a, T b)
+    {
+        return alpha * (a + b);
+    }
+    static T reduce(T acc, T x)
+    {
+        return acc < x ? acc : x;
+    }
+};
+
+template <typename T>
+struct semiring_max_plus
+{
+    static T combine(T alpha, T a, T b)
+    {
+        return alpha * (a + b);
+    }
+    static T reduce(T acc, T x)
+    {
+        return x < acc ? acc : x;
+    }
+};
+
+template <typename T>
+struct semiring_plus_min
+{
+    static T combine(T alpha, T a, T b)
+    {
+        T x = alpha * a, y = alpha * b;
+        return y < x ? y : x;
+    }
+    static T reduce(T acc, T x)
+    {
+        return acc + x;
+    }
+};
+
+template <typename T>
+struct semiring_min_max
+{
+    static T combine(T alpha, T a, T b)
+    {
+        T x = alpha * a, y = alpha * b;
+        return x < y ? y : x;
+    }
+    static T reduce(T acc, T x)
+    {
+        return acc < x ? acc : x;
+    }
+};
+
+//!
+//! @brief D = beta * C reduced with combine(alpha, op(A)(i, l), op(B)(l, j)) for l = 0 .. k-1 in
+//! order, so every element matches the plain triple loop bit for bit. Tiles of D are distributed
+//! over OpenMP threads; for each tile the panels of op(A) and op(B) are packed into thread local
+//! buffers so that the innermost loop runs down a column of D with unit stride and vectorizes,
+//! and four values of l are applied per load and store of D. C and D may be the same matrix.
+//!
+template <typename Semiring, typename T>
+void cblas_semiring_gemm(rocblas_operation transA,
+                         rocblas_operation transB,
+                         int64_t           m,
+                         int64_t           n,
+                         int64_t           k,
+                         T                 alpha,
+                         const T*          A,
+                         int64_t           lda,
+                         const T*          B,
+                         int64_t           ldb,
+                         T                 beta,
+                         const T*          C,
+                         int64_t           ldc,
+                         T*                D,
+                         int64_t           ldd)
+{
+    constexpr int64_t MB = 128, NB = 64, KB = 128;
+
+    if(m <= 0 || n <= 0)
+        return;
+
+    const int64_t m_tiles = (m + MB - 1) / MB;
+    const int64_t n_tiles = (n + NB - 1) / NB;
+
+    const bool trans_A = transA != rocblas_operation_none;
+    const bool trans_B = transB != rocblas_operation_none;
+
+#ifdef _OPENMP
+#pragma omp parallel if(m_tiles * n_tiles > 1)
+#endif
+    {
+        // A_panel holds op(A)(i0 + i, p0 + l) at [l * MB + i], B_panel op(B)(p0 + l, j0 + j) at
+        // [j * KB + l]
+        std::vector<T> A_panel(MB * KB), B_panel(KB * NB);
+
+#ifdef _OPENMP
+#pragma omp for collapse(2) schedule(dynamic)
+#endif
+        for(int64_t jt = 0; jt < n_tiles; jt++)
+        {
+            for(int64_t it = 0; it < m_tiles; it++)
+            {
+                const int64_t i0 = it * MB, mb = std::min(MB, m - i0);
+                const int64_t j0 = jt * NB, nb = std::min(NB, n - j0);
+
+                for(int64_t j = 0; j < nb; j++)
+                {
+                    const T* c = C + i0 + (j0 + j) * ldc;
+                    T*       d = D + i0 + (j0 + j) * ldd;
+                    for(int64_t i = 0; i < mb; i++)
+                        d[i] = beta * c[i];
+                }
+
+                for(int64_t p0 = 0; p0 < k; p0 += KB)
+                {
+                    const int64_t kb = std::min(KB, k - p0);
+
+                    for(int64_t l = 0; l < kb; l++)
+                    {
+                        T* a = A_panel.data() + l * MB;
+                        if(trans_A)
+                            for(int64_t i = 0; i < mb; i++)
+                                a[i] = A[(p0 + l) + (i0 + i) * lda];
+                        else
+                            std::copy_n(A + i0 + (p0 + l) * lda, mb, a);
+                    }
+
+                    for(int64_t j = 0; j < nb; j++)
+                    {
+                        T* b = B_panel.data() + j * KB;
+                        if(trans_B)
+                            for(int64_t l = 0; l < kb; l++)
+                                b[l] = B[(j0 + j) + (p0 + l) * ldb];
+                        else
+                            std::copy_n(B + p0 + (j0 + j) * ldb, kb, b);
+                    }
+
+                    for(int64_t j = 0; j < nb; j++)
+                    {
+                        T*       d = D + i0 + (j0 + j) * ldd;
+                        const T* b = B_panel.data() + j * KB;
+
+                        int64_t l = 0;
+                        for(; l + 4 <= kb; l += 4)
+                        {
+                            const T* a0 = A_panel.data() + l * MB;
+                            const T* a1 = a0 + MB;
+                            const T* a2 = a1 + MB;
+                            const T* a3 = a2 + MB;
+                            const T  b0 = b[l], b1 = b[l + 1], b2 = b[l + 2], b3 = b[l + 3];
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+                            for(int64_t i = 0; i < mb; i++)
+                            {
+                                T acc = d[i];
+                                acc   = Semiring::reduce(acc, Semiring::combine(alpha, a0[i], b0));
+                                acc   = Semiring::reduce(acc, Semiring::combine(alpha, a1[i], b1));
+                                acc   = Semiring::reduce(acc, Semiring::combine(alpha, a2[i], b2));
+                                acc   = Semiring::reduce(acc, Semiring::combine(alpha, a3[i], b3));
+                                d[i]  = acc;
+                            }
+                        }
+                        for(; l < kb; l++)
+                        {
+                            const T* a0 = A_panel.data() + l * MB;
+                            const T  b0 = b[l];
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+                            for(int64_t i = 0; i < mb; i++)
+                                d[i] = Semiring::reduce(d[i], Semiring::combine(alpha, a0[i], b0));
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
@@ -88,7 +88,12 @@ public:
     T* device_vector_setup()
     {
         T* d = nullptr;
-        if(use_HMM ? hipMallocManaged(&d, m_bytes) : (hipMalloc)(&d, m_bytes) != hipSuccess)
+        if(!use_HMM && d_vector_cache_enabled())
+            d = static_cast<T*>(d_vector_cache_acquire(m_bytes));
+        else if(use_HMM ? hipMallocManaged(&d, m_bytes) : (hipMalloc)(&d, m_bytes) != hipSuccess)
+            d = nullptr;
+
+        if(!d)
         {
             rocblas_cerr << "Warning: hip can't allocate " << m_bytes << " bytes ("
                          << (m_bytes >> 30) << " GB)" << std::endl;
@@ -100,16 +105,9 @@ public:
         {
             if(m_guard_len > 0)
             {
-                // Copy m_guard to device memory before allocated memory
-                if(hipMemcpy(d, m_guard, m_guard_len, hipMemcpyDefault) != hipSuccess)
-                    rocblas_cerr << "Error: hipMemcpy pre-guard copy failure." << std::endl;
-
-                // Point to allocated block
+                // Point to allocated block, with m_guard copied before and after it
                 d += m_pad;
-
-                // Copy m_guard to device memory after allocated memory
-                if(hipMemcpy(d + m_size, m_guard, m_guard_len, hipMemcpyDefault) != hipSuccess)
-                    rocblas_cerr << "Error: hipMemcpy post-guard copy failure." << std::endl;
+                d_vector_guard_write(d - m_pad, d + m_size, m_guard, sizeof(m_guard), m_guard_len);
             }
         }
 #endif
@@ -119,26 +117,16 @@ public:
     void device_vector_check(T* d)
     {
 #ifdef GOOGLE_TEST
-        if(m_pad > 0)
+        size_t offset;
+        if(m_pad > 0 && !d_vector_guard_check(d - m_pad, d + m_size, m_guard, m_guard_len, offset))
         {
-            T host[m_pad];
-
-            // Copy device memory after allocated memory to host
-            if(hipMemcpy(host, d + this->m_size, m_guard_len, hipMemcpyDefault) != hipSuccess)
-                rocblas_cerr << "Error: hipMemcpy post-guard copy failure." << std::endl;
-
-            // Make sure no corruption has occurred
-            EXPECT_EQ(memcmp(host, m_guard, m_guard_len), 0);
-
-            // Point to m_guard before allocated memory
-            d -= m_pad;
-
-            // Copy device memory after allocated memory to host
-            if(hipMemcpy(host, d, m_guard_len, hipMemcpyDefault) != hipSuccess)
-                rocblas_cerr << "Error: hipMemcpy pre-guard copy failure." << std::endl;
-
-            // Make sure no corruption has occurred
-            EXPECT_EQ(memcmp(host, m_guard, m_guard_len), 0);
+            // Make sure no corruption has occurred, and report where it has
+            int64_t element = int64_t(offset / sizeof(T)) - int64_t(m_pad);
+            if(element >= 0)
+                element += m_size;
+            ADD_FAILURE() << "Device memory corrupted " << (element < 0 ? "before" : "after")
+                          << " the block of " << m_size << " elements of " << sizeof(T)
+                          << " bytes at " << d << ", first at element " << element;
         }
 #endif
     }
@@ -152,8 +140,9 @@ public:
             if(m_pad > 0)
                 d -= m_pad; // restore to start of alloc
 
-            // Free device memory
-            CHECK_HIP_ERROR((hipFree)(d));
+            // Free device memory, unless it is returned to the cache
+            if(!d_vector_cache_release(d))
+                CHECK_HIP_ERROR((hipFree)(d));
         }
     }
 };
@@ -625,87 +625,84 @@ void lapack_xtrti2(char uplo, char diag, int64_t n, T* A, int64_t lda)
     }
 }
 
-// cblas doesn't have trtri implementation for now so using the lapack trtri implementation below
+// cblas doesn't have trtri, so invert recursively on top of cblas_trmm: with the matrix split
+// in halves, both diagonal blocks are inverted in place and the off-diagonal block follows from
+//   inv([A11 A12; 0 A22]) = [inv(A11), -inv(A11) * A12 * inv(A22); 0, inv(A22)]
+// Almost all the work lands in the two half-size trmm panels of the top levels, which the host
+// BLAS threads well, rather than in the j x 64 panels of the blocked lapack trtri.
 template <typename T>
 void lapack_xtrtri(char uplo, char diag, int64_t n, T* A, int64_t lda)
 {
-    if(n <= 0)
-        return;
+    constexpr int64_t NB = 64;
 
-    int64_t NB = 64;
-    int64_t JB = 0;
-    if(NB <= 1 || NB >= n)
+    if(n <= NB)
     {
         lapack_xtrti2(uplo, diag, n, A, lda);
+        return;
+    }
+
+    // Split at a multiple of NB so the leaves are full blocks
+    int64_t n1 = ((n / 2 + NB - 1) / NB) * NB;
+    int64_t n2 = n - n1;
+
+    T* A11 = A;
+    T* A22 = A + (n1 + n1 * lda);
+
+    lapack_xtrtri(uplo, diag, n1, A11, lda);
+    lapack_xtrtri(uplo, diag, n2, A22, lda);
+
+    if(uplo == 'U')
+    {
+        // A12 = -inv(A11) * A12 * inv(A22)
+        T* A12 = A + n1 * lda;
+        cblas_trmm(rocblas_side_left,
+                   rocblas_fill_upper,
+                   rocblas_operation_none,
+                   char2rocblas_diagonal(diag),
+                   n1,
+                   n2,
+                   T(-1.0),
+                   A11,
+                   lda,
+                   A12,
+                   lda);
+        cblas_trmm(rocblas_side_right,
+                   rocblas_fill_upper,
+                   rocblas_operation_none,
+                   char2rocblas_diagonal(diag),
+                   n1,
+                   n2,
+                   T(1.0),
+                   A22,
+                   lda,
+                   A12,
+                   lda);
     }
     else
     {
-        if(uplo == 'U')
-        {
-            // Compute inverse of upper triangular matrix
-            for(int64_t j = 0; j < n; j += NB)
-            {
-                JB = std::min(NB, n - j);
-
-                // Compute rows 0:j-1 of current block column
-                cblas_trmm(rocblas_side_left,
-                           rocblas_fill_upper,
-                           rocblas_operation_none,
-                           char2rocblas_diagonal(diag),
-                           j,
-                           JB,
-                           T(1.0),
-                           A,
-                           lda,
-                           A + (j * lda),
-                           lda);
-                cblas_trsm(rocblas_side_right,
-                           rocblas_fill_upper,
-                           rocblas_operation_none,
-                           char2rocblas_diagonal(diag),
-                           j,
-                           JB,
-                           T(-1.0),
-                           A + (j + j * lda),
-                           lda,
-                           A + j * lda,
-                           lda);
-                lapack_xtrti2(uplo, diag, JB, A + (j + j * lda), lda);
-            }
-        }
-        else
-        {
-            int64_t NN = ((n - 1) / NB) * NB;
-            for(int64_t j = NN; j >= 0; j -= NB)
-            {
-                JB = std::min(NB, n - j);
-                if(j + JB <= n)
-                {
-                    cblas_trmm(rocblas_side_left,
-                               rocblas_fill_lower,
-                               rocblas_operation_none,
-                               char2rocblas_diagonal(diag),
-                               n - j - JB,
-                               JB,
-                               T(1.0),
-                               A + ((j + JB) + (j + JB) * lda),
-                               lda,
-                               A + ((j + JB) + j * lda),
-                               lda);
-                    cblas_trsm(rocblas_side_right,
-                               rocblas_fill_lower,
-                               rocblas_operation_none,
-                               char2rocblas_diagonal(diag),
-                               n - j - JB,
-                               JB,
-                               T(-1.0),
-                               A + (j + j * lda),
-                               lda,
-                               A + ((j + JB) + j * lda),
-                               lda);
-                }
-                lapack_xtrti2(uplo, diag, JB, A + (j + j * lda), lda);
-            }
-        }
+        // A21 = -inv(A22) * A21 * inv(A11)
+        T* A21 = A + n1;
+        cblas_trmm(rocblas_side_right,
+                   rocblas_fill_lower,
+                   rocblas_operation_none,
+                   char2rocblas_diagonal(diag),
+                   n2,
+                   n1,
+                   T(-1.0),
+                   A11,
+                   lda,
+                   A21,
+                   lda);
+        cblas_trmm(rocblas_side_left,
+                   rocblas_fill_lower,
+                   rocblas_operation_none,
+                   char2rocblas_diagonal(diag),
+                   n2,
+                   n1,
+                   T(1.0),
+                   A22,
+                   lda,
+                   A21,
+                   lda);
     }
 }
@@ -32,6 +32,7 @@
 #pragma once
 
 #include "rocblas.h"
+#include "rocblas_convert.hpp"
 #include "rocblas_math.hpp"
 #include "rocblas_test.hpp"
 #include "rocblas_vector.hpp"
@@ -106,64 +107,44 @@ ROCBLAS_CLANG_STATIC constexpr double
 #define NEAR_CHECK_B(M, N, lda, hCPU, hGPU, batch_count, err, NEAR_ASSERT)
 #else
 
+// Each NEAR_ASSERT has a predicate rocblas_check_<NEAR_ASSERT> used by the bulk comparison, which
+// raises a single failure with a summary of all the mismatches
+
+#define NEAR_CHECK_SUMMARY(M, N, lda, hCPU, hGPU, batch_count, err, NEAR_ASSERT)            \
+    do                                                                                      \
+    {                                                                                       \
+        auto summary__ = rocblas_bulk_check(                                                \
+            M, N, lda, batch_count, hCPU, hGPU, [&](const auto& a, const auto& b) {         \
+                return rocblas_check_##NEAR_ASSERT(a, b, err);                              \
+            });                                                                             \
+        if(summary__.mismatches)                                                            \
+            FAIL() << summary__.str();                                                      \
+    } while(0)
+
 // Also used for vectors with lda used for inc, which may be negative
 #define NEAR_CHECK(M, N, lda, strideA, hCPU, hGPU, batch_count, err, NEAR_ASSERT) \
-    do                                                                            \
-    {                                                                             \
-        for(int64_t k = 0; k < batch_count; k++)                                  \
-            for(int64_t j = 0; j < N; j++)                                        \
-            {                                                                     \
-                int64_t offset = lda >= 0 ? 0 : int64_t(lda) * (1 - N);           \
-                offset += j * int64_t(lda) + k * strideA;                         \
-                size_t idx = offset;                                              \
-                for(size_t i = 0; i < M; i++)                                     \
-                {                                                                 \
-                    if(rocblas_isnan(hCPU[i + idx]))                              \
-                    {                                                             \
-                        ASSERT_TRUE(rocblas_isnan(hGPU[i + idx]));                \
-                    }                                                             \
-                    else                                                          \
-                    {                                                             \
-                        NEAR_ASSERT(hCPU[i + idx], hGPU[i + idx], err);           \
-                    }                                                             \
-                }                                                                 \
-            }                                                                     \
-    } while(0)
+    NEAR_CHECK_SUMMARY(M,                                                         \
+                       N,                                                         \
+                       lda,                                                       \
+                       [&](int64_t k) { return &hCPU[0] + k * strideA; },        \
+                       [&](int64_t k) { return &hGPU[0] + k * strideA; },        \
+                       batch_count,                                               \
+                       err,                                                       \
+                       NEAR_ASSERT)
 
 // Also used for vectors with lda used for inc, which may be negative
-#define NEAR_CHECK_B(M, N, lda, hCPU, hGPU, batch_count, err, NEAR_ASSERT)    \
-    do                                                                        \
-    {                                                                         \
-        for(size_t k = 0; k < batch_count; k++)                               \
-            for(int64_t j = 0; j < N; j++)                                    \
-            {                                                                 \
-                int64_t offset = lda >= 0 ? 0 : int64_t(lda) * (1 - N);       \
-                offset += j * int64_t(lda);                                   \
-                size_t idx = offset;                                          \
-                for(size_t i = 0; i < M; i++)                                 \
-                {                                                             \
-                    if(rocblas_isnan(hCPU[k][i + idx]))                       \
-                    {                                                         \
-                        ASSERT_TRUE(rocblas_isnan(hGPU[k][i + idx]));         \
-                    }                                                         \
-                    else                                                      \
-                    {                                                         \
-                        NEAR_ASSERT(hCPU[k][i + idx], hGPU[k][i + idx], err); \
-                    }                                                         \
-                }                                                             \
-            }                                                                 \
-    } while(0)
+#define NEAR_CHECK_B(M, N, lda, hCPU, hGPU, batch_count, err, NEAR_ASSERT) \
+    NEAR_CHECK_SUMMARY(M,                                                  \
+                       N,                                                  \
+                       lda,                                                \
+                       [&](int64_t k) { return &hCPU[k][0]; },            \
+                       [&](int64_t k) { return &hGPU[k][0]; },            \
+                       batch_count,                                        \
+                       err,                                                \
+                       NEAR_ASSERT)
 
 #endif
 
-#define NEAR_ASSERT_HALF(a, b, err) ASSERT_NEAR(double(a), double(b), err)
-
-#define NEAR_ASSERT_BF16(a, b, err) ASSERT_NEAR(double(rocblas_bfloat16(a)), double(b), err)
-
-#define NEAR_ASSERT_F8(a, b, err) ASSERT_NEAR(double(float(a)), double(float(b)), err)
-
-#define NEAR_ASSERT_BF8(a, b, err) ASSERT_NEAR(double(float(a)), double(float(b)), err)
-
 #define NEAR_ASSERT_COMPLEX(a, b, err)                  \
     do                                                  \
     {                                                   \
@@ -172,6 +153,75 @@ ROCBLAS_CLANG_STATIC constexpr double
         ASSERT_NEAR(std::imag(ta), std::imag(tb), err); \
     } while(0)
 
+// Predicates of ASSERT_NEAR and NEAR_ASSERT_COMPLEX
+template <typename T, typename U>
+inline bool rocblas_check_ASSERT_NEAR(const T& a, const U& b, double err)
+{
+    double da = rocblas_check_part(a, 0), db = rocblas_check_part(b, 0);
+    return da == db || std::abs(da - db) <= err;
+}
+
+template <typename T>
+inline bool rocblas_check_NEAR_ASSERT_COMPLEX(const T& a, const T& b, double err)
+{
+    return rocblas_check_ASSERT_NEAR(std::real(a), std::real(b), err)
+           && rocblas_check_ASSERT_NEAR(std::imag(a), std::imag(b), err);
+}
+
+// Reduced precision results are expanded to float with the bulk conversions and compared as
+// floats, instead of converting every element inside NEAR_CHECK. Tr is the precision h is
+// rounded to first, so a float reference is compared with a bfloat16 result in bfloat16.
+// lda may be negative for vectors, out is M x N with leading dimension M.
+template <typename Tr, typename T>
+inline void near_check_expand(int64_t M, int64_t N, int64_t lda, const T* h, float* out)
+{
+    const T*        base = h + (lda >= 0 ? 0 : lda * (1 - N));
+    host_vector<Tr> rounded(std::is_same<T, Tr>{} ? 0 : M);
+    for(int64_t j = 0; j < N; j++)
+    {
+        if constexpr(std::is_same<T, Tr>{})
+            rocblas_convert(base + j * lda, out + j * M, M);
+        else
+        {
+            rocblas_convert(base + j * lda, (Tr*)rounded, M);
+            rocblas_convert((const Tr*)rounded, out + j * M, M);
+        }
+    }
+}
+
+// hCPU(k) and hGPU(k) return batch k; GPU results are compared in their own precision Tr
+template <typename Tr, typename CPU, typename GPU>
+inline void near_check_converted(int64_t M,
+                                 int64_t N,
+                                 int64_t lda,
+                                 CPU     hCPU,
+                                 GPU     hGPU,
+                                 int64_t batch_count,
+                                 double  abs_error)
+{
+#ifdef GOOGLE_TEST
+    host_vector<float>    cpu(M * N), gpu(M * N);
+    rocblas_check_summary summary;
+    for(int64_t k = 0; k < batch_count; k++)
+    {
+        near_check_expand<Tr>(M, N, lda, hCPU(k), (float*)cpu);
+        near_check_expand<Tr>(M, N, lda, hGPU(k), (float*)gpu);
+        summary.merge(rocblas_bulk_check(M,
+                                         N,
+                                         M,
+                                         1,
+                                         [&](int64_t) { return (const float*)cpu; },
+                                         [&](int64_t) { return (const float*)gpu; },
+                                         [=](float a, float b) {
+                                             return rocblas_check_ASSERT_NEAR(a, b, abs_error);
+                                         }),
+                      k);
+    }
+    if(summary.mismatches)
+        FAIL() << summary.str();
+#endif
+}
+
 // TODO: Replace std::remove_cv_t with std::type_identity_t in C++20
 // It is only used to make T_hpa non-deduced
 template <typename T, typename T_hpa = T>
@@ -193,7 +243,8 @@ inline void near_check_general(int64_t             M,
                                const rocblas_half* hGPU,
                                double              abs_error)
 {
-    NEAR_CHECK(M, N, lda, 0, hCPU, hGPU, 1, abs_error, NEAR_ASSERT_HALF);
+    near_check_converted<rocblas_half>(
+        M, N, lda, [=](int64_t) { return hCPU; }, [=](int64_t) { return hGPU; }, 1, abs_error);
 }
 
 template <>
@@ -204,7 +255,8 @@ inline void near_check_general(int64_t           M,
                                const rocblas_f8* hGPU,
                                double            abs_error)
 {
-    NEAR_CHECK(M, N, lda, 0, hCPU, hGPU, 1, abs_error, NEAR_ASSERT_F8);
+    near_check_converted<rocblas_f8>(
+        M, N, lda, [=](int64_t) { return hCPU; }, [=](int64_t) { return hGPU; }, 1, abs_error);
 }
 
 template <>
@@ -215,7 +267,8 @@ inline void near_check_general(int64_t            M,
                                const rocblas_bf8* hGPU,
                                double             abs_error)
 {
-    NEAR_CHECK(M, N, lda, 0, hCPU, hGPU, 1, abs_error, NEAR_ASSERT_BF8);
+    near_check_converted<rocblas_bf8>(
+        M, N, lda, [=](int64_t) { return hCPU; }, [=](int64_t) { return hGPU; }, 1, abs_error);
 }
 
 template <>
@@ -226,7 +279,8 @@ inline void near_check_general<rocblas_bfloat16, float>(int64_t
                                                         const rocblas_bfloat16* hGPU,
                                                         double                  abs_error)
 {
-    NEAR_CHECK(M, N, lda, 0, hCPU, hGPU, 1, abs_error, NEAR_ASSERT_BF16);
+    near_check_converted<rocblas_bfloat16>(
+        M, N, lda, [=](int64_t) { return hCPU; }, [=](int64_t) { return hGPU; }, 1, abs_error);
 }
 
 template <>
@@ -276,7 +330,14 @@ inline void near_check_general(int64_t             M,
                                int64_t             batch_count,
                                double              abs_error)
 {
-    NEAR_CHECK(M, N, lda, strideA, hCPU, hGPU, batch_count, abs_error, NEAR_ASSERT_HALF);
+    near_check_converted<rocblas_half>(
+        M,
+        N,
+        lda,
+        [=](int64_t k) { return hCPU + k * strideA; },
+        [=](int64_t k) { return hGPU + k * strideA; },
+        batch_count,
+        abs_error);
 }
 
 template <>
@@ -289,7 +350,14 @@ inline void near_check_general(int64_t           M,
                                int64_t           batch_count,
                                double            abs_error)
 {
-    NEAR_CHECK(M, N, lda, strideA, hCPU, hGPU, batch_count, abs_error, NEAR_ASSERT_F8);
+    near_check_converted<rocblas_f8>(
+        M,
+        N,
+        lda,
+        [=](int64_t k) { return hCPU + k * strideA; },
+        [=](int64_t k) { return hGPU + k * strideA; },
+        batch_count,
+        abs_error);
 }
 
 template <>
@@ -302,7 +370,14 @@ inline void near_check_general(int64_t            M,
                                int64_t            batch_count,
                                double             abs_error)
 {
-    NEAR_CHECK(M, N, lda, strideA, hCPU, hGPU, batch_count, abs_error, NEAR_ASSERT_BF8);
+    near_check_converted<rocblas_bf8>(
+        M,
+        N,
+        lda,
+        [=](int64_t k) { return hCPU + k * strideA; },
+        [=](int64_t k) { return hGPU + k * strideA; },
+        batch_count,
+        abs_error);
 }
 
 template <>
@@ -315,7 +390,14 @@ inline void near_check_general<rocblas_bfloat16, float>(int64_t
                                                         int64_t                 batch_count,
                                                         double                  abs_error)
 {
-    NEAR_CHECK(M, N, lda, strideA, hCPU, hGPU, batch_count, abs_error, NEAR_ASSERT_BF16);
+    near_check_converted<rocblas_bfloat16>(
+        M,
+        N,
+        lda,
+        [=](int64_t k) { return hCPU + k * strideA; },
+        [=](int64_t k) { return hGPU + k * strideA; },
+        batch_count,
+        abs_error);
 }
 
 template <>
@@ -367,7 +449,14 @@ inline void near_check_general(int64_t                         M,
                                int64_t                         batch_count,
                                double                          abs_error)
 {
-    NEAR_CHECK_B(M, N, lda, hCPU, hGPU, batch_count, abs_error, NEAR_ASSERT_HALF);
+    near_check_converted<rocblas_half>(
+        M,
+        N,
+        lda,
+        [=](int64_t k) { return (const rocblas_half*)hCPU[k]; },
+        [=](int64_t k) { return (const rocblas_half*)hGPU[k]; },
+        batch_count,
+        abs_error);
 }
 template <>
 inline void near_check_general<rocblas_bfloat16, float>(int64_t                             M,
@@ -378,7 +467,14 @@ inline void near_check_general<rocblas_bfloat16, float>(int64_t
                                                         int64_t batch_count,
                                                         double  abs_error)
 {
-    NEAR_CHECK_B(M, N, lda, hCPU, hGPU, batch_count, abs_error, NEAR_ASSERT_BF16);
+    near_check_converted<rocblas_bfloat16>(
+        M,
+        N,
+        lda,
+        [=](int64_t k) { return (const float*)hCPU[k]; },
+        [=](int64_t k) { return (const rocblas_bfloat16*)hGPU[k]; },
+        batch_count,
+        abs_error);
 }
 
 template <>
@@ -428,7 +524,14 @@ inline void near_check_general(int64_t                   M,
                                int64_t                   batch_count,
                                double                    abs_error)
 {
-    NEAR_CHECK_B(M, N, lda, hCPU, hGPU, batch_count, abs_error, NEAR_ASSERT_HALF);
+    near_check_converted<rocblas_half>(
+        M,
+        N,
+        lda,
+        [=](int64_t k) { return hCPU[k]; },
+        [=](int64_t k) { return hGPU[k]; },
+        batch_count,
+        abs_error);
 }
 
 template <>
@@ -440,7 +543,14 @@ inline void near_check_general(int64_t                 M,
                                int64_t                 batch_count,
                                double                  abs_error)
 {
-    NEAR_CHECK_B(M, N, lda, hCPU, hGPU, batch_count, abs_error, NEAR_ASSERT_F8);
+    near_check_converted<rocblas_f8>(
+        M,
+        N,
+        lda,
+        [=](int64_t k) { return hCPU[k]; },
+        [=](int64_t k) { return hGPU[k]; },
+        batch_count,
+        abs_error);
 }
 
 template <>
@@ -452,7 +562,14 @@ inline void near_check_general(int64_t                  M,
                                int64_t                  batch_count,
                                double                   abs_error)
 {
-    NEAR_CHECK_B(M, N, lda, hCPU, hGPU, batch_count, abs_error, NEAR_ASSERT_BF8);
+    near_check_converted<rocblas_bf8>(
+        M,
+        N,
+        lda,
+        [=](int64_t k) { return hCPU[k]; },
+        [=](int64_t k) { return hGPU[k]; },
+        batch_count,
+        abs_error);
 }
 
 template <>
@@ -464,7 +581,14 @@ inline void near_check_general<rocblas_bfloat16, float>(int64_t
                                                         int64_t                       batch_count,
                                                         double                        abs_error)
 {
-    NEAR_CHECK_B(M, N, lda, hCPU, hGPU, batch_count, abs_error, NEAR_ASSERT_BF16);
+    near_check_converted<rocblas_bfloat16>(
+        M,
+        N,
+        lda,
+        [=](int64_t k) { return hCPU[k]; },
+        [=](int64_t k) { return hGPU[k]; },
+        batch_count,
+        abs_error);
 }
 
 template <>
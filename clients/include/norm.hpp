@@ -21,15 +21,19 @@
  * ************************************************************************ */
 #pragma once
 
+#include "bulk_check.hpp"
 #include "cblas.h"
 #include "lapack_utilities.hpp"
 #include "norm.hpp"
 #include "rocblas.h"
+#include "rocblas_error_stats.hpp"
 #include "rocblas_vector.hpp"
 #include "utility.hpp"
+#include <cmath>
 #include <cstdio>
 #include <limits>
 #include <memory>
+#include <vector>
 
 /* =====================================================================
         Norm check: norm(A-B)/norm(A), evaluate relative error
@@ -41,15 +45,237 @@
 
 /* ========================================Norm Check* ==================================================== */
 
-template <typename T>
-void m_axpy_64(int64_t N, T* alpha, T* x, int64_t incx, T* y, int64_t incy)
+/* ============== Fused norm computation ============= */
+
+// Scaled sum of squares as in LAPACK xLASSQ: the sum of squares is scale^2 * sumsq
+struct norm_check_ssq
 {
-    int64_t x_offset = incx >= 0 ? 0 : incx * (1 - N);
-    int64_t y_offset = incy >= 0 ? 0 : incy * (1 - N);
-    for(int64_t i = 0; i < N; i++)
+    double scale = 0.0;
+    double sumsq = 1.0;
+
+    void add(double x)
+    {
+        x = std::abs(x);
+        if(x > 0 || std::isnan(x))
+        {
+            if(scale < x)
+            {
+                sumsq = 1 + sumsq * (scale / x) * (scale / x);
+                scale = x;
+            }
+            else
+            {
+                sumsq += (x / scale) * (x / scale);
+            }
+        }
+    }
+
+    // Combines two scaled sums of squares, as LAPACK xCOMBSSQ
+    void add(const norm_check_ssq& other)
+    {
+        if(scale >= other.scale)
+        {
+            if(scale != 0)
+                sumsq += other.sumsq * (other.scale / scale) * (other.scale / scale);
+            else
+                sumsq += other.sumsq;
+        }
+        else
+        {
+            sumsq = other.sumsq + sumsq * (scale / other.scale) * (scale / other.scale);
+            scale = other.scale;
+        }
+    }
+
+    double value() const
+    {
+        return scale * std::sqrt(sumsq);
+    }
+};
+
+// Largest value, propagating NaN as lapack_xlange does
+inline void norm_check_max(double& value, double x)
+{
+    if(value < x || std::isnan(x))
+        value = x;
+}
+
+/*! \brief norm(hCPU - hGPU) / norm(hCPU) in a single parallel pass over both matrices
+ *
+ * uplo is 0 for a general M x N matrix, whose lda may be negative for vectors, or 'U' or 'L' for
+ * the stored triangle of a symmetric or, with herm, Hermitian N x N matrix. The norms are those of
+ * LAPACK xLANGE and xLANSY, computed from the elements converted to double without copying the
+ * matrices; the Frobenius norm accumulates a scaled sum of squares per column. When enabled, the
+ * error statistics of rocblas_error_stats.hpp are recorded as well.
+ */
+template <typename Tc, typename Tg>
+double norm_check_fused(char      norm_type,
+                        char      uplo,
+                        bool      herm,
+                        int64_t   M,
+                        int64_t   N,
+                        int64_t   lda,
+                        const Tc* hCPU,
+                        const Tg* hGPU)
+{
+    if(uplo)
+        M = N;
+
+    if(rocblas_error_stats_enabled())
+        rocblas_error_stats_record(rocblas_error_stats_collect(uplo, M, N, lda, hCPU, hGPU));
+
+    double cpu_norm  = 0.0;
+    double diff_norm = 0.0;
+    if(std::min(M, N) <= 0)
+        return diff_norm / cpu_norm;
+
+    int64_t offset = lda >= 0 ? 0 : lda * (1 - N);
+
+    // Element (i, j) of hCPU and of hGPU - hCPU, as real and imaginary parts
+    auto element = [&](int64_t i, int64_t j, double (&c)[2], double (&d)[2]) {
+        size_t idx = offset + i + j * lda;
+        for(int part = 0; part < 2; part++)
+        {
+            c[part] = rocblas_check_part(hCPU[idx], part);
+            d[part] = rocblas_check_part(hGPU[idx], part) - c[part];
+        }
+        if(herm && i == j)
+            c[1] = d[1] = 0;
+    };
+
+    auto magnitude
+        = [](const double(&x)[2]) { return x[1] ? std::hypot(x[0], x[1]) : std::abs(x[0]); };
+
+    // Stored part of column j
+    auto stored = [&](int64_t j, int64_t& begin, int64_t& end) {
+        begin = uplo == 'L' ? j : 0;
+        end   = uplo == 'U' ? j + 1 : M;
+    };
+
+    bool one = norm_type == 'O' || norm_type == 'o' || norm_type == '1';
+    bool inf = norm_type == 'I' || norm_type == 'i';
+
+    if(norm_type == 'F' || norm_type == 'f')
     {
-        y[y_offset + i * incy] = (*alpha) * x[x_offset + i * incx] + y[y_offset + i * incy];
+        // One scaled sum of squares per column, combined in order so the result does not depend
+        // on the number of threads; a triangle counts its off-diagonal elements twice
+        std::vector<norm_check_ssq> cpu_off(N), diff_off(N), cpu_diag(N), diff_diag(N);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for(int64_t j = 0; j < N; j++)
+        {
+            int64_t begin, end;
+            stored(j, begin, end);
+            for(int64_t i = begin; i < end; i++)
+            {
+                double c[2], d[2];
+                element(i, j, c, d);
+                bool diag = uplo && i == j;
+                for(int part = 0; part < 2; part++)
+                {
+                    (diag ? cpu_diag : cpu_off)[j].add(c[part]);
+                    (diag ? diff_diag : diff_off)[j].add(d[part]);
+                }
+            }
+        }
+
+        norm_check_ssq cpu, diff;
+        for(int64_t j = 0; j < N; j++)
+        {
+            cpu.add(cpu_off[j]);
+            diff.add(diff_off[j]);
+        }
+        if(uplo)
+        {
+            cpu.sumsq *= 2;
+            diff.sumsq *= 2;
+            for(int64_t j = 0; j < N; j++)
+            {
+                cpu.add(cpu_diag[j]);
+                diff.add(diff_diag[j]);
+            }
+        }
+        cpu_norm  = cpu.value();
+        diff_norm = diff.value();
+    }
+    else if(one || (inf && uplo))
+    {
+        // Column sums; the one and infinity norms of a symmetric matrix are the same
+        std::vector<double> cpu_sum(N), diff_sum(N);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for(int64_t j = 0; j < N; j++)
+        {
+            int64_t begin, end;
+            stored(j, begin, end);
+            for(int64_t i = begin; i < end; i++)
+            {
+                double c[2], d[2];
+                element(i, j, c, d);
+                cpu_sum[j] += magnitude(c);
+                diff_sum[j] += magnitude(d);
+            }
+
+            // The other triangle of column j is the stored part of row j
+            if(uplo)
+            {
+                for(int64_t k = uplo == 'U' ? j + 1 : 0; k < (uplo == 'U' ? N : j); k++)
+                {
+                    double c[2], d[2];
+                    element(j, k, c, d);
+                    cpu_sum[j] += magnitude(c);
+                    diff_sum[j] += magnitude(d);
+                }
+            }
+        }
+
+        for(int64_t j = 0; j < N; j++)
+        {
+            norm_check_max(cpu_norm, cpu_sum[j]);
+            norm_check_max(diff_norm, diff_sum[j]);
+        }
+    }
+    else if(inf)
+    {
+        // Row sums, over blocks of rows so each column is read contiguously
+        constexpr int64_t   NB      = 256;
+        int64_t             nblocks = (M + NB - 1) / NB;
+        std::vector<double> cpu_max(nblocks), diff_max(nblocks);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for(int64_t ib = 0; ib < nblocks; ib++)
+        {
+            int64_t i0 = ib * NB, i1 = std::min(M, i0 + NB);
+            double  cpu_sum[NB] = {}, diff_sum[NB] = {};
+            for(int64_t j = 0; j < N; j++)
+                for(int64_t i = i0; i < i1; i++)
+                {
+                    double c[2], d[2];
+                    element(i, j, c, d);
+                    cpu_sum[i - i0] += magnitude(c);
+                    diff_sum[i - i0] += magnitude(d);
+                }
+            for(int64_t i = 0; i < i1 - i0; i++)
+            {
+                norm_check_max(cpu_max[ib], cpu_sum[i]);
+                norm_check_max(diff_max[ib], diff_sum[i]);
+            }
+        }
+
+        for(int64_t ib = 0; ib < nblocks; ib++)
+        {
+            norm_check_max(cpu_norm, cpu_max[ib]);
+            norm_check_max(diff_norm, diff_max[ib]);
+        }
     }
+
+    return diff_norm / cpu_norm;
 }
 
 /* ============== Norm Check for General Matrix ============= */
@@ -67,34 +293,10 @@ double norm_check_general(char norm_type, int64_t M, int64_t N, int64_t lda, T*
     // one norm is max column sum
     // infinity norm is max row sum
     // Frobenius is l2 norm of matrix entries
-
-    host_vector<double> work(std::max(int64_t(1), M));
-    int64_t             incx  = 1;
-    double              alpha = -1.0;
-
-    size_t size = M * size_t(N); // copying data so lda is M
-
-    host_vector<double> hCPU_double(size);
-    host_vector<double> hGPU_double(size);
-
-    for(int64_t i = 0; i < N; i++)
-    {
-        int64_t src_col = i * int64_t(lda);
-        int64_t dst_col = i * int64_t(M);
-        for(int64_t j = 0; j < M; j++)
-        {
-            hCPU_double[size_t(dst_col + j)] = double(hCPU[src_col + j]);
-            hGPU_double[size_t(dst_col + j)] = double(hGPU[src_col + j]);
-        }
-    }
-
-    double cpu_norm = lapack_xlange(norm_type, M, N, hCPU_double.data(), M, work.data());
-    m_axpy_64(size, &alpha, hCPU_double.data(), incx, hGPU_double.data(), incx);
-    double error = lapack_xlange(norm_type, M, N, hGPU_double.data(), M, work.data()) / cpu_norm;
-    return error;
+    return norm_check_fused(norm_type, 0, false, M, N, lda, hCPU, hGPU);
 }
 
-// For F8 , we convert the results to float to double first
+// For F8, the elements are converted through float
 template <
     typename T,
     std::enable_if_t<(std::is_same<T, rocblas_f8>{} || std::is_same<T, rocblas_bf8>{}), int> = 0>
@@ -104,30 +306,7 @@ double norm_check_general(char norm_type, int64_t M, int64_t N, int64_t lda, T*
     // one norm is max column sum
     // infinity norm is max row sum
     // Frobenius is l2 norm of matrix entries
-    size_t size = M * size_t(N); // copying data so lda is M
-
-    host_vector<double> hCPU_double(size);
-    host_vector<double> hGPU_double(size);
-
-    for(int64_t i = 0; i < N; i++)
-    {
-        int64_t src_col = i * int64_t(lda);
-        int64_t dst_col = i * int64_t(M);
-        for(int64_t j = 0; j < M; j++)
-        {
-            hCPU_double[size_t(dst_col + j)] = double(float(hCPU[src_col + j]));
-            hGPU_double[size_t(dst_col + j)] = double(float(hGPU[src_col + j]));
-        }
-    }
-
-    host_vector<double> work(std::max(int64_t(1), M));
-    int64_t             incx  = 1;
-    double              alpha = -1.0;
-
-    double cpu_norm = lapack_xlange(norm_type, M, N, hCPU_double.data(), M, work.data());
-    m_axpy_64(size, &alpha, hCPU_double.data(), incx, hGPU_double.data(), incx);
-    double error = lapack_xlange(norm_type, M, N, hGPU_double.data(), M, work.data()) / cpu_norm;
-    return error;
+    return norm_check_fused(norm_type, 0, false, M, N, lda, hCPU, hGPU);
 }
 
 // Complex
@@ -138,41 +317,17 @@ double norm_check_general(char norm_type, int64_t M, int64_t N, int64_t lda, T*
     // one norm is max column sum
     // infinity norm is max row sum
     // Frobenius is l2 norm of matrix entries
-
-    host_vector<double> work(std::max(int64_t(1), M));
-    int64_t             incx  = 1;
-    T                   alpha = -1.0;
-    int64_t             size  = N * (int64_t)lda;
-
-    double cpu_norm = lapack_xlange(norm_type, M, N, hCPU, lda, work.data());
-    m_axpy_64(size, &alpha, hCPU, incx, hGPU, incx);
-    double error = lapack_xlange(norm_type, M, N, hGPU, lda, work.data()) / cpu_norm;
-
-    return error;
+    return norm_check_fused(norm_type, 0, false, M, N, lda, hCPU, hGPU);
 }
 
-// For BF16 and half, we convert the results to double first
+// For BF16 and half, the reference may be in a higher precision
 template <typename T,
           typename VEC,
           std::enable_if_t<std::is_same_v<T, rocblas_half> || std::is_same_v<T, rocblas_bfloat16>,
                            int> = 0>
 double norm_check_general(char norm_type, int64_t M, int64_t N, int64_t lda, VEC&& hCPU, T* hGPU)
 {
-    size_t              size = N * (size_t)lda;
-    host_vector<double> hCPU_double(size);
-    host_vector<double> hGPU_double(size);
-
-    for(int64_t i = 0; i < N; i++)
-    {
-        for(int64_t j = 0; j < M; j++)
-        {
-            size_t idx       = j + i * (size_t)lda;
-            hCPU_double[idx] = hCPU[idx];
-            hGPU_double[idx] = hGPU[idx];
-        }
-    }
-
-    return norm_check_general<double>(norm_type, M, N, lda, hCPU_double, hGPU_double);
+    return norm_check_fused(norm_type, 0, false, M, N, lda, &hCPU[0], hGPU);
 }
 
 /* ============== Norm Check for strided_batched case ============= */
@@ -329,68 +484,21 @@ template <typename T, std::enable_if_t<!rocblas_is_complex<T>, int> = 0, bool HE
 double norm_check_symmetric(char norm_type, char uplo, int64_t N, int64_t lda, T* hCPU, T* hGPU)
 {
     // norm type can be M', 'I', 'F', 'l': 'F' (Frobenius norm) is used mostly
-
-    host_vector<double> work(std::max(int64_t(1), N));
-    int64_t             incx  = 1;
-    double              alpha = -1.0;
-    size_t              size  = N * (size_t)lda;
-
-    host_vector<double> hCPU_double(size);
-    host_vector<double> hGPU_double(size);
-
-    for(int64_t i = 0; i < N; i++)
-    {
-        for(int64_t j = 0; j < N; j++)
-        {
-            size_t idx       = j + i * (size_t)lda;
-            hCPU_double[idx] = double(hCPU[idx]);
-            hGPU_double[idx] = double(hGPU[idx]);
-        }
-    }
-
-    double cpu_norm = lapack_xlansy<HERM>(norm_type, uplo, N, hCPU_double.data(), lda, work.data());
-    m_axpy_64(size, &alpha, hCPU_double.data(), incx, hGPU_double.data(), incx);
-    double error
-        = lapack_xlansy<HERM>(norm_type, uplo, N, hGPU_double.data(), lda, work.data()) / cpu_norm;
-
-    return error;
+    return norm_check_fused(norm_type, uplo, HERM, N, N, lda, hCPU, hGPU);
 }
 
 template <typename T, std::enable_if_t<rocblas_is_complex<T>, int> = 0, bool HERM = false>
 double norm_check_symmetric(char norm_type, char uplo, int64_t N, int64_t lda, T* hCPU, T* hGPU)
 {
     // norm type can be M', 'I', 'F', 'l': 'F' (Frobenius norm) is used mostly
-    host_vector<double> work(std::max(int64_t(1), N));
-    int64_t             incx  = 1;
-    T                   alpha = -1.0;
-    size_t              size  = (size_t)lda * N;
-
-    double cpu_norm = lapack_xlansy<HERM>(norm_type, uplo, N, hCPU, lda, work.data());
-    m_axpy_64(size, &alpha, hCPU, incx, hGPU, incx);
-    double error = lapack_xlansy<HERM>(norm_type, uplo, N, hGPU, lda, work.data()) / cpu_norm;
-
-    return error;
+    return norm_check_fused(norm_type, uplo, HERM, N, N, lda, hCPU, hGPU);
 }
 
 template <>
 inline double norm_check_symmetric(
     char norm_type, char uplo, int64_t N, int64_t lda, rocblas_half* hCPU, rocblas_half* hGPU)
 {
-    size_t              size = N * (size_t)lda;
-    host_vector<double> hCPU_double(size);
-    host_vector<double> hGPU_double(size);
-
-    for(int64_t i = 0; i < N; i++)
-    {
-        for(int64_t j = 0; j < N; j++)
-        {
-            size_t idx       = j + i * (size_t)lda;
-            hCPU_double[idx] = hCPU[idx];
-            hGPU_double[idx] = hGPU[idx];
-        }
-    }
-
-    return norm_check_symmetric(norm_type, uplo, N, lda, hCPU_double.data(), hGPU_double.data());
+    return norm_check_fused(norm_type, uplo, false, N, N, lda, hCPU, hGPU);
 }
 
 template <typename T, bool HERM = false>
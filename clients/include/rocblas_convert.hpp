@@ -0,0 +1,101 @@
+/* ************************************************************************
+ * Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell cop-
+ * ies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM-
+ * PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNE-
+ * CTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ************************************************************************ */
+
+/*!\file
+ * \brief Bulk host conversions between float and the reduced precision types.
+ */
+
+#pragma once
+
+#include "rocblas.h"
+#include <cstddef>
+#include <cstdint>
+
+//!
+//! @brief Rounding of the bulk down conversions. rocblas_f8 and rocblas_bf8 only have standard
+//! (near_even) and stochastic rounding, near_zero and truncate fall back to standard for them.
+//! Stochastic rounding draws a counter based random value from the seed and the element index,
+//! so results do not depend on how the work is split between threads.
+//!
+enum class rocblas_convert_round
+{
+    near_even,
+    near_zero,
+    truncate,
+    stochastic
+};
+
+inline rocblas_convert_round rocblas_convert_round_from(rocblas_bfloat16::rocblas_truncate_t round)
+{
+    switch(round)
+    {
+    case rocblas_bfloat16::rocblas_truncate:
+        return rocblas_convert_round::truncate;
+    case rocblas_bfloat16::rocblas_round_near_zero:
+        return rocblas_convert_round::near_zero;
+    default:
+        return rocblas_convert_round::near_even;
+    }
+}
+
+//!
+//! @brief dst[i] = src[i] converted, for i < n. Large spans are split over OpenMP threads and use
+//! F16C / AVX-512 instructions for rocblas_half when the host supports them. rocblas_f8 and
+//! rocblas_bf8 are decoded through a 256 entry table. Results are bitwise identical to the
+//! scalar conversion operators with the same rounding.
+//!
+void rocblas_convert(const rocblas_half* src, float* dst, size_t n);
+void rocblas_convert(const float* src, rocblas_half* dst, size_t n);
+
+void rocblas_convert(const rocblas_bfloat16* src, float* dst, size_t n);
+void rocblas_convert(const float*          src,
+                     rocblas_bfloat16*     dst,
+                     size_t                n,
+                     rocblas_convert_round round = rocblas_convert_round::near_even,
+                     uint32_t              seed  = 0);
+
+void rocblas_convert(const rocblas_f8* src, float* dst, size_t n);
+void rocblas_convert(const float*          src,
+                     rocblas_f8*           dst,
+                     size_t                n,
+                     rocblas_convert_round round = rocblas_convert_round::near_even,
+                     uint32_t              seed  = 0);
+
+void rocblas_convert(const rocblas_bf8* src, float* dst, size_t n);
+void rocblas_convert(const float*          src,
+                     rocblas_bf8*          dst,
+                     size_t                n,
+                     rocblas_convert_round round = rocblas_convert_round::near_even,
+                     uint32_t              seed  = 0);
+
+//!
+//! @brief Any other pair of types, converted element by element with static_cast.
+//!
+template <typename Ts, typename Td>
+void rocblas_convert(const Ts* src, Td* dst, size_t n)
+{
+#ifdef _OPENMP
+#pragma omp parallel for if(n >= (size_t(1) << 16))
+#endif
+    for(size_t i = 0; i < n; i++)
+        dst[i] = static_cast<Td>(src[i]);
+}
@@ -24,73 +24,70 @@
 
 #include "rocblas_arguments.hpp"
 #include "test_cleanup.hpp"
-#include <cerrno>
-#include <cstdio>
+#include <cstddef>
 #include <cstdlib>
 #include <cstring>
-#include <fstream>
-#include <functional>
-#include <iostream>
 #include <iterator>
+#include <memory>
 #include <string>
 #include <utility>
-
-#if __has_include(<filesystem>)
-#include <filesystem>
-namespace fs = std::filesystem;
-#elif __has_include(<experimental/filesystem>)
-#include <experimental/filesystem>
-namespace fs = std::experimental::filesystem;
-#else
-#error no filesystem found
-#endif
+#include <vector>
 
 // Class used to read Arguments data into the tests
+//
+// The data file, or the temporary file expanded from YAML, is mapped once and indexed by function
+// name, category and precision, so that a filter on the function only visits the records of the
+// functions which it accepts. With set_shard(), only a contiguous slice of the records is indexed;
+// with set_worker(), only the records which a cost-balanced schedule assigns to one worker.
 class RocBLAS_TestData
 {
-    // data filename
-    static auto& filename()
-    {
-        static std::string filename
-            = "(Uninitialized data. RocBLAS_TestData::set_filename needs to be called first.)";
-        return filename;
-    }
+public:
+    // Numbers of the records selected by begin()
+    using selection = std::shared_ptr<const std::vector<size_t>>;
 
     // filter iterator
-    class iterator : public std::istream_iterator<Arguments>
+    class iterator
     {
-        bool (*const filter)(const Arguments&) = nullptr;
+        bool (*filter)(const Arguments&) = nullptr;
+        selection records;
+        size_t    pos = 0;
+        Arguments arg;
 
-        // Skip entries for which validate or filter returns false
-        void skip_filter()
+        bool at_end() const
         {
-            static auto endIter = std::istream_iterator<Arguments>{};
-
-            // warning we may update the Arguments in validate, thus the const_cast
-            while(*this != endIter && !(const_cast<Arguments&>(**this).validate()))
-                ++*static_cast<std::istream_iterator<Arguments>*>(this);
-
-            if(filter)
-                while(*this != endIter && !filter(**this))
-                    ++*static_cast<std::istream_iterator<Arguments>*>(this);
+            return !records || pos >= records->size();
         }
 
+        // Skip entries for which validate or filter returns false
+        void skip_filter();
+
     public:
-        // Constructor takes a filter and iterator
-        iterator(bool filter(const Arguments&), std::istream_iterator<Arguments> iter)
-            : std::istream_iterator<Arguments>(iter)
-            , filter(filter)
-        {
-            skip_filter();
-        }
+        using iterator_category = std::input_iterator_tag;
+        using value_type        = Arguments;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const Arguments*;
+        using reference         = const Arguments&;
+
+        // Constructor takes a filter and the records to iterate over
+        iterator(bool filter(const Arguments&), selection records);
 
         // Default end iterator and nullptr filter
         iterator() = default;
 
+        reference operator*() const
+        {
+            return arg;
+        }
+
+        pointer operator->() const
+        {
+            return &arg;
+        }
+
         // Preincrement iterator operator with filtering
         iterator& operator++()
         {
-            ++*static_cast<std::istream_iterator<Arguments>*>(this);
+            ++pos;
             skip_filter();
             return *this;
         }
@@ -99,52 +96,33 @@ class RocBLAS_TestData
         // We delete it here so that the base class's isn't silently called
         // To implement it, use "auto old = *this; ++*this; return old;"
         iterator operator++(int) = delete;
-    };
 
-public:
-    // Initialize filename, optionally removing it at exit
-    static void set_filename(std::string name, bool remove_atexit = false)
-    {
-        filename() = std::move(name);
-        if(remove_atexit)
+        bool operator==(const iterator& rhs) const
         {
-            auto cleanup = [] { fs::remove(filename().c_str()); };
-            atexit(cleanup);
-            at_quick_exit(cleanup);
+            return at_end() ? rhs.at_end() : records == rhs.records && pos == rhs.pos;
         }
-    }
-
-    // begin() iterator which accepts an optional filter.
-    static iterator begin(bool filter(const Arguments&) = nullptr)
-    {
-        static std::ifstream* ifs = nullptr;
 
-        // If this is the first time, or after test_cleanup::cleanup() has been called
-        if(!ifs)
+        bool operator!=(const iterator& rhs) const
         {
-            std::string fileToOpen = filename();
-            // Allocate a std::ifstream and register it to be deleted during cleanup
-            ifs = test_cleanup::allocate(
-                &ifs, fileToOpen, std::ifstream::in | std::ifstream::binary);
-            if(!ifs || ifs->fail())
-            {
-                rocblas_cerr << "Cannot open " << fileToOpen << ": " << strerror(errno)
-                             << std::endl;
-                exit(EXIT_FAILURE);
-            }
+            return !(*this == rhs);
         }
+    };
 
-        // We re-seek the file back to position 0
-        ifs->clear();
-        ifs->seekg(0);
+    // Initialize filename, optionally removing it at exit
+    static void set_filename(std::string name, bool remove_atexit = false);
 
-        // Validate the data file format
-        Arguments::validate(*ifs);
+    // Restrict the data to shard index of count contiguous slices of the records
+    static void set_shard(size_t index, size_t count);
 
-        // We create a filter iterator which will choose only the test cases we want right now.
-        // This is to preserve Gtest structure while not creating no-op tests which "always pass".
-        return iterator(filter, std::istream_iterator<Arguments>(*ifs));
-    }
+    // Restrict the data to the records of worker index of count, which are balanced by their
+    // estimated cost within each group of records with the same function, category and precision
+    static void set_worker(size_t index, size_t count);
+
+    // begin() iterator which accepts an optional filter, and an optional function_filter which
+    // selects whole groups of records with the same function, category and precision, and so may
+    // only look at those fields
+    static iterator begin(bool filter(const Arguments&)          = nullptr,
+                          bool function_filter(const Arguments&) = nullptr);
 
     // end() iterator
     static iterator end()
@@ -0,0 +1,188 @@
+/* ************************************************************************
+ * Copyright (C) 2018-2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell cop-
+ * ies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM-
+ * PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNE-
+ * CTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ************************************************************************/
+
+/*!\file
+ * \brief Opt-in error distribution of the results checked with the norm check.
+ *
+ * With rocblas-bench --log_error_stats, every matrix compared by norm_check_general or
+ * norm_check_symmetric is also measured element by element: the distance in units in the last
+ * place (ULPs) of the result type, the relative error, and the positions of the worst elements.
+ * The statistics of all the matrices checked for one bench line are reported in its CSV output
+ * after the norm_error columns. They are collected in histograms in the same parallel pass, so the
+ * percentiles are the upper bounds of histogram bins; the maxima are exact.
+ */
+
+#pragma once
+
+#include "bulk_check.hpp"
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+struct rocblas_error_stats
+{
+    // ULP distance bins: 0, 1, [2, 4), ..., [2^63, 2^64), and a NaN where the reference has none
+    static constexpr int      ulp_bins = 66;
+    static constexpr int      ulp_nan  = ulp_bins - 1;
+    static constexpr uint64_t nan_ulps = std::numeric_limits<uint64_t>::max();
+
+    // Relative error bins: 0, then 4 per binade from 2^-64 to 2^16, and infinite or NaN
+    static constexpr int rel_min_exp = -63;
+    static constexpr int rel_max_exp = 16;
+    static constexpr int rel_sub     = 4;
+    static constexpr int rel_bins    = 2 + (rel_max_exp - rel_min_exp + 1) * rel_sub;
+
+    // Number of worst elements whose positions are reported
+    static constexpr size_t reported = 3;
+
+    struct element
+    {
+        int64_t  matrix, row, col;
+        uint64_t ulps;
+    };
+
+    int64_t              matrices = 0;
+    int64_t              elements = 0;
+    uint64_t             ulp_max  = 0;
+    double               rel_max  = 0;
+    int64_t              ulp_hist[ulp_bins] = {};
+    int64_t              rel_hist[rel_bins] = {};
+    std::vector<element> worst; // largest ULP distances, first in storage order on ties
+
+    void add(int64_t matrix, int64_t row, int64_t col, uint64_t ulps, double rel);
+
+    // Adds the statistics of other, whose matrices are numbered after those of this
+    void merge(const rocblas_error_stats& other);
+
+    // Values of the CSV columns named by rocblas_error_stats_columns
+    std::vector<std::string> columns() const;
+};
+
+//! @brief Names of the CSV columns of the error statistics.
+extern const char* const rocblas_error_stats_columns[];
+extern const size_t      rocblas_error_stats_column_count;
+
+//! @brief Enables the collection of error statistics by the norm check.
+void rocblas_error_stats_enable(bool enable);
+bool rocblas_error_stats_enabled();
+
+//! @brief Adds the statistics of one checked matrix, or batch of matrices, to those collected.
+void rocblas_error_stats_record(const rocblas_error_stats& stats);
+
+//! @brief Moves the statistics collected since the last call into stats.
+//! @return false when nothing has been collected.
+bool rocblas_error_stats_take(rocblas_error_stats& stats);
+
+// Number of steps between adjacent values of T from a to b; for complex types, the larger of the
+// distances of the real and imaginary parts
+template <typename T>
+inline uint64_t rocblas_ulp_distance(T a, T b)
+{
+    if constexpr(rocblas_is_complex<T>)
+        return std::max(rocblas_ulp_distance(std::real(a), std::real(b)),
+                        rocblas_ulp_distance(std::imag(a), std::imag(b)));
+    else if constexpr(std::is_integral<T>{})
+        return a > b ? uint64_t(a) - uint64_t(b) : uint64_t(b) - uint64_t(a);
+    else
+    {
+        static_assert(sizeof(T) <= sizeof(uint64_t));
+        constexpr int      width = 8 * sizeof(T);
+        constexpr uint64_t mask  = (uint64_t(1) << (width - 1)) - 1;
+
+        uint64_t bits[2] = {};
+        memcpy(&bits[0], &a, sizeof(T));
+        memcpy(&bits[1], &b, sizeof(T));
+        uint64_t mag[2] = {bits[0] & mask, bits[1] & mask};
+        bool     neg[2] = {bool(bits[0] >> (width - 1)), bool(bits[1] >> (width - 1))};
+
+        if(neg[0] != neg[1])
+            return mag[0] + mag[1];
+        return mag[0] > mag[1] ? mag[0] - mag[1] : mag[1] - mag[0];
+    }
+}
+
+/*! \brief Error statistics of hGPU against the reference hCPU
+ *
+ * uplo is 0 for a general M x N matrix, whose lda may be negative for vectors, or 'U' or 'L' for
+ * the stored triangle of an N x N matrix. A reference of another type is rounded to the type of
+ * hGPU before measuring ULPs; the relative error uses the unrounded reference.
+ */
+template <typename Tc, typename Tg>
+rocblas_error_stats rocblas_error_stats_collect(
+    char uplo, int64_t M, int64_t N, int64_t lda, const Tc* hCPU, const Tg* hGPU)
+{
+    if(uplo)
+        M = N;
+
+    // Columns are merged as parts of matrix 0, which is counted once at the end
+    rocblas_error_stats stats;
+    int64_t             offset = lda >= 0 ? 0 : lda * (1 - N);
+
+#ifdef _OPENMP
+#pragma omp parallel if(std::min(M, N) > 0)
+#endif
+    {
+        rocblas_error_stats local;
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic) nowait
+#endif
+        for(int64_t j = 0; j < (M > 0 ? N : 0); j++)
+        {
+            int64_t begin = uplo == 'L' ? j : 0;
+            int64_t end   = uplo == 'U' ? j + 1 : M;
+            for(int64_t i = begin; i < end; i++)
+            {
+                size_t    idx = offset + i + j * lda;
+                const Tc& c   = hCPU[idx];
+                const Tg& g   = hGPU[idx];
+
+                uint64_t ulps;
+                if(rocblas_isnan(c) || rocblas_isnan(g))
+                    ulps = rocblas_isnan(c) && rocblas_isnan(g) ? 0 : rocblas_error_stats::nan_ulps;
+                else if constexpr(std::is_same<Tc, Tg>{})
+                    ulps = rocblas_ulp_distance(c, g);
+                else
+                    ulps = rocblas_ulp_distance(Tg(c), g);
+
+                double cr  = rocblas_check_part(c, 0);
+                double ci  = rocblas_check_part(c, 1);
+                double dr  = rocblas_check_part(g, 0) - cr;
+                double di  = rocblas_check_part(g, 1) - ci;
+                double err = std::hypot(dr, di);
+                double ref = std::hypot(cr, ci);
+
+                local.add(0, i, j, ulps, err == 0 ? 0 : err / ref);
+            }
+        }
+
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+        stats.merge(local);
+    }
+
+    stats.matrices = 1;
+    return stats;
+}
@@ -0,0 +1,47 @@
+/* ************************************************************************
+ * Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell cop-
+ * ies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM-
+ * PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNE-
+ * CTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ************************************************************************ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+/*!\file
+ * \brief In-process expansion of YAML test data into Arguments.
+ *
+ * rocblas_gentest() follows the rules of rocblas_gentest.py: include: lines, Datatypes, Arguments,
+ * Defaults, Dictionary lists to expand, Lists to not expand, Known bugs, Functions, the cartesian
+ * product of lists and A..B[..C] ranges, and the dynamic defaults of setdefaults(). The YAML parser
+ * covers the block and flow styles, anchors, aliases and merge keys used by the test data; block
+ * scalars, tags and complex keys are reported as errors.
+ */
+
+// Expands the YAML file yaml, preceded by template_file when it is not empty, into the file output,
+// as Arguments records in the binary format written by rocblas_gentest.py, header and signature
+// included. The records are streamed to the file as they are generated, so that expansions as large
+// as that of rocblas_gtest.yaml are not held in memory. include: lines are searched for in the
+// directory of the including file, then in include_dirs, as with the -I option of
+// rocblas_gentest.py. Prints the error and exits on failure.
+void rocblas_gentest(const std::string&              yaml,
+                     const std::string&              output,
+                     const std::string&              template_file = "",
+                     const std::vector<std::string>& include_dirs  = {});
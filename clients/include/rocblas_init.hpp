@@ -27,6 +27,7 @@
 #include "rocblas.h"
 #include "rocblas_math.hpp"
 #include "rocblas_random.hpp"
+#include <algorithm>
 #include <cinttypes>
 #include <iostream>
 #ifdef _OPENMP
@@ -50,6 +51,149 @@ typedef enum rocblas_check_nan_init_
 
 } rocblas_check_nan_init;
 
+/* ============================================================================================ */
+/*! \brief  matrix initialization engine */
+
+// Calls column(b, j, A(b) + j * lda) for the n columns of the matrices of batch members
+// b < batch_count, with the OpenMP threads spread over batch member x column block pairs. column
+// sets the entries of the column, and must only depend on its arguments, as with
+// rocblas_random_source.
+template <typename Ptr, typename F>
+void rocblas_init_matrix_columns(int64_t batch_count, int64_t n, int64_t lda, Ptr&& A, F&& column)
+{
+    constexpr int64_t NB     = 16;
+    int64_t           blocks = (n + NB - 1) / NB;
+
+#ifdef _OPENMP
+#pragma omp parallel for collapse(2) schedule(dynamic)
+#endif
+    for(int64_t b = 0; b < batch_count; b++)
+        for(int64_t jb = 0; jb < blocks; jb++)
+        {
+            auto* Ab = A(b);
+            for(int64_t j = jb * NB; j < std::min(n, jb * NB + NB); j++)
+                column(b, j, Ab + j * lda);
+        }
+}
+
+// Rows 0 to m - 1 of column j of batch member b of a random matrix of the given type, where element
+// (i, j) is random(b, i, j). A hermitian or symmetric matrix draws element (max(i, j), min(i, j))
+// for both triangles and keeps only the triangle named by uplo, or both for any other uplo; a
+// triangular one keeps the triangle named by uplo. The rows drawn from column j are filled as one
+// run.
+template <typename T>
+void rocblas_init_matrix_column(rocblas_check_matrix_type       matrix_type,
+                                char                            uplo,
+                                const rocblas_random_source<T>& random,
+                                int64_t                         b,
+                                int64_t                         j,
+                                int64_t                         m,
+                                T*                              Aj)
+{
+    if(matrix_type == rocblas_client_hermitian_matrix
+       || matrix_type == rocblas_client_symmetric_matrix)
+    {
+        bool hermitian = matrix_type == rocblas_client_hermitian_matrix;
+
+        // Above the diagonal, element (i, j) is element (j, i) of column i
+        for(int64_t i = 0; i < std::min(j, m); i++)
+            Aj[i] = uplo == 'L' ? T(0) : random(b, j, i);
+
+        if(j >= m)
+            return;
+
+        if(uplo == 'U')
+        {
+            Aj[j] = random(b, j, j);
+            std::fill(Aj + j + 1, Aj + m, T(0));
+        }
+        else
+            random.fill(b, j, j, m - j, Aj + j, 1);
+
+        if(hermitian)
+        {
+            Aj[j] = T(std::real(Aj[j]));
+            if(uplo != 'L' && uplo != 'U')
+                for(int64_t i = j + 1; i < m; i++)
+                    Aj[i] = conjugate(Aj[i]);
+        }
+        return;
+    }
+
+    int64_t lo = 0, hi = m;
+    if(matrix_type == rocblas_client_triangular_matrix
+       || matrix_type == rocblas_client_diagonally_dominant_triangular_matrix)
+    {
+        if(uplo == 'U')
+            hi = std::min(m, j + 1);
+        else
+            lo = std::min(m, j);
+    }
+
+    std::fill(Aj, Aj + lo, T(0));
+    random.fill(b, j, lo, hi - lo, Aj + lo, 1);
+    std::fill(Aj + hi, Aj + m, T(0));
+}
+
+/*An n x n triangle matrix with random entries has a condition number that grows exponentially with n ("Condition numbers of random triangular matrices" D. Viswanath and L.N.Trefethen).
+Here we use a triangle matrix with random values that is strictly row and column diagonal dominant.
+This matrix should have a lower condition number. An alternative is to calculate the Cholesky factor of an SPD matrix with random values and make it diagonal dominant.
+This approach is not used because it is slow.*/
+template <typename T>
+void rocblas_init_diagonally_dominant(char uplo, T* A, size_t N, size_t lda)
+{
+    const T multiplier = T(
+        1.01); // Multiplying factor to slightly increase the base value of (abs_sum_off_diagonal_row + abs_sum_off_diagonal_col) dominant diagonal element. If tests fail and it seems that there are numerical stability problems, try increasing multiplier, it should decrease the condition number of the matrix and thereby avoid numerical stability issues.
+
+    if(uplo == 'U') // rocblas_fill_upper
+    {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for(size_t i = 0; i < N; i++)
+        {
+            T abs_sum_off_diagonal_row
+                = T(0); //store absolute sum of entire row of the particular diagonal element
+            T abs_sum_off_diagonal_col
+                = T(0); //store absolute sum of entire column of the particular diagonal element
+
+            for(size_t j = i + 1; j < N; j++)
+                abs_sum_off_diagonal_row += rocblas_abs(A[i + j * lda]);
+            for(size_t j = 0; j < i; j++)
+                abs_sum_off_diagonal_col += rocblas_abs(A[j + i * lda]);
+
+            A[i + i * lda]
+                = (abs_sum_off_diagonal_row + abs_sum_off_diagonal_col) == T(0)
+                      ? T(1)
+                      : T((abs_sum_off_diagonal_row + abs_sum_off_diagonal_col) * multiplier);
+        }
+    }
+    else // rocblas_fill_lower
+    {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for(size_t j = 0; j < N; j++)
+        {
+            T abs_sum_off_diagonal_row
+                = T(0); //store absolute sum of entire row of the particular diagonal element
+            T abs_sum_off_diagonal_col
+                = T(0); //store absolute sum of entire column of the particular diagonal element
+
+            for(size_t i = j + 1; i < N; i++)
+                abs_sum_off_diagonal_col += rocblas_abs(A[i + j * lda]);
+
+            for(size_t i = 0; i < j; i++)
+                abs_sum_off_diagonal_row += rocblas_abs(A[j + i * lda]);
+
+            A[j + j * lda]
+                = (abs_sum_off_diagonal_row + abs_sum_off_diagonal_col) == T(0)
+                      ? T(1)
+                      : T((abs_sum_off_diagonal_row + abs_sum_off_diagonal_col) * multiplier);
+        }
+    }
+}
+
 // Initialize matrix so adjacent entries have alternating sign.
 // In gemm if either A or B are initialized with alternating
 // sign the reduction sum will be summing positive
@@ -69,33 +213,22 @@ void rocblas_init_matrix_alternating_sign(rocblas_check_matrix_type matrix_type,
                                           rocblas_stride            stride      = 0,
                                           int64_t                   batch_count = 1)
 {
-    if(matrix_type == rocblas_client_general_matrix)
-    {
-        for(size_t b = 0; b < batch_count; b++)
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-            for(size_t i = 0; i < M; ++i)
-                for(size_t j = 0; j < N; ++j)
-                {
-                    auto value                  = rand_gen();
-                    A[i + j * lda + b * stride] = (i ^ j) & 1 ? T(value) : T(negate(value));
-                }
-    }
-    else if(matrix_type == rocblas_client_triangular_matrix)
-    {
-        for(size_t b = 0; b < batch_count; b++)
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-            for(size_t i = 0; i < M; ++i)
-                for(size_t j = 0; j < N; ++j)
-                {
-                    auto value
-                        = uplo == 'U' ? (j >= i ? rand_gen() : 0) : (j <= i ? rand_gen() : 0);
-                    A[i + j * lda + b * stride] = (i ^ j) & 1 ? T(value) : T(negate(value));
-                }
-    }
+    if(matrix_type != rocblas_client_general_matrix
+       && matrix_type != rocblas_client_triangular_matrix)
+        return;
+
+    rocblas_random_source<T> random(rand_gen);
+
+    rocblas_init_matrix_columns(
+        batch_count,
+        N,
+        lda,
+        [&](int64_t b) { return A.data() + b * stride; },
+        [&](int64_t b, int64_t j, T* Aj) {
+            rocblas_init_matrix_column(matrix_type, uplo, random, b, j, int64_t(M), Aj);
+            for(int64_t i = j & 1; i < int64_t(M); i += 2)
+                Aj[i] = T(negate(Aj[i]));
+        });
 }
 
 template <typename U, typename T>
@@ -104,39 +237,35 @@ void rocblas_init_matrix_alternating_sign(rocblas_check_matrix_type matrix_type,
                                           T                         rand_gen(),
                                           U&                        hA)
 {
-    for(int64_t batch_index = 0; batch_index < hA.batch_count(); ++batch_index)
-    {
-        auto* A   = hA[batch_index];
-        auto  M   = hA.m();
-        auto  N   = hA.n();
-        auto  lda = hA.lda();
+    if(matrix_type != rocblas_client_general_matrix
+       && matrix_type != rocblas_client_triangular_matrix)
+        return;
+
+    rocblas_random_source<T> random(rand_gen);
+
+    rocblas_init_matrix_columns(
+        hA.batch_count(),
+        hA.n(),
+        hA.lda(),
+        [&](int64_t b) { return hA[b]; },
+        [&](int64_t b, int64_t j, T* Aj) {
+            rocblas_init_matrix_column(matrix_type, uplo, random, b, j, int64_t(hA.m()), Aj);
+            for(int64_t i = j & 1; i < int64_t(hA.m()); i += 2)
+                Aj[i] = T(negate(Aj[i]));
+        });
+}
+
+// Sets x[j * incx] = random(0, j, 0) for j < N, with the OpenMP threads filling runs of entries
+template <typename T>
+void rocblas_init_vector_runs(const rocblas_random_source<T>& random, T* x, int64_t N, int64_t incx)
+{
+    constexpr int64_t RUN = 4096;
 
-        if(matrix_type == rocblas_client_general_matrix)
-        {
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-            for(size_t i = 0; i < M; ++i)
-                for(size_t j = 0; j < N; ++j)
-                {
-                    auto value     = rand_gen();
-                    A[i + j * lda] = (i ^ j) & 1 ? T(value) : T(negate(value));
-                }
-        }
-        else if(matrix_type == rocblas_client_triangular_matrix)
-        {
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
-            for(size_t i = 0; i < M; ++i)
-                for(size_t j = 0; j < N; ++j)
-                {
-                    auto value
-                        = uplo == 'U' ? (j >= i ? rand_gen() : T(0)) : (j <= i ? rand_gen() : T(0));
-                    A[i + j * lda] = (i ^ j) & 1 ? T(value) : T(negate(value));
-                }
-        }
-    }
+    for(int64_t j = 0; j < N; j += RUN)
+        random.fill(0, 0, j, std::min(RUN, N - j), x + j * incx, incx);
 }
 
 // Initialize vector so adjacent entries have alternating sign.
@@ -146,14 +275,15 @@ void rocblas_init_vector_alternating_sign(T rand_gen(), T* x, int64_t N, int64_t
     if(incx < 0)
         x -= (N - 1) * incx;
 
+    rocblas_random_source<T> random(rand_gen);
+
+    rocblas_init_vector_runs(random, x, N, incx);
+
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
-    for(int64_t j = 0; j < N; ++j)
-    {
-        auto value  = rand_gen();
-        x[j * incx] = j & 1 ? T(value) : T(negate(value));
-    }
+    for(int64_t j = 0; j < N; j += 2)
+        x[j * incx] = T(negate(x[j * incx]));
 }
 
 /* ============================================================================================ */
@@ -171,158 +301,25 @@ void rocblas_init_matrix(rocblas_check_matrix_type matrix_type,
                          rocblas_stride            stride      = 0,
                          int64_t                   batch_count = 1)
 {
-    if(matrix_type == rocblas_client_general_matrix)
-    {
-        for(size_t b = 0; b < batch_count; b++)
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-            for(size_t i = 0; i < M; ++i)
-                for(size_t j = 0; j < N; ++j)
-                    A[i + j * lda + b * stride] = rand_gen();
-    }
-    else if(matrix_type == rocblas_client_hermitian_matrix)
-    {
-        for(size_t b = 0; b < batch_count; ++b)
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-            for(size_t i = 0; i < N; ++i)
-                for(size_t j = 0; j <= i; ++j)
-                {
-                    auto value = rand_gen();
-                    if(i == j)
-                        A[b * stride + j + i * lda] = std::real(value);
-                    else if(uplo == 'U')
-                    {
-                        A[b * stride + j + i * lda] = value;
-                        A[b * stride + i + j * lda] = T(0);
-                    }
-                    else if(uplo == 'L')
-                    {
-                        A[b * stride + j + i * lda] = T(0);
-                        A[b * stride + i + j * lda] = value;
-                    }
-                    else
-                    {
-                        A[b * stride + j + i * lda] = value;
-                        A[b * stride + i + j * lda] = conjugate(value);
-                    }
-                }
-    }
-    else if(matrix_type == rocblas_client_symmetric_matrix)
-    {
-        for(size_t b = 0; b < batch_count; ++b)
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-            for(size_t i = 0; i < N; ++i)
-                for(size_t j = 0; j <= i; ++j)
-                {
-                    auto value = rand_gen();
-                    if(i == j)
-                        A[b * stride + j + i * lda] = value;
-                    else if(uplo == 'U')
-                    {
-                        A[b * stride + j + i * lda] = value;
-                        A[b * stride + i + j * lda] = T(0);
-                    }
-                    else if(uplo == 'L')
-                    {
-                        A[b * stride + j + i * lda] = T(0);
-                        A[b * stride + i + j * lda] = value;
-                    }
-                    else
-                    {
-                        A[b * stride + j + i * lda] = value;
-                        A[b * stride + i + j * lda] = value;
-                    }
-                }
-    }
-    else if(matrix_type == rocblas_client_triangular_matrix)
-    {
-        for(size_t b = 0; b < batch_count; b++)
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-            for(size_t i = 0; i < M; ++i)
-                for(size_t j = 0; j < N; ++j)
-                {
-                    auto value
-                        = uplo == 'U' ? (j >= i ? rand_gen() : T(0)) : (j <= i ? rand_gen() : T(0));
-                    A[i + j * lda + b * stride] = value;
-                }
-    }
-
-    /*An n x n triangle matrix with random entries has a condition number that grows exponentially with n ("Condition numbers of random triangular matrices" D. Viswanath and L.N.Trefethen).
-    Here we use a triangle matrix with random values that is strictly row and column diagonal dominant.
-    This matrix should have a lower condition number. An alternative is to calculate the Cholesky factor of an SPD matrix with random values and make it diagonal dominant.
-    This approach is not used because it is slow.*/
+    // Hermitian and symmetric matrices are N x N; the diagonally dominant matrix is not batched
+    bool square = matrix_type == rocblas_client_hermitian_matrix
+                  || matrix_type == rocblas_client_symmetric_matrix;
+    bool single = matrix_type == rocblas_client_diagonally_dominant_triangular_matrix;
 
-    else if(matrix_type == rocblas_client_diagonally_dominant_triangular_matrix)
-    {
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-        for(size_t i = 0; i < M; ++i)
-            for(size_t j = 0; j < N; ++j)
-            {
-                auto value
-                    = uplo == 'U' ? (j >= i ? rand_gen() : T(0)) : (j <= i ? rand_gen() : T(0));
-                A[i + j * lda] = value;
-            }
+    rocblas_random_source<T> random(rand_gen);
 
-        const T multiplier = T(
-            1.01); // Multiplying factor to slightly increase the base value of (abs_sum_off_diagonal_row + abs_sum_off_diagonal_col) dominant diagonal element. If tests fail and it seems that there are numerical stability problems, try increasing multiplier, it should decrease the condition number of the matrix and thereby avoid numerical stability issues.
+    rocblas_init_matrix_columns(
+        single ? 1 : batch_count,
+        N,
+        lda,
+        [&](int64_t b) { return A.data() + b * stride; },
+        [&](int64_t b, int64_t j, T* Aj) {
+            rocblas_init_matrix_column(
+                matrix_type, uplo, random, b, j, int64_t(square ? N : M), Aj);
+        });
 
-        if(uplo == 'U') // rocblas_fill_upper
-        {
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-            for(size_t i = 0; i < N; i++)
-            {
-                T abs_sum_off_diagonal_row
-                    = T(0); //store absolute sum of entire row of the particular diagonal element
-                T abs_sum_off_diagonal_col
-                    = T(0); //store absolute sum of entire column of the particular diagonal element
-
-                for(size_t j = i + 1; j < N; j++)
-                    abs_sum_off_diagonal_row += rocblas_abs(A[i + j * lda]);
-                for(size_t j = 0; j < i; j++)
-                    abs_sum_off_diagonal_col += rocblas_abs(A[j + i * lda]);
-
-                A[i + i * lda]
-                    = (abs_sum_off_diagonal_row + abs_sum_off_diagonal_col) == T(0)
-                          ? T(1)
-                          : T((abs_sum_off_diagonal_row + abs_sum_off_diagonal_col) * multiplier);
-            }
-        }
-        else // rocblas_fill_lower
-        {
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-            for(size_t j = 0; j < N; j++)
-            {
-                T abs_sum_off_diagonal_row
-                    = T(0); //store absolute sum of entire row of the particular diagonal element
-                T abs_sum_off_diagonal_col
-                    = T(0); //store absolute sum of entire column of the particular diagonal element
-
-                for(size_t i = j + 1; i < N; i++)
-                    abs_sum_off_diagonal_col += rocblas_abs(A[i + j * lda]);
-
-                for(size_t i = 0; i < j; i++)
-                    abs_sum_off_diagonal_row += rocblas_abs(A[j + i * lda]);
-
-                A[j + j * lda]
-                    = (abs_sum_off_diagonal_row + abs_sum_off_diagonal_col) == T(0)
-                          ? T(1)
-                          : T((abs_sum_off_diagonal_row + abs_sum_off_diagonal_col) * multiplier);
-            }
-        }
-    }
+    if(single)
+        rocblas_init_diagonally_dominant(uplo, A.data(), N, lda);
 }
 
 template <typename U, typename T>
@@ -331,161 +328,25 @@ void rocblas_init_matrix(rocblas_check_matrix_type matrix_type,
                          T                         rand_gen(),
                          U&                        hA)
 {
-    for(int64_t batch_index = 0; batch_index < hA.batch_count(); ++batch_index)
-    {
-        auto* A   = hA[batch_index];
-        auto  M   = hA.m();
-        auto  N   = hA.n();
-        auto  lda = hA.lda();
-        if(matrix_type == rocblas_client_general_matrix)
-        {
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-            for(size_t i = 0; i < M; ++i)
-                for(size_t j = 0; j < N; ++j)
-                    A[i + j * lda] = rand_gen();
-        }
-        else if(matrix_type == rocblas_client_hermitian_matrix)
-        {
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-            for(size_t i = 0; i < N; ++i)
-                for(size_t j = 0; j <= i; ++j)
-                {
-                    auto value = rand_gen();
-                    if(i == j)
-                        A[j + i * lda] = std::real(value);
-                    else if(uplo == 'U')
-                    {
-                        A[j + i * lda] = value;
-                        A[i + j * lda] = T(0);
-                    }
-                    else if(uplo == 'L')
-                    {
-                        A[j + i * lda] = T(0);
-                        A[i + j * lda] = value;
-                    }
-                    else
-                    {
-                        A[j + i * lda] = value;
-                        A[i + j * lda] = conjugate(value);
-                    }
-                }
-        }
-        else if(matrix_type == rocblas_client_symmetric_matrix)
-        {
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-            for(size_t i = 0; i < N; ++i)
-                for(size_t j = 0; j <= i; ++j)
-                {
-                    auto value = rand_gen();
-                    if(i == j)
-                        A[j + i * lda] = value;
-                    else if(uplo == 'U')
-                    {
-                        A[j + i * lda] = value;
-                        A[i + j * lda] = T(0);
-                    }
-                    else if(uplo == 'L')
-                    {
-                        A[j + i * lda] = T(0);
-                        A[i + j * lda] = value;
-                    }
-                    else
-                    {
-                        A[j + i * lda] = value;
-                        A[i + j * lda] = value;
-                    }
-                }
-        }
-        else if(matrix_type == rocblas_client_triangular_matrix)
-        {
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-            for(size_t i = 0; i < M; ++i)
-                for(size_t j = 0; j < N; ++j)
-                {
-                    auto value
-                        = uplo == 'U' ? (j >= i ? rand_gen() : T(0)) : (j <= i ? rand_gen() : T(0));
-                    A[i + j * lda] = value;
-                }
-        }
+    rocblas_random_source<T> random(rand_gen);
 
-        /*An n x n triangle matrix with random entries has a condition number that grows exponentially with n ("Condition numbers of random triangular matrices" D. Viswanath and L.N.Trefethen).
-        Here we use a triangle matrix with random values that is strictly row and column diagonal dominant.
-        This matrix should have a lower condition number. An alternative is to calculate the Cholesky factor of an SPD matrix with random values and make it diagonal dominant.
-        This approach is not used because it is slow.*/
+    // Hermitian and symmetric matrices are N x N
+    bool square = matrix_type == rocblas_client_hermitian_matrix
+                  || matrix_type == rocblas_client_symmetric_matrix;
 
-        else if(matrix_type == rocblas_client_diagonally_dominant_triangular_matrix)
-        {
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-            for(size_t i = 0; i < M; ++i)
-                for(size_t j = 0; j < N; ++j)
-                {
-                    auto value
-                        = uplo == 'U' ? (j >= i ? rand_gen() : T(0)) : (j <= i ? rand_gen() : T(0));
-                    A[i + j * lda] = value;
-                }
+    rocblas_init_matrix_columns(
+        hA.batch_count(),
+        hA.n(),
+        hA.lda(),
+        [&](int64_t b) { return hA[b]; },
+        [&](int64_t b, int64_t j, T* Aj) {
+            rocblas_init_matrix_column(
+                matrix_type, uplo, random, b, j, int64_t(square ? hA.n() : hA.m()), Aj);
+        });
 
-            const T multiplier = T(
-                1.01); // Multiplying factor to slightly increase the base value of (abs_sum_off_diagonal_row + abs_sum_off_diagonal_col) dominant diagonal element. If tests fail and it seems that there are numerical stability problems, try increasing multiplier, it should decrease the condition number of the matrix and thereby avoid numerical stability issues.
-
-            if(uplo == 'U') // rocblas_fill_upper
-            {
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-                for(size_t i = 0; i < N; i++)
-                {
-                    T abs_sum_off_diagonal_row = T(
-                        0); //store absolute sum of entire row of the particular diagonal element
-                    T abs_sum_off_diagonal_col = T(
-                        0); //store absolute sum of entire column of the particular diagonal element
-
-                    for(size_t j = i + 1; j < N; j++)
-                        abs_sum_off_diagonal_row += rocblas_abs(A[i + j * lda]);
-                    for(size_t j = 0; j < i; j++)
-                        abs_sum_off_diagonal_col += rocblas_abs(A[j + i * lda]);
-
-                    A[i + i * lda] = (abs_sum_off_diagonal_row + abs_sum_off_diagonal_col) == T(0)
-                                         ? T(1)
-                                         : T((abs_sum_off_diagonal_row + abs_sum_off_diagonal_col)
-                                             * multiplier);
-                }
-            }
-            else // rocblas_fill_lower
-            {
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-                for(size_t j = 0; j < N; j++)
-                {
-                    T abs_sum_off_diagonal_row = T(
-                        0); //store absolute sum of entire row of the particular diagonal element
-                    T abs_sum_off_diagonal_col = T(
-                        0); //store absolute sum of entire column of the particular diagonal element
-
-                    for(size_t i = j + 1; i < N; i++)
-                        abs_sum_off_diagonal_col += rocblas_abs(A[i + j * lda]);
-
-                    for(size_t i = 0; i < j; i++)
-                        abs_sum_off_diagonal_row += rocblas_abs(A[j + i * lda]);
-
-                    A[j + j * lda] = (abs_sum_off_diagonal_row + abs_sum_off_diagonal_col) == T(0)
-                                         ? T(1)
-                                         : T((abs_sum_off_diagonal_row + abs_sum_off_diagonal_col)
-                                             * multiplier);
-                }
-            }
-        }
-    }
+    if(matrix_type == rocblas_client_diagonally_dominant_triangular_matrix)
+        for(int64_t b = 0; b < hA.batch_count(); ++b)
+            rocblas_init_diagonally_dominant(uplo, hA[b], hA.n(), hA.lda());
 }
 
 /*! \brief  vector initialization: */
@@ -497,11 +358,9 @@ void rocblas_init_vector(T rand_gen(), T* x, int64_t N, int64_t incx)
     if(incx < 0)
         x -= (N - 1) * incx;
 
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-    for(int64_t j = 0; j < N; ++j)
-        x[j * incx] = rand_gen();
+    rocblas_random_source<T> random(rand_gen);
+
+    rocblas_init_vector_runs(random, x, N, incx);
 }
 
 /* ============================================================================================ */
@@ -24,14 +24,143 @@
 
 #include "rocblas.h"
 #include "rocblas_math.hpp"
+#include <algorithm>
 #include <cinttypes>
+#include <map>
+#include <mutex>
 #include <random>
 #include <thread>
 #include <type_traits>
+#include <vector>
 
 /* ============================================================================================ */
+/*! \brief  Counter-based random number generator (Philox4x32-10, Salmon et al., SC11)
+ *
+ * Each output block is a pure function of the key and a 128-bit counter made of a stream number and
+ * a block index, so any position of any stream can be produced directly, on any thread. Models
+ * UniformRandomBitGenerator, so it works with the std distributions. */
+class rocblas_philox_rng
+{
+    uint32_t m_key[2];
+    uint64_t m_stream;
+    uint64_t m_block = 0;
+    uint32_t m_out[4];
+    int      m_next = 4;
+
+    void generate()
+    {
+        uint32_t c[4] = {uint32_t(m_block),
+                         uint32_t(m_block >> 32),
+                         uint32_t(m_stream),
+                         uint32_t(m_stream >> 32)};
+        uint32_t k[2] = {m_key[0], m_key[1]};
+
+        for(int round = 0; round < 10; round++)
+        {
+            if(round)
+            {
+                k[0] += 0x9E3779B9;
+                k[1] += 0xBB67AE85;
+            }
+            uint64_t p0 = uint64_t(0xD2511F53) * c[0];
+            uint64_t p1 = uint64_t(0xCD9E8D57) * c[2];
+
+            c[0] = uint32_t(p1 >> 32) ^ c[1] ^ k[0];
+            c[1] = uint32_t(p1);
+            c[2] = uint32_t(p0 >> 32) ^ c[3] ^ k[1];
+            c[3] = uint32_t(p0);
+        }
+
+        for(int i = 0; i < 4; i++)
+            m_out[i] = c[i];
+        m_block++;
+        m_next = 0;
+    }
+
+public:
+    using result_type = uint32_t;
+
+    explicit rocblas_philox_rng(uint64_t seed = 5489, uint64_t stream = 0)
+        : m_key{uint32_t(seed), uint32_t(seed >> 32)}
+        , m_stream(stream)
+    {
+    }
+
+    static constexpr result_type min()
+    {
+        return 0;
+    }
+
+    static constexpr result_type max()
+    {
+        return UINT32_MAX;
+    }
+
+    result_type operator()()
+    {
+        if(m_next == 4)
+            generate();
+        return m_out[m_next++];
+    }
+
+    void discard(unsigned long long z)
+    {
+        while(z--)
+            (*this)();
+    }
+
+    // Writes the 4 outputs of each of the n blocks of stream from block onwards, the same words
+    // rocblas_philox_rng(seed, stream) produces after discarding 4 * block. The blocks are done
+    // in groups of LANES, one round at a time, so the compiler vectorizes across the blocks.
+    static void blocks(uint64_t seed, uint64_t stream, uint64_t block, size_t n, uint32_t* out)
+    {
+        constexpr size_t LANES = 8;
+
+        for(size_t b0 = 0; b0 < n; b0 += LANES)
+        {
+            uint32_t c0[LANES], c1[LANES], c2[LANES], c3[LANES];
+            for(size_t l = 0; l < LANES; l++)
+            {
+                c0[l] = uint32_t(block + b0 + l);
+                c1[l] = uint32_t((block + b0 + l) >> 32);
+                c2[l] = uint32_t(stream);
+                c3[l] = uint32_t(stream >> 32);
+            }
+
+            uint32_t k0 = uint32_t(seed), k1 = uint32_t(seed >> 32);
+            for(int round = 0; round < 10; round++)
+            {
+                if(round)
+                {
+                    k0 += 0x9E3779B9;
+                    k1 += 0xBB67AE85;
+                }
+                for(size_t l = 0; l < LANES; l++)
+                {
+                    uint64_t p0 = uint64_t(0xD2511F53) * c0[l];
+                    uint64_t p1 = uint64_t(0xCD9E8D57) * c2[l];
+
+                    c0[l] = uint32_t(p1 >> 32) ^ c1[l] ^ k0;
+                    c1[l] = uint32_t(p1);
+                    c2[l] = uint32_t(p0 >> 32) ^ c3[l] ^ k1;
+                    c3[l] = uint32_t(p0);
+                }
+            }
+
+            for(size_t l = 0; l < std::min(LANES, n - b0); l++)
+            {
+                uint32_t* o = out + 4 * (b0 + l);
+                o[0]        = c0[l];
+                o[1]        = c1[l];
+                o[2]        = c2[l];
+                o[3]        = c3[l];
+            }
+        }
+    }
+};
+
 // Random number generator
-using rocblas_rng_t = std::mt19937;
+using rocblas_rng_t = rocblas_philox_rng;
 
 extern rocblas_rng_t   g_rocblas_seed;
 extern std::thread::id g_main_thread_id;
@@ -63,6 +192,84 @@ inline void rocblas_seedrand()
     t_rocblas_rand_idx = 0;
 }
 
+/*! \brief  Element-addressed random values for parallel initialization
+ *
+ * seek(b, i, j) positions the generator of the current thread at a stream of its own for element
+ * (i, j) of batch member b, so the values drawn for an element depend only on the seed state of
+ * the thread that created the rocblas_rng_stream and on the element position, not on the number
+ * of threads or on the scheduling. Creating one draws its key from the calling thread, so
+ * successive initializations differ; the calling thread's generator is restored when it is
+ * destroyed, while the generators of the other threads are left positioned at some element. */
+class rocblas_rng_stream
+{
+    uint64_t      m_key;
+    rocblas_rng_t m_saved;
+
+    static uint64_t draw_key()
+    {
+        uint64_t hi = t_rocblas_rng();
+        return hi << 32 | t_rocblas_rng();
+    }
+
+public:
+    rocblas_rng_stream()
+        : m_key(draw_key())
+        , m_saved(t_rocblas_rng)
+    {
+    }
+
+    ~rocblas_rng_stream()
+    {
+        t_rocblas_rng = m_saved;
+    }
+
+    rocblas_rng_stream(const rocblas_rng_stream&) = delete;
+    rocblas_rng_stream& operator=(const rocblas_rng_stream&) = delete;
+
+    void seek(uint64_t b, uint64_t i, uint64_t j) const
+    {
+        t_rocblas_rng = rocblas_rng_t(m_key + b, i | j << 32);
+    }
+
+    // Writes n blocks of 4 words for column j of batch member b, from block onwards
+    void blocks(uint64_t b, uint64_t j, uint64_t block, size_t n, uint32_t* out) const
+    {
+        rocblas_philox_rng::blocks(m_key + b, j, block, n, out);
+    }
+};
+
+/*! \brief  Pools of precomputed random values
+ *
+ * rocblas_random_pool(rand_gen) returns rocblas_random_pool_size values drawn once per process from
+ * rand_gen, starting from the initial state of g_rocblas_seed, so the values follow exactly the
+ * distribution of rand_gen whatever its type. Only the bulk run fills of random_run_generator copy
+ * windows of a pool; the pool is much smaller than the fills, so its values repeat, which is why
+ * the matrix and vector initializations draw every element instead. */
+constexpr size_t rocblas_random_pool_size = size_t(1) << 14;
+
+template <typename T>
+const T* rocblas_random_pool(T rand_gen())
+{
+    static std::mutex                        mutex;
+    static std::map<T (*)(), std::vector<T>> pools;
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::vector<T>& pool = pools[rand_gen];
+    if(pool.empty())
+    {
+        rocblas_rng_t saved = t_rocblas_rng;
+        t_rocblas_rng       = g_rocblas_seed;
+
+        pool.resize(rocblas_random_pool_size);
+        for(T& value : pool)
+            value = rand_gen();
+
+        t_rocblas_rng = saved;
+    }
+    return pool.data();
+}
+
 /* ============================================================================================ */
 /*! \brief  Random number generator which generates NaN values */
 class rocblas_nan_rng
@@ -368,12 +575,21 @@ inline int8_t random_generator<int8_t>()
 };
 
 /*! \brief  generate a sequence of random number in range [1,2,3,4,5,6,7,8,9,10] */
+// Copies windows of the random_generator<T> pool, each starting at a new random offset, as the
+// float and double run generators do with their tables
 template <typename T>
 inline void random_run_generator(T* ptr, size_t num)
 {
-    for(size_t i = 0; i < num; i++)
+    constexpr size_t window = 1024;
+
+    const T* pool = rocblas_random_pool(random_generator<T>);
+    while(num)
     {
-        ptr[i] = random_generator<T>();
+        size_t offset = t_rocblas_rng() % (rocblas_random_pool_size - window + 1);
+        size_t n      = std::min(num, window);
+        std::copy(pool + offset, pool + offset + n, ptr);
+        ptr += n;
+        num -= n;
     }
 }
 
@@ -530,3 +746,163 @@ inline rocblas_bf8 random_zero_one_generator<rocblas_bf8>()
 {
     return rocblas_bf8(float(std::uniform_int_distribution<int>(0, 1)(t_rocblas_rng)));
 }
+
+/* ============================================================================================ */
+/*! \brief  Bulk transforms of Philox words into the distributions of the generators
+ *
+ * rocblas_random_bulk_find(rand_gen) returns, for the generators which the matrix and vector
+ * initializations use most, how many 32-bit words an element takes and a transform which maps
+ * whole runs of words to elements with the distribution of rand_gen. The transforms are plain
+ * loops over arrays, so the compiler vectorizes them. Other generators have no transform
+ * (words == 0), and are called once per element. */
+template <typename T>
+struct rocblas_random_bulk
+{
+    int words = 0;
+    void (*transform)(const uint32_t* u, T* x, size_t n) = nullptr;
+};
+
+// [1, 10] as in rocblas_uniform_int_1_10
+template <typename R>
+inline R rocblas_random_word_int_1_10(uint32_t u)
+{
+    return R(1 + ((uint64_t(u) * 10) >> 32));
+}
+
+// [-2, 2] as in random_generator<rocblas_half>
+inline float rocblas_random_word_int_2_2(uint32_t u)
+{
+    return float(int((uint64_t(u) * 5) >> 32) - 2);
+}
+
+// (-0.5, 0.5) on a grid of 2^-32, as in random_hpl_generator
+template <typename R>
+inline R rocblas_random_word_hpl(uint32_t u)
+{
+    return R((double(u) + 0.5) * 0x1p-32 - 0.5);
+}
+
+// Elements of one word each, or complex elements of one word per part
+template <typename T, typename F>
+inline void rocblas_random_words(const uint32_t* u, T* x, size_t n, F f)
+{
+    if constexpr(rocblas_is_complex<T>)
+        for(size_t k = 0; k < n; k++)
+            x[k] = T(f(u[2 * k]), f(u[2 * k + 1]));
+    else
+        for(size_t k = 0; k < n; k++)
+            x[k] = T(f(u[k]));
+}
+
+template <typename T>
+rocblas_random_bulk<T> rocblas_random_bulk_find(T rand_gen())
+{
+    constexpr bool is_float
+        = std::is_same_v<T, float> || std::is_same_v<T, rocblas_float_complex>;
+    constexpr bool is_double
+        = std::is_same_v<T, double> || std::is_same_v<T, rocblas_double_complex>;
+    constexpr bool is_16bit
+        = std::is_same_v<T, rocblas_half> || std::is_same_v<T, rocblas_bfloat16>;
+
+    if constexpr(is_float || is_double)
+    {
+        using R = std::conditional_t<is_float, float, double>;
+
+        if(rand_gen == random_generator<T>)
+            return {rocblas_is_complex<T> ? 2 : 1, [](const uint32_t* u, T* x, size_t n) {
+                        rocblas_random_words(u, x, n, rocblas_random_word_int_1_10<R>);
+                    }};
+
+        // The complex HPL values are real
+        if(rand_gen == random_hpl_generator<T>)
+            return {1, [](const uint32_t* u, T* x, size_t n) {
+                        for(size_t k = 0; k < n; k++)
+                            x[k] = T(rocblas_random_word_hpl<R>(u[k]));
+                    }};
+    }
+    else if constexpr(is_16bit)
+    {
+        if(rand_gen == random_generator<T>)
+            return {1, [](const uint32_t* u, T* x, size_t n) {
+                        rocblas_random_words(u, x, n, rocblas_random_word_int_2_2);
+                    }};
+
+        if(rand_gen == random_hpl_generator<T>)
+            return {1, [](const uint32_t* u, T* x, size_t n) {
+                        rocblas_random_words(u, x, n, rocblas_random_word_hpl<float>);
+                    }};
+    }
+    return {};
+}
+
+/*! \brief  Random values of one matrix or vector initialization
+ *
+ * The values are a pure function of the seed state of the constructing thread and the element
+ * position, so they do not depend on the number of threads. When rand_gen has a bulk transform,
+ * the consecutive rows of a column share Philox blocks: row i of column j of batch member b takes
+ * words of block i / (4 / words) of stream j, and fill() makes whole runs of rows with
+ * rocblas_philox_rng::blocks and the transform. Otherwise every element is drawn from rand_gen with
+ * the generator positioned by a rocblas_rng_stream at that element. */
+template <typename T>
+class rocblas_random_source
+{
+    T (*m_rand_gen)();
+    rocblas_random_bulk<T> m_bulk;
+    rocblas_rng_stream     m_stream;
+
+public:
+    explicit rocblas_random_source(T rand_gen())
+        : m_rand_gen(rand_gen)
+        , m_bulk(rocblas_random_bulk_find(rand_gen))
+    {
+    }
+
+    T operator()(int64_t b, int64_t i, int64_t j) const
+    {
+        if(!m_bulk.words)
+        {
+            m_stream.seek(b, i, j);
+            return m_rand_gen();
+        }
+
+        int64_t  per_block = 4 / m_bulk.words;
+        uint32_t u[4];
+        T        x;
+        m_stream.blocks(b, j, i / per_block, 1, u);
+        m_bulk.transform(u + i % per_block * m_bulk.words, &x, 1);
+        return x;
+    }
+
+    // Sets x[k * inc] = (*this)(b, i0 + k, j) for 0 <= k < m
+    void fill(int64_t b, int64_t j, int64_t i0, int64_t m, T* x, int64_t inc) const
+    {
+        if(!m_bulk.words)
+        {
+            for(int64_t k = 0; k < m; k++)
+                x[k * inc] = (*this)(b, i0 + k, j);
+            return;
+        }
+
+        constexpr int64_t BLOCKS    = 256;
+        const int64_t     per_block = 4 / m_bulk.words;
+        uint32_t          u[4 * BLOCKS];
+        T                 v[4 * BLOCKS];
+
+        for(int64_t i = i0; i < i0 + m;)
+        {
+            int64_t first = i / per_block * per_block;
+            int64_t last  = std::min(i0 + m, first + BLOCKS * per_block);
+            m_stream.blocks(b, j, first / per_block, (last - first + per_block - 1) / per_block, u);
+
+            if(inc == 1 && i == first)
+                m_bulk.transform(u, x + (i - i0), last - first);
+            else
+            {
+                m_bulk.transform(u, v, last - first);
+                for(int64_t k = i; k < last; k++)
+                    x[(k - i0) * inc] = v[k - first];
+            }
+            i = last;
+        }
+    }
+};
@@ -0,0 +1,142 @@
+/* ************************************************************************
+ * Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell cop-
+ * ies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM-
+ * PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNE-
+ * CTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ************************************************************************ */
+
+/*!\file
+ * \brief Opt-in on-disk cache of host reference results for rocblas-test.
+ */
+
+#pragma once
+
+#include "rocblas_arguments.hpp"
+#include "rocblas_matrix.hpp"
+#include "rocblas_vector.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+//!
+//! @brief Host memory holding part of a reference result.
+//!
+struct rocblas_reference_span
+{
+    void*  data;
+    size_t bytes;
+};
+
+//!
+//! @brief Key of a reference result in the cache.
+//!
+struct rocblas_reference_key
+{
+    uint64_t h[2];
+};
+
+//!
+//! @brief True when the environment variable ROCBLAS_CLIENT_REF_CACHE names a directory to keep
+//! reference results in. The total size of the directory is kept under ROCBLAS_CLIENT_REF_CACHE_GB
+//! (default 16) by removing the least recently used results. Always false in rocblas-bench and on
+//! Windows, so measured CPU times are never those of a cache hit.
+//!
+bool rocblas_reference_cache_enabled();
+
+//!
+//! @brief Key of the result of the reference named tag for arg. It hashes every Arguments field
+//! that can change the data or the result, tag, the contents of the input spans, the sizes of the
+//! output spans and the versions of rocBLAS and the host BLAS library.
+//!
+rocblas_reference_key rocblas_reference_cache_key(const Arguments&              arg,
+                                                  const char*                   tag,
+                                                  const rocblas_reference_span* inputs,
+                                                  size_t                        input_count,
+                                                  const rocblas_reference_span* outputs,
+                                                  size_t                        output_count);
+
+//!
+//! @brief Fill spans with the cached result of key.
+//! @return true on a hit, false when spans are left untouched.
+//!
+bool rocblas_reference_cache_load(const rocblas_reference_key&  key,
+                                  const rocblas_reference_span* spans,
+                                  size_t                        count);
+
+//!
+//! @brief Store spans as the result of key, then evict the least recently used results over the
+//! size budget.
+//!
+void rocblas_reference_cache_store(const rocblas_reference_key&  key,
+                                   const rocblas_reference_span* spans,
+                                   size_t                        count);
+
+template <typename T>
+rocblas_reference_span rocblas_reference_span_of(host_vector<T>& h)
+{
+    return {h.data(), h.size() * sizeof(T)};
+}
+
+template <typename T>
+rocblas_reference_span rocblas_reference_span_of(host_matrix<T>& h)
+{
+    return {h.data(), h.size() * sizeof(T)};
+}
+
+template <typename T>
+rocblas_reference_span rocblas_reference_span_of(host_strided_batch_matrix<T>& h)
+{
+    return {h.data(), h.nmemb() * sizeof(T)};
+}
+
+// the matrices of a host_batch_matrix are one allocation starting at the first
+template <typename T>
+rocblas_reference_span rocblas_reference_span_of(host_batch_matrix<T>& h)
+{
+    return {h.batch_count() ? h[0] : nullptr, h.nmemb() * h.batch_count() * sizeof(T)};
+}
+
+//!
+//! @brief Calls ref() to compute the reference result in outputs, unless it is found in the
+//! reference cache, in which case outputs are loaded instead. Results computed are stored.
+//! @param arg the test arguments.
+//! @param tag names the reference when a test computes more than one.
+//! @param inputs every host input read by ref(), including outputs which are also read, such as C.
+//!
+template <typename F, typename... H>
+void rocblas_cached_reference(const Arguments&                              arg,
+                              const char*                                   tag,
+                              std::initializer_list<rocblas_reference_span> inputs,
+                              F&&                                           ref,
+                              H&... outputs)
+{
+    if(!rocblas_reference_cache_enabled())
+        return ref();
+
+    const rocblas_reference_span spans[] = {rocblas_reference_span_of(outputs)...};
+
+    // the key is computed before ref() overwrites the outputs which are also inputs
+    const rocblas_reference_key key = rocblas_reference_cache_key(
+        arg, tag, inputs.begin(), inputs.size(), spans, sizeof...(H));
+
+    if(rocblas_reference_cache_load(key, spans, sizeof...(H)))
+        return;
+
+    ref();
+    rocblas_reference_cache_store(key, spans, sizeof...(H));
+}
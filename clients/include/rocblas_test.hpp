@@ -156,19 +156,23 @@ inline void rocblas_expect_status(rocblas_status status, rocblas_status expect)
 // Function which matches Arguments with a category, accounting for arg.known_bug_platforms
 bool match_test_category(const Arguments& arg, const char* category);
 
-// The tests are instantiated by filtering through the RocBLAS_Data stream
+// The tests are instantiated by filtering through the RocBLAS_Data records
 // The filter is by category and by the type_filter() and function_filter()
-// functions in the testclass
-#define INSTANTIATE_TEST_CATEGORY(testclass, category)                                            \
-    INSTANTIATE_TEST_SUITE_P(category,                                                            \
-                             testclass,                                                           \
-                             testing::ValuesIn(RocBLAS_TestData::begin([](const Arguments& arg) { \
-                                                   return match_test_category(arg, #category)     \
-                                                          && testclass::function_filter(arg)      \
-                                                          && testclass::type_filter(arg);         \
-                                               }),                                                \
-                                               RocBLAS_TestData::end()),                          \
-                             testclass::PrintToStringParamName());
+// functions in the testclass; function_filter() also selects the indexed
+// groups of records by function, so that only those records are read
+#define INSTANTIATE_TEST_CATEGORY(testclass, category)                                   \
+    INSTANTIATE_TEST_SUITE_P(                                                            \
+        category,                                                                        \
+        testclass,                                                                       \
+        testing::ValuesIn(RocBLAS_TestData::begin(                                       \
+                              [](const Arguments& arg) {                                 \
+                                  return match_test_category(arg, #category)             \
+                                         && testclass::function_filter(arg)              \
+                                         && testclass::type_filter(arg);                 \
+                              },                                                         \
+                              testclass::function_filter),                               \
+                          RocBLAS_TestData::end()),                                      \
+        testclass::PrintToStringParamName());
 
 #if defined(GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST)
 #define ROCBLAS_ALLOW_UNINSTANTIATED_GTEST(testclass) \
@@ -386,6 +390,13 @@ public:
 // Function to set up signal handlers
 void rocblas_test_sigaction();
 
+// Runs the tests in parallel worker processes if --parallel or --devices is given, and merges
+// their results into status; removes those options and returns false otherwise
+bool rocblas_test_parallel(int& argc, char** argv, int& status);
+
+// In a worker process, adds the listener which records the results for the parallel run
+void rocblas_test_worker_listener();
+
 #endif // GOOGLE_TEST
 
 // ----------------------------------------------------------------------------
@@ -0,0 +1,46 @@
+/* ************************************************************************
+ * Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell cop-
+ * ies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM-
+ * PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNE-
+ * CTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ************************************************************************ */
+
+#pragma once
+
+#include "rocblas_arguments.hpp"
+#include <cstddef>
+#include <vector>
+
+/*!\file
+ * \brief Estimated cost of the tests, used to balance them across parallel workers.
+ *
+ * The cost of a test is dominated on the host: the initialization of its data, the reference BLAS
+ * and the comparison of the results. It is estimated from the floating point operations of
+ * flops.hpp and the memory of bytes.hpp, in the precision of the test, times the batch count,
+ * plus a fixed overhead per test. Only the ratios of the costs matter.
+ */
+
+//! @brief Estimated relative run time of the test of arg.
+double rocblas_test_cost(const Arguments& arg);
+
+//! @brief Assigns items of the given costs to workers, longest first, each to the least loaded
+//! worker. Ties go to the worker with the least of totals, the loads of earlier schedules, which
+//! are updated; the size of totals is the number of workers.
+//! @return the worker of each item.
+std::vector<size_t> rocblas_test_schedule(const std::vector<double>& costs,
+                                          std::vector<double>&       totals);
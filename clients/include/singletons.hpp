@@ -20,7 +20,33 @@
  *
  * ************************************************************************ */
 
+#include <cstddef>
+
 // global for device memory padding see d_vector.hpp
 
 extern size_t g_DVEC_PAD;
 void          d_vector_set_pad_length(size_t pad);
+
+// global cache of device memory blocks see d_vector.hpp
+// When enabled, d_vector reuses freed blocks of compatible size instead of calling hipMalloc
+// and hipFree for every problem, as rocblas-bench --replay does across many distinct commands.
+// Disabling the cache frees all of the blocks it holds.
+
+void  d_vector_cache_enable(bool enable);
+bool  d_vector_cache_enabled();
+void* d_vector_cache_acquire(size_t bytes);
+bool  d_vector_cache_release(void* ptr);
+void  d_vector_cache_stats(size_t& reused, size_t& allocated);
+
+// guard regions around the blocks of d_vector see d_vector.hpp
+// The guard pattern of each element type is copied once to pinned host memory, so that the guards
+// are written without waiting for each copy. Both guards of a block are read back into a pinned
+// arena of the calling thread with a single synchronization, and compared in one vectorized pass.
+
+void d_vector_guard_write(
+    void* before, void* after, const void* pattern, size_t pattern_size, size_t bytes);
+
+// Returns false if a guard is corrupted, with the offset of the first corrupted byte from the start
+// of the guard before the block, counting the guard after the block from bytes
+bool d_vector_guard_check(
+    const void* before, const void* after, const void* pattern, size_t bytes, size_t& offset);
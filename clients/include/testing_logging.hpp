@@ -31,6 +31,7 @@
 #include <algorithm>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <fstream>
 #ifdef WIN32
 #include <stdlib.h>
@@ -104,6 +105,14 @@ void testing_logging(const Arguments& arg)
 
     setenv_status = setenv("ROCBLAS_LAYER", "3", true);
 
+#ifdef GOOGLE_TEST
+    ASSERT_EQ(setenv_status, 0);
+#endif
+
+    // ROCBLAS_LOG_DEFERRED = 1 formats log_trace and log_bench lines on the logging thread
+    const bool log_deferred = !strcmp(arg.function, "logging_deferred");
+    setenv_status           = setenv("ROCBLAS_LOG_DEFERRED", log_deferred ? "1" : "0", true);
+
 #ifdef GOOGLE_TEST
     ASSERT_EQ(setenv_status, 0);
 #endif
@@ -414,6 +423,12 @@ void testing_logging(const Arguments& arg)
 
     setenv_status = setenv("ROCBLAS_LAYER", "0", true);
 
+#ifdef GOOGLE_TEST
+    ASSERT_EQ(setenv_status, 0);
+#endif
+
+    setenv_status = setenv("ROCBLAS_LOG_DEFERRED", "0", true);
+
 #ifdef GOOGLE_TEST
     ASSERT_EQ(setenv_status, 0);
 #endif
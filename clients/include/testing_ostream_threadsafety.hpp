@@ -28,10 +28,18 @@
 #include "rocblas_test.hpp"
 #include "rocblas_vector.hpp"
 #include "utility.hpp"
+#include <atomic>
+#include <chrono>
 #include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <set>
 #include <sstream>
 #include <thread>
 #ifdef WIN32
+#include <stdlib.h>
+#define setenv(A, B, C) _putenv_s(A, B)
 #include <fcntl.h>
 #include <io.h>
 #include <sys/stat.h>
@@ -77,6 +85,9 @@ inline void testing_ostream_threadsafety(const Arguments& arg)
     auto check_sig
         = [&](const std::string& s) { return s.substr(0, SIGLEN) == sig(s.substr(SIGLEN)); };
 
+    // Total number of bytes written by the threads
+    std::atomic<size_t> total_bytes;
+
     // Each thread writes random strings with signature checksums
     auto thread_func = [&](int fd) {
         rocblas_internal_ostream os(fd);
@@ -87,6 +98,7 @@ inline void testing_ostream_threadsafety(const Arguments& arg)
 
             // Write the signature followed by the random string, flushing at the end
             os << sig(s) << s << std::endl;
+            total_bytes += SIGLEN + s.size() + 1;
         }
     };
 
@@ -111,6 +123,8 @@ inline void testing_ostream_threadsafety(const Arguments& arg)
             return;
         }
 
+        total_bytes = 0;
+
         // Launch NTHREAD threads, creating a rocblas_internal_ostream for each thread by duplicating fd
         std::thread threads[NTHREAD];
         for(auto& t : threads)
@@ -120,6 +134,12 @@ inline void testing_ostream_threadsafety(const Arguments& arg)
         for(auto& t : threads)
             t.join();
 
+        // The worker must have written everything in batches, without dropping anything
+        auto stats = rocblas_internal_ostream(fd).stats();
+        EXPECT_GE(stats.bytes_written, total_bytes.load());
+        EXPECT_EQ(stats.records_dropped, size_t(0));
+        EXPECT_LE(stats.max_queue_depth, NTHREAD);
+
         // Close the original file descriptor
         if(CLOSE(fd))
             FAIL() << "Could not close filehandle for " << path;
@@ -153,3 +173,87 @@ inline void testing_ostream_threadsafety(const Arguments& arg)
         fs::remove(path);
     }
 }
+
+inline void testing_ostream_queue_drop(const Arguments& arg)
+{
+    constexpr size_t QUEUE   = 4; // ROCBLAS_LOG_QUEUE_SIZE
+    constexpr size_t NTHREAD = 8; // Number of threads posting records
+    constexpr size_t NPOST   = 500; // Number of records each thread posts
+
+    // A record which is slow to format, so that the posting threads fill the queue
+    struct slow_record : rocblas_internal_ostream::deferred_record
+    {
+        size_t index;
+
+        explicit slow_record(size_t index)
+            : index(index)
+        {
+        }
+
+        void format(rocblas_internal_ostream& os) const override
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(20));
+            os << "record " << index << "\n";
+        }
+    };
+
+    std::string uniquestr = "rocblas-drop-";
+    for(int i = 0; i < 6; ++i)
+        uniquestr += "0123456789abcdefghijklmnopqrstuvwxyz"[rand() % 36];
+    fs::path path = fs::temp_directory_path() / uniquestr;
+    int      fd   = OPEN(path.generic_string().c_str());
+    if(fd == -1)
+    {
+        FAIL() << "Cannot open temporary file " << path;
+        return;
+    }
+
+    // The worker of a new file reads the bound and the policy of its queue when it is created
+    ASSERT_EQ(setenv("ROCBLAS_LOG_QUEUE_SIZE", "4", true), 0);
+    ASSERT_EQ(setenv("ROCBLAS_LOG_QUEUE_POLICY", "drop", true), 0);
+    rocblas_internal_ostream os(fd);
+    ASSERT_EQ(setenv("ROCBLAS_LOG_QUEUE_SIZE", "", true), 0);
+    ASSERT_EQ(setenv("ROCBLAS_LOG_QUEUE_POLICY", "", true), 0);
+
+    std::thread threads[NTHREAD];
+    for(size_t t = 0; t < NTHREAD; ++t)
+        threads[t] = std::thread([&, t] {
+            rocblas_internal_ostream thread_os(fd);
+            for(size_t i = 0; i < NPOST; ++i)
+                thread_os.send_deferred(std::make_unique<slow_record>(t * NPOST + i));
+        });
+    for(auto& t : threads)
+        t.join();
+
+    // The posters never waited, so records were dropped, and the queue never exceeded its bound
+    auto stats = os.stats();
+    EXPECT_GT(stats.records_dropped, size_t(0));
+    EXPECT_LE(stats.max_queue_depth, QUEUE);
+
+    // Every record which was not dropped is written once
+    os.drain();
+    stats = os.stats();
+
+    if(CLOSE(fd))
+        FAIL() << "Could not close filehandle for " << path;
+
+    std::ifstream    is(path);
+    std::set<size_t> written;
+    size_t           lines = 0;
+    for(std::string line; std::getline(is, line); ++lines)
+    {
+        size_t index;
+        ASSERT_EQ(sscanf(line.c_str(), "record %zu", &index), 1) << line;
+        written.insert(index);
+    }
+    is.close();
+
+    EXPECT_EQ(lines, written.size());
+    EXPECT_EQ(lines + stats.records_dropped, NTHREAD * NPOST);
+
+#ifdef WIN32
+    // need all file descriptors closed to allow file removal on windows before process exits
+    rocblas_internal_ostream::clear_workers();
+#endif
+    fs::remove(path);
+}
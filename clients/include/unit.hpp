@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include "bulk_check.hpp"
 #include "rocblas.h"
 #include "rocblas_math.hpp"
 #include "rocblas_test.hpp"
@@ -38,49 +39,39 @@
 #define UNIT_CHECK_B(M, N, lda, hCPU, hGPU, batch_count, UNIT_ASSERT_EQ)
 #else
 
+// Each UNIT_ASSERT_EQ has a predicate rocblas_check_<UNIT_ASSERT_EQ> used by the bulk comparison,
+// which raises a single failure with a summary of all the mismatches
+
+#define UNIT_CHECK_SUMMARY(M, N, lda, hCPU, hGPU, batch_count, UNIT_ASSERT_EQ)              \
+    do                                                                                      \
+    {                                                                                       \
+        auto summary__ = rocblas_bulk_check(                                                \
+            M, N, lda, batch_count, hCPU, hGPU, [](const auto& a, const auto& b) {          \
+                return rocblas_check_##UNIT_ASSERT_EQ(a, b);                                \
+            });                                                                             \
+        if(summary__.mismatches)                                                            \
+            FAIL() << summary__.str();                                                      \
+    } while(0)
+
 // Also used for vectors with lda used for inc, which may be negative
 #define UNIT_CHECK(M, N, lda, strideA, hCPU, hGPU, batch_count, UNIT_ASSERT_EQ) \
-    do                                                                          \
-    {                                                                           \
-        for(int64_t k = 0; k < batch_count; k++)                                \
-            for(int64_t j = 0; j < N; j++)                                      \
-            {                                                                   \
-                int64_t offset = lda >= 0 ? 0 : int64_t(lda) * (1 - N);         \
-                offset += j * int64_t(lda) + k * strideA;                       \
-                size_t idx = offset;                                            \
-                for(size_t i = 0; i < M; i++)                                   \
-                    if(rocblas_isnan(hCPU[i + idx]))                            \
-                    {                                                           \
-                        ASSERT_TRUE(rocblas_isnan(hGPU[i + idx]));              \
-                    }                                                           \
-                    else                                                        \
-                    {                                                           \
-                        UNIT_ASSERT_EQ(hCPU[i + idx], hGPU[i + idx]);           \
-                    }                                                           \
-            }                                                                   \
-    } while(0)
+    UNIT_CHECK_SUMMARY(M,                                                       \
+                       N,                                                       \
+                       lda,                                                     \
+                       [&](int64_t k) { return &hCPU[0] + k * strideA; },      \
+                       [&](int64_t k) { return &hGPU[0] + k * strideA; },      \
+                       batch_count,                                             \
+                       UNIT_ASSERT_EQ)
 
 // Also used for vectors with lda used for inc, which may be negative
-#define UNIT_CHECK_B(M, N, lda, hCPU, hGPU, batch_count, UNIT_ASSERT_EQ)    \
-    do                                                                      \
-    {                                                                       \
-        for(size_t k = 0; k < batch_count; k++)                             \
-            for(int64_t j = 0; j < N; j++)                                  \
-            {                                                               \
-                int64_t offset = lda >= 0 ? 0 : int64_t(lda) * (1 - N);     \
-                offset += j * int64_t(lda);                                 \
-                size_t idx = offset;                                        \
-                for(size_t i = 0; i < M; i++)                               \
-                    if(rocblas_isnan(hCPU[k][i + idx]))                     \
-                    {                                                       \
-                        ASSERT_TRUE(rocblas_isnan(hGPU[k][i + idx]));       \
-                    }                                                       \
-                    else                                                    \
-                    {                                                       \
-                        UNIT_ASSERT_EQ(hCPU[k][i + idx], hGPU[k][i + idx]); \
-                    }                                                       \
-            }                                                               \
-    } while(0)
+#define UNIT_CHECK_B(M, N, lda, hCPU, hGPU, batch_count, UNIT_ASSERT_EQ) \
+    UNIT_CHECK_SUMMARY(M,                                                \
+                       N,                                                \
+                       lda,                                              \
+                       [&](int64_t k) { return &hCPU[k][0]; },          \
+                       [&](int64_t k) { return &hGPU[k][0]; },          \
+                       batch_count,                                      \
+                       UNIT_ASSERT_EQ)
 
 #define ASSERT_HALF_EQ(a, b) ASSERT_FLOAT_EQ(float(a), float(b))
 #define ASSERT_BF16_EQ(a, b) ASSERT_FLOAT_EQ(float(a), float(b))
@@ -116,6 +107,72 @@
         ASSERT_DOUBLE_EQ(std::imag(ta), std::imag(tb)); \
     } while(0)
 
+// Predicates of the assertions above, with the same 4 ULP tolerance as ASSERT_FLOAT_EQ
+template <typename T>
+inline bool rocblas_check_ulp_eq(T a, T b)
+{
+    using testing::internal::FloatingPoint;
+    return FloatingPoint<T>(a).AlmostEquals(FloatingPoint<T>(b));
+}
+
+template <typename T>
+inline bool rocblas_check_ASSERT_EQ(const T& a, const T& b)
+{
+    return a == b;
+}
+
+inline bool rocblas_check_ASSERT_FLOAT_EQ(float a, float b)
+{
+    return rocblas_check_ulp_eq(a, b);
+}
+
+inline bool rocblas_check_ASSERT_DOUBLE_EQ(double a, double b)
+{
+    return rocblas_check_ulp_eq(a, b);
+}
+
+inline bool rocblas_check_ASSERT_HALF_EQ(rocblas_half a, rocblas_half b)
+{
+    return rocblas_check_ulp_eq(float(a), float(b));
+}
+
+inline bool rocblas_check_ASSERT_BF16_EQ(rocblas_bfloat16 a, rocblas_bfloat16 b)
+{
+    return rocblas_check_ulp_eq(float(a), float(b));
+}
+
+inline bool rocblas_check_ASSERT_F8_EQ(rocblas_f8 a, rocblas_f8 b)
+{
+    return rocblas_check_ulp_eq(float(a), float(b));
+}
+
+inline bool rocblas_check_ASSERT_BF8_EQ(rocblas_bf8 a, rocblas_bf8 b)
+{
+    return rocblas_check_ulp_eq(float(a), float(b));
+}
+
+inline bool rocblas_check_ASSERT_FLOAT_BF16_EQ(float a, rocblas_bfloat16 b)
+{
+    return rocblas_check_ulp_eq(
+               float(b),
+               float(rocblas_bfloat16(a, rocblas_bfloat16::rocblas_truncate_t::rocblas_truncate)))
+           || rocblas_check_ulp_eq(float(b), float(rocblas_bfloat16(a)));
+}
+
+inline bool rocblas_check_ASSERT_FLOAT_COMPLEX_EQ(rocblas_float_complex a,
+                                                  rocblas_float_complex b)
+{
+    return rocblas_check_ulp_eq(std::real(a), std::real(b))
+           && rocblas_check_ulp_eq(std::imag(a), std::imag(b));
+}
+
+inline bool rocblas_check_ASSERT_DOUBLE_COMPLEX_EQ(rocblas_double_complex a,
+                                                   rocblas_double_complex b)
+{
+    return rocblas_check_ulp_eq(std::real(a), std::real(b))
+           && rocblas_check_ulp_eq(std::imag(a), std::imag(b));
+}
+
 #endif // GOOGLE_TEST
 
 // TODO: Replace std::remove_cv_t with std::type_identity_t in C++20
@@ -48,6 +48,8 @@ namespace
         if(!handle)
             return rocblas_status_invalid_handle;
 
+        rocblas_profile_timer profile_timer(handle);
+
         size_t dev_bytes
             = rocblas_reduction_kernel_workspace_size<rocblas_int, NB, To>(n, batch_count);
 
@@ -73,6 +73,8 @@ namespace
         if(!handle)
             return rocblas_status_invalid_handle;
 
+        rocblas_profile_timer profile_timer(handle);
+
         size_t dev_bytes
             = rocblas_reduction_kernel_workspace_size<API_INT, ROCBLAS_DOT_NB * WIN, T2>(
                 n, batch_count);
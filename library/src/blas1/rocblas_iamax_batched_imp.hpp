@@ -56,6 +56,8 @@ namespace
         if(!handle)
             return rocblas_status_invalid_handle;
 
+        rocblas_profile_timer profile_timer(handle);
+
         size_t dev_bytes
             = rocblas_reduction_kernel_workspace_size<API_INT, ROCBLAS_IAMAX_NB, index_val_t>(
                 n, batch_count);
@@ -50,6 +50,8 @@ namespace
         if(!handle)
             return rocblas_status_invalid_handle;
 
+        rocblas_profile_timer profile_timer(handle);
+
         static constexpr API_INT batch_count_1 = 1;
 
         size_t dev_bytes
@@ -48,6 +48,8 @@ namespace
         if(!handle)
             return rocblas_status_invalid_handle;
 
+        rocblas_profile_timer profile_timer(handle);
+
         static constexpr rocblas_int batch_count_1 = 1;
 
         size_t dev_bytes
@@ -71,6 +71,8 @@ namespace
         if(!handle)
             return rocblas_status_invalid_handle;
 
+        rocblas_profile_timer profile_timer(handle);
+
         size_t dev_bytes
             = rocblas_internal_gemv_kernel_workspace_size<Tex>(transA, m, n, batch_count);
         if(handle->is_device_memory_size_query())
@@ -51,6 +51,8 @@ namespace
         if(!handle)
             return rocblas_status_invalid_handle;
 
+        rocblas_profile_timer profile_timer(handle);
+
         if(!handle->is_device_memory_size_query())
         {
             auto layer_mode = handle->layer_mode;
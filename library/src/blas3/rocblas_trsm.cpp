@@ -68,6 +68,8 @@ namespace
         if(!handle)
             return rocblas_status_invalid_handle;
 
+        rocblas_profile_timer profile_timer(handle);
+
         auto check_numerics = handle->check_numerics;
         /////////////
         // LOGGING //
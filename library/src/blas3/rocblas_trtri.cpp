@@ -51,6 +51,8 @@ namespace
         if(!handle)
             return rocblas_status_invalid_handle;
 
+        rocblas_profile_timer profile_timer(handle);
+
         size_t size = rocblas_internal_trtri_temp_elements(n, 1) * sizeof(T);
         if(handle->is_device_memory_size_query())
         {
@@ -53,6 +53,8 @@ namespace
         if(!handle)
             return rocblas_status_invalid_handle;
 
+        rocblas_profile_timer profile_timer(handle);
+
         // Compute the optimal size for temporary device memory
         size_t els   = rocblas_internal_trtri_temp_elements(n, 1);
         size_t size  = els * batch_count * sizeof(T);
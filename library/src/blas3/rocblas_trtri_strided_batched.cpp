@@ -55,6 +55,8 @@ namespace
         if(!handle)
             return rocblas_status_invalid_handle;
 
+        rocblas_profile_timer profile_timer(handle);
+
         // Compute the optimal size for temporary device memory
         size_t size = rocblas_internal_trtri_temp_elements(n, batch_count) * sizeof(T);
         if(handle->is_device_memory_size_query())
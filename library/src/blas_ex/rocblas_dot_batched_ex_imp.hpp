@@ -49,6 +49,8 @@ namespace
             return rocblas_status_invalid_handle;
         }
 
+        rocblas_profile_timer profile_timer(handle);
+
         size_t dev_bytes = rocblas_reduction_kernel_workspace_size<API_INT, ROCBLAS_DOT_NB>(
             n, batch_count, execution_type);
         if(handle->is_device_memory_size_query())
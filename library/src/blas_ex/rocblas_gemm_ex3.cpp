@@ -56,6 +56,8 @@ namespace
         if(!handle)
             return rocblas_status_invalid_handle;
 
+        rocblas_profile_timer profile_timer(handle);
+
         if(handle->getArch() >= 940 && handle->getArch() < 1000)
         {
             // Copy alpha and beta to host if on device
@@ -66,6 +66,8 @@ try
     if(!handle)
         return rocblas_status_invalid_handle;
 
+    rocblas_profile_timer profile_timer(handle);
+
     const bool HPA = compute_type == rocblas_datatype_f32_r
                      && (a_type == rocblas_datatype_f16_r || a_type == rocblas_datatype_bf16_r);
 
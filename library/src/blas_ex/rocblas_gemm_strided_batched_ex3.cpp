@@ -65,6 +65,8 @@ try
     if(!handle)
         return rocblas_status_invalid_handle;
 
+    rocblas_profile_timer profile_timer(handle);
+
     if(handle->getArch() >= 940 && handle->getArch() < 1000)
     {
 
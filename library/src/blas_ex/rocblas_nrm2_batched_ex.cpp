@@ -42,6 +42,8 @@ namespace
             return rocblas_status_invalid_handle;
         }
 
+        rocblas_profile_timer profile_timer(handle);
+
         size_t dev_bytes = rocblas_reduction_kernel_workspace_size<rocblas_int, NB>(
             n, batch_count, execution_type);
 
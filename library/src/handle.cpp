@@ -20,6 +20,7 @@
  *
  * ************************************************************************ */
 #include "handle.hpp"
+#include "profile_timing.hpp"
 #include <cstdarg>
 #include <limits>
 #ifdef WIN32
@@ -235,6 +236,20 @@ _rocblas_handle::~_rocblas_handle()
             << std::endl;
         rocblas_abort();
     }
+
+    // Deferred log records are written asynchronously, so wait for the pending ones to be written
+    if(log_deferred)
+    {
+        if(log_trace_os)
+            log_trace_os->drain();
+        if(log_bench_os)
+            log_bench_os->drain();
+    }
+
+    // Harvest the device times of the timed calls, while HIP can still be called
+    if(log_profile_timing)
+        rocblas_profile_timing_sync();
+
     // Free device memory unless it's user-owned
     if(device_memory_owner != rocblas_device_memory_ownership::user_owned)
     {
@@ -766,7 +781,20 @@ void _rocblas_handle::init_logging()
 
         // open log_profile file
         if(layer_mode & rocblas_layer_mode_log_profile)
-            log_profile_os = open_log_stream("ROCBLAS_LOG_PROFILE_PATH");
+        {
+            log_profile_os     = open_log_stream("ROCBLAS_LOG_PROFILE_PATH");
+            log_profile_format
+                = rocblas_profile_format_from_string(read_env("ROCBLAS_LOG_PROFILE_FORMAT"));
+
+            // time profiled calls on the device with pooled events
+            const char* str_log_profile_timing = read_env("ROCBLAS_LOG_PROFILE_TIMING");
+            log_profile_timing
+                = str_log_profile_timing && strtol(str_log_profile_timing, 0, 0) != 0;
+        }
+
+        // defer formatting of trace and bench logging to the logging worker thread
+        const char* str_log_deferred = read_env("ROCBLAS_LOG_DEFERRED");
+        log_deferred = str_log_deferred && strtol(str_log_deferred, 0, 0) != 0;
     }
 }
 
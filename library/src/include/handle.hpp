@@ -23,6 +23,7 @@
 #pragma once
 
 #include "definitions.hpp"
+#include "profile_estimate.hpp"
 #include "rocblas.h"
 #include "rocblas_ostream.hpp"
 #include "utility.hpp"
@@ -259,8 +260,18 @@ public:
     std::unique_ptr<rocblas_internal_ostream> log_trace_os;
     std::unique_ptr<rocblas_internal_ostream> log_bench_os;
     std::unique_ptr<rocblas_internal_ostream> log_profile_os;
-    void                                      init_logging();
-    void                                      init_check_numerics();
+
+    // whether trace and bench log lines are formatted by the logging worker thread
+    bool log_deferred = false;
+
+    // format of the profile log
+    rocblas_profile_format log_profile_format = rocblas_profile_format::yaml;
+
+    // whether profiled calls are timed on the device, see profile_timing.hpp
+    bool log_profile_timing = false;
+
+    void init_logging();
+    void init_check_numerics();
 
     // C interfaces for manipulating device memory
     friend rocblas_status(::rocblas_start_device_memory_size_query)(_rocblas_handle*);
@@ -23,6 +23,8 @@
 #pragma once
 
 #include "handle.hpp"
+#include "profile_estimate.hpp"
+#include "profile_timing.hpp"
 #include "rocblas_ostream.hpp"
 #include "tuple_helper.hpp"
 #include <cmath>
@@ -40,6 +42,40 @@
 #include <unordered_map>
 #include <utility>
 
+/************************************************************************************
+ * Collect the (name, value) pairs of a profiled tuple, for structured profile dumps
+ ************************************************************************************/
+inline void profile_collect(rocblas_profile_args& args, const char* name, const char* value)
+{
+    args.add_text(name, value);
+}
+
+inline void profile_collect(rocblas_profile_args& args, const char* name, const std::string& value)
+{
+    args.add_text(name, value);
+}
+
+inline void profile_collect(rocblas_profile_args& args, const char* name, char value)
+{
+    args.add_text(name, std::string(1, value));
+}
+
+template <typename T, std::enable_if_t<std::is_arithmetic<T>{}, int> = 0>
+void profile_collect(rocblas_profile_args& args, const char* name, T value)
+{
+    rocblas_internal_ostream os;
+    os << value;
+    args.add_number(name, double(value), os.str());
+}
+
+template <typename T, std::enable_if_t<!std::is_arithmetic<T>{}, int> = 0>
+void profile_collect(rocblas_profile_args& args, const char* name, const T& value)
+{
+    rocblas_internal_ostream os;
+    os << value;
+    args.add_text(name, os.str());
+}
+
 /************************************************************************************
  * Profile kernel arguments
  ************************************************************************************/
@@ -49,14 +85,24 @@ class argument_profile
     // Output stream
     mutable rocblas_internal_ostream os;
 
+    // Output format
+    rocblas_profile_format format;
+
     // Mutex for multithreaded access to table
     mutable std::shared_timed_mutex mutex;
 
+    // Call count of an argument tuple, and the device times of its calls if they are timed
+    // size_t is used for the count since atomic types are not movable, and the map
+    // elements will only be moved when we hold an exclusive lock to the map.
+    struct entry_t
+    {
+        size_t                                     count = 0;
+        std::unique_ptr<rocblas_profile_histogram> histogram;
+    };
+
     // Table mapping argument tuples into counts
-    // size_t is used for the map target type since atomic types are not movable, and
-    // the map elements will only be moved when we hold an exclusive lock to the map.
     std::unordered_map<TUP,
-                       size_t,
+                       entry_t,
                        typename tuple_helper::hash_t<TUP>,
                        typename tuple_helper::equal_t<TUP>>
         map;
@@ -64,8 +110,10 @@ class argument_profile
 public:
     // A tuple of arguments is looked up in an unordered map.
     // A count of the number of calls with these arguments is kept.
+    // If the call is timed, the histogram of the tuple's device times is returned.
+    // Map elements are never erased, so the histogram outlives the timed call.
     // arg is assumed to be an rvalue for efficiency
-    void operator()(TUP&& arg)
+    rocblas_profile_histogram* operator()(TUP&& arg, bool timed)
     {
         { // Acquire a shared lock for reading map
             std::shared_lock<std::shared_timed_mutex> lock(mutex);
@@ -74,10 +122,10 @@ public:
             auto p = map.find(arg);
 
             // If tuple already exists, atomically increment count and return
-            if(p != map.end())
+            if(p != map.end() && (!timed || p->second.histogram))
             {
-                __atomic_fetch_add(&p->second, 1, __ATOMIC_SEQ_CST);
-                return;
+                __atomic_fetch_add(&p->second.count, 1, __ATOMIC_SEQ_CST);
+                return timed ? p->second.histogram.get() : nullptr;
             }
         } // Release shared lock
 
@@ -87,20 +135,31 @@ public:
             // If doesn't already exist, insert tuple by moving arg and initializing count to 0.
             // Increment the count after searching for tuple and returning old or new match.
             // We hold a lock to the map, so we don't have to increment the count atomically.
-            map.emplace(std::move(arg), 0).first->second++;
+            auto& entry = map.emplace(std::move(arg), entry_t{}).first->second;
+            entry.count++;
+
+            if(!timed)
+                return nullptr;
+            if(!entry.histogram)
+                entry.histogram = std::make_unique<rocblas_profile_histogram>();
+            return entry.histogram.get();
         } // Release exclusive lock
     }
 
     // Constructor
     // We must duplicate the rocblas_internal_ostream to avoid dependence on static destruction order
-    explicit argument_profile(rocblas_internal_ostream& os)
+    argument_profile(rocblas_internal_ostream& os, rocblas_profile_format format)
         : os(os.dup())
+        , format(format)
     {
     }
 
     // Dump the current profile
     void dump() const
     {
+        // The device times of timed calls are not waited for, since the profile is dumped during
+        // exit; calls still pending when the last handle was destroyed are not reported
+
         // Acquire an exclusive lock to use map
         std::lock_guard<std::shared_timed_mutex> lock(mutex);
 
@@ -110,9 +169,42 @@ public:
         // Print all of the tuples in the map
         for(const auto& p : map)
         {
-            os << "- ";
-            tuple_helper::print_tuple_pairs(
-                os, std::tuple_cat(p.first, std::make_tuple("call_count", p.second)));
+            rocblas_profile_timing timing;
+            if(p.second.histogram)
+                timing = p.second.histogram->summary();
+
+            if(format == rocblas_profile_format::yaml)
+            {
+                os << "- ";
+                auto tup = std::tuple_cat(p.first, std::make_tuple("call_count", p.second.count));
+                if(timing.count)
+                {
+                    auto times = std::make_tuple("timed_calls",
+                                                 timing.count,
+                                                 "gpu_us_min",
+                                                 timing.min,
+                                                 "gpu_us_p50",
+                                                 timing.p50,
+                                                 "gpu_us_p99",
+                                                 timing.p99,
+                                                 "gpu_us_max",
+                                                 timing.max);
+                    tuple_helper::print_tuple_pairs(os, std::tuple_cat(tup, times));
+                }
+                else
+                    tuple_helper::print_tuple_pairs(os, tup);
+            }
+            else
+            {
+                // CSV and JSON include estimates of the work done by each call
+                rocblas_profile_args args;
+                tuple_helper::apply_pairs(
+                    [&](const char* name, const auto& value) {
+                        profile_collect(args, name, value);
+                    },
+                    p.first);
+                rocblas_profile_print(os, format, args, p.second.count, timing);
+            }
         }
 
         // Flush out the dump
@@ -143,13 +235,16 @@ void log_profile(rocblas_handle handle, const char* func, Ts&&... xs)
         "rocblas_function", func, "atomics_mode", handle->atomics_mode, std::forward<Ts>(xs)...);
 
     // Set up profile
-    static argument_profile<decltype(tup)> profile(*handle->log_profile_os);
+    static argument_profile<decltype(tup)> profile(*handle->log_profile_os,
+                                                   handle->log_profile_format);
 
     // Add at_quick_exit handler in case the program exits early
     static int aqe = at_quick_exit([] { profile.~argument_profile(); });
 
-    // Profile the tuple
-    profile(std::move(tup));
+    // Profile the tuple, and time the call on the device if timing is enabled
+    bool timed = handle->log_profile_timing;
+    if(auto histogram = profile(std::move(tup), timed))
+        rocblas_profile_timer::start(handle, histogram);
 }
 
 /********************************************
@@ -165,13 +260,69 @@ void log_arguments(rocblas_internal_ostream& os, const char* sep, H&& head, Ts&&
     os << std::endl;
 }
 
+/***************************************************************************
+ * Deferred logging of values (ROCBLAS_LOG_DEFERRED)                       *
+ * Values are captured in a tuple at the call site, and formatted later by *
+ * the worker thread of the output stream                                  *
+ ***************************************************************************/
+// Values are captured by value
+template <typename T,
+          std::enable_if_t<!std::is_base_of<rocblas_internal_ostream, std::decay_t<T>>{}, int> = 0>
+std::decay_t<T> log_deferred_value(T&& x)
+{
+    return std::forward<T>(x);
+}
+
+// C-strings are copied, since they might not outlive the call
+inline std::string log_deferred_value(const char* s)
+{
+    return s;
+}
+
+// String streams are captured as their contents
+inline std::string log_deferred_value(const rocblas_internal_ostream& os)
+{
+    return os.str();
+}
+
+// Record of captured values which are printed like log_arguments()
+template <typename TUP>
+class log_arguments_record : public rocblas_internal_ostream::deferred_record
+{
+    const char* m_sep; // Always a string literal
+    TUP         m_tuple;
+
+public:
+    log_arguments_record(const char* sep, TUP&& tuple)
+        : m_sep(sep)
+        , m_tuple(std::move(tuple))
+    {
+    }
+
+    void format(rocblas_internal_ostream& os) const override
+    {
+        tuple_helper::print_tuple_values(os, m_sep, m_tuple);
+    }
+};
+
+template <typename... Ts>
+void log_arguments_deferred(rocblas_internal_ostream& os, const char* sep, Ts&&... xs)
+{
+    auto tup = std::make_tuple(log_deferred_value(std::forward<Ts>(xs))...);
+    os.send_deferred(std::make_unique<log_arguments_record<decltype(tup)>>(sep, std::move(tup)));
+}
+
 // if trace logging is turned on with
 // (handle->layer_mode & rocblas_layer_mode_log_trace) != 0
 // log_function will call log_arguments to log arguments with a comma separator
 template <typename... Ts>
 void log_trace(rocblas_handle handle, Ts&&... xs)
 {
-    log_arguments(*handle->log_trace_os, ",", std::forward<Ts>(xs)..., handle->atomics_mode);
+    if(handle->log_deferred)
+        log_arguments_deferred(
+            *handle->log_trace_os, ",", std::forward<Ts>(xs)..., handle->atomics_mode);
+    else
+        log_arguments(*handle->log_trace_os, ",", std::forward<Ts>(xs)..., handle->atomics_mode);
 }
 
 // if bench logging is turned on with
@@ -181,7 +332,15 @@ void log_trace(rocblas_handle handle, Ts&&... xs)
 template <typename... Ts>
 void log_bench(rocblas_handle handle, Ts&&... xs)
 {
-    if(handle->atomics_mode == rocblas_atomics_not_allowed)
+    if(handle->log_deferred)
+    {
+        if(handle->atomics_mode == rocblas_atomics_not_allowed)
+            log_arguments_deferred(
+                *handle->log_bench_os, " ", std::forward<Ts>(xs)..., "--atomics_not_allowed");
+        else
+            log_arguments_deferred(*handle->log_bench_os, " ", std::forward<Ts>(xs)...);
+    }
+    else if(handle->atomics_mode == rocblas_atomics_not_allowed)
         log_arguments(*handle->log_bench_os, " ", std::forward<Ts>(xs)..., "--atomics_not_allowed");
     else
         log_arguments(*handle->log_bench_os, " ", std::forward<Ts>(xs)...);
@@ -0,0 +1,127 @@
+/* ************************************************************************
+ * Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell cop-
+ * ies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM-
+ * PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNE-
+ * CTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * ************************************************************************ */
+
+#pragma once
+
+#include "rocblas.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+class rocblas_internal_ostream;
+
+/*****************************************************************************
+ * Output formats of profile logging (ROCBLAS_LOG_PROFILE_FORMAT)            *
+ *****************************************************************************/
+enum class rocblas_profile_format
+{
+    yaml, // YAML list of argument tuples with call counts (the default)
+    csv, // One line per argument tuple, with work estimates
+    json, // One JSON object per line (JSON Lines), with work estimates
+};
+
+// Parse a profile format name, returning yaml if the name is not recognized
+rocblas_profile_format rocblas_profile_format_from_string(const char* name);
+
+/*****************************************************************************
+ * Arguments of a profiled call, collected from its (name, value) tuple      *
+ *****************************************************************************/
+class ROCBLAS_INTERNAL_EXPORT rocblas_profile_args
+{
+    // Argument names, with their values as text, in the order they were logged
+    std::vector<std::pair<std::string, std::string>> m_text;
+
+    // Numeric arguments
+    std::vector<std::pair<std::string, double>> m_number;
+
+public:
+    // Add an argument with a text value
+    void add_text(const char* name, std::string value)
+    {
+        m_text.emplace_back(name, std::move(value));
+    }
+
+    // Add an argument with a numeric value
+    void add_number(const char* name, double value, std::string text)
+    {
+        m_number.emplace_back(name, value);
+        m_text.emplace_back(name, std::move(text));
+    }
+
+    // All arguments as text, in order
+    const auto& text() const
+    {
+        return m_text;
+    }
+
+    // Look up a numeric argument by name, trying the lower case name as well
+    double number(const char* name, double default_value = 0) const;
+
+    // Look up a text argument by name, returning "" if it is absent
+    const std::string& text(const char* name) const;
+};
+
+/*****************************************************************************
+ * Estimate of the work done by one profiled call                            *
+ *****************************************************************************/
+struct rocblas_profile_estimate
+{
+    bool   valid = false; // Whether the function is known to the estimator
+    double gflop = 0; // Floating point operations, in units of 1e9
+    double gbyte = 0; // Bytes moved to and from device memory, in units of 1e9
+
+    // Arithmetic intensity in flops per byte, the x-axis of a roofline plot
+    double flop_per_byte() const
+    {
+        return gbyte > 0 ? gflop / gbyte : 0;
+    }
+};
+
+/*****************************************************************************
+ * Device times of the timed calls of one argument tuple, in microseconds    *
+ *****************************************************************************/
+struct rocblas_profile_timing
+{
+    uint64_t count = 0; // Number of timed calls; the other fields are 0 if there are none
+    double   min   = 0;
+    double   p50   = 0;
+    double   p99   = 0;
+    double   max   = 0;
+    double   total = 0;
+};
+
+// Estimate the work of a call from its arguments, using the formulas of the clients'
+// flops.hpp and bytes.hpp, or the compulsory traffic of the operands where bytes.hpp
+// does not have a count
+ROCBLAS_INTERNAL_EXPORT rocblas_profile_estimate
+    rocblas_estimate_profile(const rocblas_profile_args& args);
+
+// Print the arguments and call count of a profiled call, with its work estimates
+// and device times, as a CSV line or a JSON object on one line
+ROCBLAS_INTERNAL_EXPORT void rocblas_profile_print(rocblas_internal_ostream&     os,
+                                                   rocblas_profile_format        format,
+                                                   const rocblas_profile_args&   args,
+                                                   size_t                        call_count,
+                                                   const rocblas_profile_timing& timing);
@@ -0,0 +1,113 @@
+/* ************************************************************************
+ * Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell cop-
+ * ies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM-
+ * PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNE-
+ * CTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * ************************************************************************ */
+
+#pragma once
+
+#include "handle.hpp"
+#include <cstdint>
+#include <mutex>
+
+/*****************************************************************************
+ * Histogram of the device times of the calls with one argument tuple        *
+ *****************************************************************************/
+class rocblas_profile_histogram
+{
+public:
+    // Buckets are logarithmic, with 8 per octave (9% wide), from 1/16 us to 2^28 us
+    static constexpr int    buckets_per_octave = 8;
+    static constexpr int    octaves            = 32;
+    static constexpr int    buckets            = buckets_per_octave * octaves;
+    static constexpr double min_bucket_us      = 1.0 / 16;
+
+    // Add the device time of one call, in microseconds
+    void add(double us);
+
+    // Summary of the device times added so far
+    rocblas_profile_timing summary() const;
+
+private:
+    mutable std::mutex     m_mutex;
+    uint64_t               m_bucket[buckets] = {};
+    rocblas_profile_timing m_summary;
+
+    // Approximate percentile, from the geometric center of the bucket which contains it
+    double percentile(double p) const;
+};
+
+/*****************************************************************************
+ * Device timing of profiled calls (ROCBLAS_LOG_PROFILE_TIMING)              *
+ *                                                                           *
+ * A rocblas_profile_timer is declared at the top of each API function.      *
+ * When log_profile is called while the timer is in scope, an event from a   *
+ * reusable pool is recorded on the handle's stream. When the timer goes out *
+ * of scope, after all of the call's work has been enqueued, another event   *
+ * is recorded, and the pair is posted to a harvester thread, which polls    *
+ * it with hipEventQuery and adds the elapsed time to the tuple's histogram. *
+ * The calling thread never synchronizes with the device.                    *
+ *****************************************************************************/
+class rocblas_profile_timer
+{
+    rocblas_handle             m_handle    = nullptr;
+    rocblas_profile_timer*     m_previous  = nullptr;
+    rocblas_profile_histogram* m_histogram = nullptr;
+    hipStream_t                m_stream    = nullptr;
+    hipEvent_t                 m_start     = nullptr;
+
+    // Innermost timer of the current thread, since API functions may call each other
+    static inline thread_local rocblas_profile_timer* t_current = nullptr;
+
+    // Record the stop event and post the call to the harvester thread
+    void stop();
+
+public:
+    explicit rocblas_profile_timer(rocblas_handle handle)
+    {
+        if(handle->log_profile_timing)
+        {
+            m_handle   = handle;
+            m_previous = t_current;
+            t_current  = this;
+        }
+    }
+
+    ~rocblas_profile_timer()
+    {
+        if(m_handle)
+        {
+            if(m_start)
+                stop();
+            t_current = m_previous;
+        }
+    }
+
+    // Start timing the current call, whose argument tuple has the histogram
+    // Called by log_profile; does nothing if no timer for the handle is in scope
+    static void start(rocblas_handle handle, rocblas_profile_histogram* histogram);
+
+    rocblas_profile_timer(const rocblas_profile_timer&) = delete;
+    rocblas_profile_timer& operator=(const rocblas_profile_timer&) = delete;
+};
+
+// Wait until the harvester thread has harvested all of the timed calls posted so far
+// Called when a handle is destroyed; it is not called during exit, when HIP may be torn down
+void rocblas_profile_timing_sync();
@@ -36,12 +36,12 @@
 #include <memory>
 #include <mutex>
 #include <ostream>
-#include <queue>
 #include <sstream>
 #include <string>
 #include <sys/stat.h>
 #include <thread>
 #include <utility>
+#include <vector>
 #ifdef WIN32
 #include <io.h>
 #include <iostream>
@@ -73,6 +73,30 @@
  ***************************************************************************/
 class ROCBLAS_INTERNAL_EXPORT rocblas_internal_ostream
 {
+public:
+    /*************************************************************************
+     * A deferred record holds values captured by value at the call site,    *
+     * which are formatted later by the worker thread instead of the caller  *
+     *************************************************************************/
+    class deferred_record
+    {
+    public:
+        virtual ~deferred_record() = default;
+
+        // Format the captured values into os
+        virtual void format(rocblas_internal_ostream& os) const = 0;
+    };
+
+    // Statistics of the worker thread writing to a file
+    struct stats_t
+    {
+        size_t bytes_written; // Number of bytes written to the file
+        size_t writes; // Number of batched write calls
+        size_t records_dropped; // Number of deferred records dropped because the queue was full
+        size_t max_queue_depth; // Maximum number of tasks queued at once
+    };
+
+private:
     /**************************************************************************
      * The worker class sets up a worker thread for writing to log files. Two *
      * files are considered the same if they have the same device ID / inode. *
@@ -82,8 +106,10 @@ class ROCBLAS_INTERNAL_EXPORT rocblas_internal_ostream
         // task_t represents a payload of data and a promise to finish
         class task_t
         {
-            std::string        m_str;
-            std::promise<void> m_promise;
+            std::string                      m_str;
+            std::unique_ptr<deferred_record> m_deferred;
+            std::promise<void>               m_promise;
+            bool                             m_barrier = false;
 
         public:
             // The task takes ownership of the string payload and promise
@@ -93,6 +119,34 @@ class ROCBLAS_INTERNAL_EXPORT rocblas_internal_ostream
             {
             }
 
+            // The task takes ownership of a deferred record, which nobody waits on
+            explicit task_t(std::unique_ptr<deferred_record>&& deferred)
+                : m_deferred(std::move(deferred))
+            {
+            }
+
+            // The task is an empty barrier, whose promise is kept once the tasks before it are written
+            explicit task_t(std::promise<void>&& promise)
+                : m_promise(std::move(promise))
+                , m_barrier(true)
+            {
+            }
+
+            // Whether the task is a barrier rather than a payload
+            bool is_barrier() const
+            {
+                return m_barrier;
+            }
+
+            // Whether the payload is a deferred record which still needs formatting
+            bool is_deferred() const
+            {
+                return m_deferred != nullptr;
+            }
+
+            // Format the deferred record into the string payload
+            void format();
+
             // Notify the future to wake up
             void set_value()
             {
@@ -121,13 +175,31 @@ class ROCBLAS_INTERNAL_EXPORT rocblas_internal_ostream
         // Condition variable for worker notification
         std::condition_variable m_cond;
 
-        // Mutex for this thread's queue
+        // Condition variable for notification of space in a bounded queue
+        std::condition_variable m_space_cond;
+
+        // Mutex for this thread's queue and statistics
         std::mutex m_mutex;
 
-        // Queue of tasks
-        std::queue<task_t> m_queue;
+        // Queue of tasks, which the worker thread takes all at once
+        std::vector<task_t> m_queue;
+
+        // Maximum number of queued tasks before post() blocks or drops (0 = unbounded)
+        size_t m_queue_max = 0;
+
+        // Whether post() drops deferred records instead of blocking when the queue is full
+        bool m_queue_drop = false;
 
-        // Worker thread which waits for and handles tasks sequentially
+        // Whether the worker thread has exited, after a write error, and takes no more tasks
+        bool m_stopped = false;
+
+        // Statistics of this worker
+        stats_t m_stats{};
+
+        // Write a batch of tasks to the file, returning false on error
+        bool write_batch(std::vector<task_t>& batch, size_t count);
+
+        // Worker thread which waits for and handles batches of tasks sequentially
         void thread_function();
 
     public:
@@ -137,6 +209,15 @@ class ROCBLAS_INTERNAL_EXPORT rocblas_internal_ostream
         // Send a string to be written
         void send(std::string);
 
+        // Post a deferred record to be formatted and written, without waiting
+        void post(std::unique_ptr<deferred_record>);
+
+        // Wait until everything queued before the call has been written
+        void drain();
+
+        // Get a snapshot of the statistics
+        stats_t stats();
+
         // Destroy a worker when all std::shared_ptr references to it are gone
         ~worker();
     };
@@ -249,6 +330,16 @@ public:
     // Flush the output
     void flush();
 
+    // Flush the output and wait until the deferred records sent before it have been written
+    void drain();
+
+    // Get the statistics of the worker thread, or zeros if there is no worker
+    stats_t stats() const;
+
+    // Send a deferred record to be formatted by the worker thread
+    // If there is no worker (i.e., this is a string), the record is formatted immediately
+    void send_deferred(std::unique_ptr<deferred_record> record);
+
     // csv friendly output set true
     void set_csv(bool flag)
     {
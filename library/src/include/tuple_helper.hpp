@@ -78,6 +78,30 @@ public:
         return os << " }\n";
     }
 
+    /**********************************************************
+     * Print tuples (value1, value2, ...) with a separator,   *
+     * as log_arguments() does for log_trace and log_bench    *
+     **********************************************************/
+private:
+    template <typename TUP, size_t... I>
+    static void print_tuple_values_impl(rocblas_internal_ostream& os,
+                                        const char*               sep,
+                                        const TUP&                tuple,
+                                        std::index_sequence<I...>)
+    {
+        (((I ? os << sep : os) << std::get<I>(tuple)), ...);
+    }
+
+public:
+    template <typename TUP>
+    static rocblas_internal_ostream&
+        print_tuple_values(rocblas_internal_ostream& os, const char* sep, const TUP& tuple)
+    {
+        static_assert(std::tuple_size<TUP>{} > 0, "Tuple must not be empty");
+        print_tuple_values_impl(os, sep, tuple, std::make_index_sequence<std::tuple_size<TUP>{}>{});
+        return os << std::endl;
+    }
+
     /*********************************************************************
      * Compute value hashes for (key1, value1, key2, value2, ...) tuples *
      *********************************************************************/
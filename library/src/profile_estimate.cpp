@@ -0,0 +1,439 @@
+/* ************************************************************************
+ * Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell cop-
+ * ies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM-
+ * PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNE-
+ * CTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * ************************************************************************ */
+
+#include "profile_estimate.hpp"
+#include "rocblas_ostream.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+
+rocblas_profile_format rocblas_profile_format_from_string(const char* name)
+{
+    if(name && !strcmp(name, "csv"))
+        return rocblas_profile_format::csv;
+    if(name && !strcmp(name, "json"))
+        return rocblas_profile_format::json;
+    return rocblas_profile_format::yaml;
+}
+
+double rocblas_profile_args::number(const char* name, double default_value) const
+{
+    std::string lower(name);
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) {
+        return std::tolower(c);
+    });
+    for(const auto& p : m_number)
+        if(p.first == name || p.first == lower)
+            return p.second;
+    return default_value;
+}
+
+const std::string& rocblas_profile_args::text(const char* name) const
+{
+    static const std::string empty;
+    for(const auto& p : m_text)
+        if(p.first == name)
+            return p.second;
+    return empty;
+}
+
+namespace
+{
+    // Size in bytes and complexity of a matrix or vector element
+    struct element_t
+    {
+        double size    = 0;
+        bool   complex = false;
+    };
+
+    // Element from a rocblas_datatype_string() name, such as "f32_c"
+    element_t element_from_datatype(const std::string& type)
+    {
+        static constexpr std::pair<const char*, element_t> types[] = {
+            {"f16_r", {2, false}},
+            {"bf16_r", {2, false}},
+            {"f32_r", {4, false}},
+            {"f64_r", {8, false}},
+            {"f16_c", {4, true}},
+            {"bf16_c", {4, true}},
+            {"f32_c", {8, true}},
+            {"f64_c", {16, true}},
+            {"i8_r", {1, false}},
+            {"u8_r", {1, false}},
+            {"i_r32", {4, false}},
+            {"i32_r", {4, false}},
+            {"u32_r", {4, false}},
+            {"f8_r", {1, false}},
+            {"bf8_r", {1, false}},
+        };
+        for(const auto& t : types)
+            if(type == t.first)
+                return t.second;
+        return {};
+    }
+
+    // Element from the precision prefix of a function name, such as "s" in "sgemm"
+    // Mixed prefixes such as "cs" in "csscal" or "sc" in "scasum" operate on complex data
+    element_t element_from_prefix(const std::string& prefix)
+    {
+        if(prefix == "h" || prefix == "bf")
+            return {2, false};
+        if(prefix == "s")
+            return {4, false};
+        if(prefix == "d")
+            return {8, false};
+        if(prefix == "c" || prefix == "cs" || prefix == "sc")
+            return {8, true};
+        if(prefix == "z" || prefix == "zd" || prefix == "dz")
+            return {16, true};
+        return {};
+    }
+
+    inline double tri_count(double n)
+    {
+        return n * (1 + n) / 2;
+    }
+
+    // Strip a suffix from a string, returning whether it was found
+    bool strip_suffix(std::string& s, const char* suffix)
+    {
+        size_t len = strlen(suffix);
+        if(s.size() < len || s.compare(s.size() - len, len, suffix))
+            return false;
+        s.erase(s.size() - len);
+        return true;
+    }
+
+    // Level 1, 2 and 3 functions which have estimates, matched against the end of the name
+    // Names which end other names ("dot", "ger", "rot") are listed after them
+    constexpr const char* estimated_functions[]
+        = {"herkx", "syrkx", "her2k", "syr2k", "trtri", "dotu", "dotc", "gemm", "gemv", "geam",
+           "symm",  "hemm",  "herk",  "syrk",  "trmm",  "trsm", "asum", "axpy", "copy", "nrm2",
+           "scal",  "swap",  "amax",  "amin",  "geru",  "gerc", "dot",  "ger",  "rot"};
+}
+
+rocblas_profile_estimate rocblas_estimate_profile(const rocblas_profile_args& args)
+{
+    rocblas_profile_estimate est;
+
+    // Function name without "rocblas_" and the 64-bit and batched suffixes
+    std::string name = args.text("rocblas_function");
+    if(name.compare(0, 8, "rocblas_"))
+        return est;
+    name.erase(0, 8);
+    strip_suffix(name, "_64");
+    bool ex = strip_suffix(name, "_ex") || strip_suffix(name, "_ex3");
+    strip_suffix(name, "_batched") && strip_suffix(name, "_strided");
+
+    // Element types come from the datatype arguments for *_ex functions, or else from
+    // the precision prefix of the function name
+    element_t a, c;
+    if(ex)
+    {
+        a = element_from_datatype(args.text("a_type"));
+        c = element_from_datatype(args.text("c_type"));
+        if(!c.size)
+            c = a;
+
+        // Level 1 *_ex functions log the vector type as b_type
+        if(element_from_datatype(args.text("b_type")).size && name != "gemm")
+            a = c = element_from_datatype(args.text("b_type"));
+    }
+    const char* base = nullptr;
+    std::string prefix;
+    for(const char* f : estimated_functions)
+    {
+        std::string fn(f);
+        if(name.size() >= fn.size() && !name.compare(name.size() - fn.size(), fn.size(), fn))
+        {
+            base   = f;
+            prefix = name.substr(0, name.size() - fn.size());
+
+            // iamax and iamin have an "i" before the precision
+            if((fn == "amax" || fn == "amin") && !prefix.empty() && prefix[0] == 'i')
+                prefix.erase(0, 1);
+            if(!a.size)
+                a = c = element_from_prefix(prefix);
+            break;
+        }
+    }
+    if(!base || !a.size)
+        return est;
+
+    std::string fn(base);
+    bool        cplx = a.complex;
+    double      s    = a.size;
+    double      m    = args.number("M");
+    double      n    = args.number("N");
+    double      k    = args.number("K");
+    double      flop = 0, byte = 0;
+
+    bool   side_left = args.text("side") != "R";
+    bool   trans_n   = args.text("transA").empty() || args.text("transA") == "N";
+    double ka        = side_left ? m : n;
+
+    // Level 1
+    if(fn == "asum")
+        flop = (cplx ? 4.0 : 2.0) * n, byte = s * n;
+    else if(fn == "axpy")
+        flop = (cplx ? 8.0 : 2.0) * n, byte = s * 3.0 * n;
+    else if(fn == "copy")
+        byte = s * 2.0 * n;
+    else if(fn == "dot" || fn == "dotu")
+        flop = (cplx ? 8.0 : 2.0) * n, byte = s * 2.0 * n;
+    else if(fn == "dotc")
+        flop = 9.0 * n, byte = s * 2.0 * n;
+    else if(fn == "nrm2")
+        flop = (cplx ? 8.0 : 2.0) * n, byte = s * n;
+    else if(fn == "scal")
+    {
+        // Complex data with a real alpha (csscal, zdscal) takes 2 flops per element
+        bool real_alpha = prefix == "cs" || prefix == "zd"
+                          || (ex && !element_from_datatype(args.text("a_type")).complex);
+        flop            = (cplx ? (real_alpha ? 2.0 : 6.0) : 1.0) * n;
+        byte            = s * 2.0 * n;
+    }
+    else if(fn == "swap")
+        byte = s * 4.0 * n;
+    else if(fn == "amax" || fn == "amin")
+        byte = s * n;
+    else if(fn == "rot")
+    {
+        bool real_sine = prefix == "cs" || prefix == "zd";
+        flop           = (cplx ? (real_sine ? 12.0 : 20.0) : 6.0) * n;
+        byte           = s * 4.0 * n;
+    }
+
+    // Level 2
+    else if(fn == "gemv")
+    {
+        flop = cplx ? 8.0 * m * n + 6.0 * (trans_n ? m : n) : 2.0 * m * n + 2.0 * (trans_n ? m : n);
+        byte = s * (m * n + 2 * (trans_n ? n : m));
+    }
+    else if(fn == "ger" || fn == "geru" || fn == "gerc")
+    {
+        flop = cplx ? 6 * (m * n + std::min(m, n)) + 2 * m * n : 2.0 * m * n + std::min(m, n);
+        byte = s * (m * n + m + n);
+    }
+
+    // Level 3
+    else if(fn == "gemm")
+    {
+        flop = (cplx ? 8.0 : 2.0) * m * n * std::max(k, 1.0);
+
+        // C is only read when beta is not zero
+        byte = s * (m * k + k * n) + c.size * m * n * (args.number("beta", 1) ? 2 : 1);
+    }
+    else if(fn == "geam")
+        flop = (cplx ? 14.0 : 3.0) * m * n, byte = s * 3.0 * m * n;
+    else if(fn == "symm")
+        flop = (cplx ? 8.0 : 2.0) * m * ka * n, byte = s * (tri_count(ka) + 3.0 * m * n);
+    else if(fn == "hemm")
+        flop = 8.0 * m * ka * n, byte = s * (tri_count(ka) + 3.0 * m * n);
+    else if(fn == "syrk")
+        flop = (cplx ? 4.0 : 1.0) * n * n * k, byte = s * (tri_count(n) + n * k);
+    else if(fn == "herk")
+        flop = 4.0 * n * n * k, byte = s * (tri_count(n) + n * k);
+    else if(fn == "syr2k")
+        flop = (cplx ? 8.0 : 2.0) * n * n * k, byte = s * (tri_count(n) + 2.0 * n * k);
+    else if(fn == "her2k")
+        flop = 8.0 * n * n * k, byte = s * (tri_count(n) + 2.0 * n * k);
+    else if(fn == "syrkx")
+        flop = (cplx ? 8.0 : 2.0) * k * tri_count(n), byte = s * (tri_count(n) + 2.0 * n * k);
+    else if(fn == "herkx")
+        flop = 4.0 * n * n * k, byte = s * (tri_count(n) + 2.0 * n * k);
+    else if(fn == "trmm" || fn == "trsm")
+        flop = (cplx ? 4.0 : 1.0) * m * ka * n, byte = s * (tri_count(ka) + 2.0 * m * n);
+    else if(fn == "trtri")
+        flop = (cplx ? 8.0 : 1.0) * n * n * n / 3, byte = s * 2.0 * tri_count(n);
+
+    double batch_count = args.number("batch_count", 1);
+    est.valid          = true;
+    est.gflop          = batch_count * flop / 1e9;
+    est.gbyte          = batch_count * byte / 1e9;
+    return est;
+}
+
+namespace
+{
+    // Quote a string for JSON output, escaping the characters which JSON does not allow in strings
+    std::string json_string(const std::string& str)
+    {
+        std::string quoted = "\"";
+        for(char c : str)
+        {
+            if(c == '"' || c == '\\')
+            {
+                quoted += '\\';
+                quoted += c;
+            }
+            else if(uint8_t(c) < 0x20)
+            {
+                char escape[8];
+                snprintf(escape, sizeof(escape), "\\u%04x", unsigned(c));
+                quoted += escape;
+            }
+            else
+                quoted += c;
+        }
+        return quoted + '"';
+    }
+
+    // Whether an argument was logged as a number in JSON syntax; strtod() would also accept nan,
+    // inf and hexadecimal, which are not valid JSON
+    bool is_json_number(const std::string& text)
+    {
+        const char* p      = text.c_str();
+        auto        digits = [&p] {
+            const char* begin = p;
+            while(isdigit(uint8_t(*p)))
+                ++p;
+            return p != begin;
+        };
+
+        if(*p == '-')
+            ++p;
+        if(*p == '0')
+            ++p;
+        else if(!digits())
+            return false;
+        if(*p == '.')
+        {
+            ++p;
+            if(!digits())
+                return false;
+        }
+        if(*p == 'e' || *p == 'E')
+        {
+            ++p;
+            if(*p == '+' || *p == '-')
+                ++p;
+            if(!digits())
+                return false;
+        }
+        return !*p;
+    }
+
+    // A number for JSON output, which has no literals for NaN and infinities, so they are quoted
+    std::string json_number(double x)
+    {
+        if(std::isnan(x))
+            return json_string("nan");
+        if(std::isinf(x))
+            return json_string(x < 0 ? "-inf" : "inf");
+        std::ostringstream str;
+        str << x;
+        return str.str();
+    }
+}
+
+void rocblas_profile_print(rocblas_internal_ostream&     os,
+                           rocblas_profile_format        format,
+                           const rocblas_profile_args&   args,
+                           size_t                        call_count,
+                           const rocblas_profile_timing& timing)
+{
+    auto est = rocblas_estimate_profile(args);
+
+    // Achieved rates over the timed calls, the y-axis of a roofline plot
+    bool   achieved = est.valid && timing.total > 0;
+    double gflops   = achieved ? est.gflop * timing.count / timing.total * 1e6 : 0;
+    double gbps     = achieved ? est.gbyte * timing.count / timing.total * 1e6 : 0;
+
+    if(format == rocblas_profile_format::csv)
+    {
+        // The CSV header is printed once per process, before the first line
+        static std::atomic<bool> header_printed{false};
+        if(!header_printed.exchange(true))
+            os << "rocblas_function,call_count,gflop,gbyte,total_gflop,total_gbyte,"
+                  "flop_per_byte,timed_calls,gpu_us_min,gpu_us_p50,gpu_us_p99,gpu_us_max,"
+                  "achieved_gflops,achieved_gbps,arguments\n";
+
+        os << args.text("rocblas_function") << ',' << call_count << ',';
+        if(est.valid)
+            os << est.gflop << ',' << est.gbyte << ',' << est.gflop * call_count << ','
+               << est.gbyte * call_count << ',' << est.flop_per_byte() << ',';
+        else
+            os << ",,,,,";
+
+        if(timing.count)
+            os << timing.count << ',' << timing.min << ',' << timing.p50 << ',' << timing.p99
+               << ',' << timing.max << ',';
+        else
+            os << ",,,,,";
+
+        if(achieved)
+            os << gflops << ',' << gbps << ',';
+        else
+            os << ",,";
+
+        // The arguments are space-separated name=value pairs in one quoted field
+        const char* delim = "\"";
+        for(const auto& p : args.text())
+        {
+            if(p.first != "rocblas_function")
+            {
+                os << delim << p.first << '=' << p.second;
+                delim = " ";
+            }
+        }
+        os << "\"\n";
+    }
+    else if(format == rocblas_profile_format::json)
+    {
+        os << "{\"rocblas_function\": " << json_string(args.text("rocblas_function"))
+           << ", \"arguments\": {";
+        const char* delim = "";
+        for(const auto& p : args.text())
+        {
+            if(p.first != "rocblas_function")
+            {
+                os << delim << json_string(p.first) << ": "
+                   << (is_json_number(p.second) ? p.second : json_string(p.second));
+                delim = ", ";
+            }
+        }
+        os << "}, \"call_count\": " << call_count;
+        if(est.valid)
+            os << ", \"gflop\": " << json_number(est.gflop)
+               << ", \"gbyte\": " << json_number(est.gbyte)
+               << ", \"total_gflop\": " << json_number(est.gflop * call_count)
+               << ", \"total_gbyte\": " << json_number(est.gbyte * call_count)
+               << ", \"flop_per_byte\": " << json_number(est.flop_per_byte());
+        if(timing.count)
+            os << ", \"timed_calls\": " << timing.count
+               << ", \"gpu_us_min\": " << json_number(timing.min)
+               << ", \"gpu_us_p50\": " << json_number(timing.p50)
+               << ", \"gpu_us_p99\": " << json_number(timing.p99)
+               << ", \"gpu_us_max\": " << json_number(timing.max);
+        if(achieved)
+            os << ", \"achieved_gflops\": " << json_number(gflops)
+               << ", \"achieved_gbps\": " << json_number(gbps);
+        os << "}\n";
+    }
+}
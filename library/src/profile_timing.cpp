@@ -0,0 +1,294 @@
+/* ************************************************************************
+ * Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell cop-
+ * ies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM-
+ * PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNE-
+ * CTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *
+ * ************************************************************************ */
+
+#include "profile_timing.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdlib>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/***********************************************************************
+ * rocblas_profile_histogram                                           *
+ ***********************************************************************/
+void rocblas_profile_histogram::add(double us)
+{
+    int bucket = us > min_bucket_us ? int(std::log2(us / min_bucket_us) * buckets_per_octave) : 0;
+    bucket     = std::min(bucket, buckets - 1);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_bucket[bucket];
+    m_summary.min = m_summary.count ? std::min(m_summary.min, us) : us;
+    m_summary.max = std::max(m_summary.max, us);
+    m_summary.total += us;
+    ++m_summary.count;
+}
+
+double rocblas_profile_histogram::percentile(double p) const
+{
+    uint64_t rank = uint64_t(std::ceil(p * m_summary.count)), seen = 0;
+    for(int bucket = 0; bucket < buckets; ++bucket)
+    {
+        seen += m_bucket[bucket];
+        if(seen >= rank && seen)
+        {
+            double us = min_bucket_us * std::exp2((bucket + 0.5) / buckets_per_octave);
+            return std::min(std::max(us, m_summary.min), m_summary.max);
+        }
+    }
+    return m_summary.max;
+}
+
+rocblas_profile_timing rocblas_profile_histogram::summary() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    rocblas_profile_timing      summary = m_summary;
+    if(summary.count)
+    {
+        summary.p50 = percentile(0.50);
+        summary.p99 = percentile(0.99);
+    }
+    return summary;
+}
+
+/***********************************************************************
+ * Pool of events, reused across calls, for each device                *
+ ***********************************************************************/
+namespace
+{
+    class event_pool
+    {
+        std::mutex                                       m_mutex;
+        std::unordered_map<int, std::vector<hipEvent_t>> m_free;
+
+    public:
+        // Take an event of the handle's device, creating one if none is free
+        hipEvent_t acquire(rocblas_handle handle)
+        {
+            int device = handle->getDevice();
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto&                       events = m_free[device];
+                if(!events.empty())
+                {
+                    hipEvent_t event = events.back();
+                    events.pop_back();
+                    return event;
+                }
+            }
+
+            auto       saved_device_id = handle->push_device_id();
+            hipEvent_t event           = nullptr;
+            return hipEventCreate(&event) == hipSuccess ? event : nullptr;
+        }
+
+        // Return an event to the pool of its device
+        void release(int device, hipEvent_t event)
+        {
+            if(event)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_free[device].push_back(event);
+            }
+        }
+    };
+
+    // The pool is never destroyed, since the harvester thread may release events during exit
+    event_pool& profile_event_pool()
+    {
+        static event_pool* pool = new event_pool;
+        return *pool;
+    }
+
+    // A timed call, whose events are polled by the harvester thread
+    struct timed_call
+    {
+        int                        device;
+        hipEvent_t                 start, stop;
+        rocblas_profile_histogram* histogram;
+    };
+
+    // Thread which harvests the device times of timed calls
+    // Events are polled with hipEventQuery, so that a slow call does not hold up the others, and
+    // no other thread, such as the logging thread, ever waits for the device
+    class timing_harvester
+    {
+        // Interval between polls of the calls which have not completed yet
+        static constexpr auto poll_interval = std::chrono::microseconds(100);
+
+        std::mutex              m_mutex;
+        std::condition_variable m_cond;
+        std::condition_variable m_idle_cond;
+        std::vector<timed_call> m_queue;
+        size_t                  m_pending = 0;
+
+        // Held while polling, so that exit waits for a poll in progress before HIP is torn down
+        std::mutex m_poll_mutex;
+        bool       m_exiting = false;
+
+        // Returns whether the call is finished with, adding its time if it has completed
+        static bool harvest(const timed_call& call)
+        {
+            hipError_t status = hipEventQuery(call.stop);
+            if(status == hipErrorNotReady)
+                return false;
+
+            float ms = 0;
+            if(status == hipSuccess
+               && hipEventElapsedTime(&ms, call.start, call.stop) == hipSuccess)
+                call.histogram->add(ms * 1000.0);
+            profile_event_pool().release(call.device, call.start);
+            profile_event_pool().release(call.device, call.stop);
+            return true;
+        }
+
+        void thread_function()
+        {
+            std::vector<timed_call> polled;
+            for(;;)
+            {
+                // Wait for new calls, or until the next poll of the calls not completed yet
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    if(polled.empty())
+                        m_cond.wait(lock, [&] { return !m_queue.empty(); });
+                    else
+                        m_cond.wait_for(lock, poll_interval);
+                    polled.insert(polled.end(), m_queue.begin(), m_queue.end());
+                    m_queue.clear();
+                }
+
+                size_t harvested = 0;
+                {
+                    std::lock_guard<std::mutex> lock(m_poll_mutex);
+                    if(m_exiting)
+                        return;
+                    auto end  = std::remove_if(polled.begin(), polled.end(), harvest);
+                    harvested = polled.end() - end;
+                    polled.erase(end, polled.end());
+                }
+
+                if(harvested)
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_pending -= harvested;
+                    if(!m_pending)
+                        m_idle_cond.notify_all();
+                }
+            }
+        }
+
+    public:
+        timing_harvester()
+        {
+            std::thread(&timing_harvester::thread_function, this).detach();
+        }
+
+        // Post a timed call, without waiting
+        void post(const timed_call& call)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queue.push_back(call);
+            ++m_pending;
+            m_cond.notify_one();
+        }
+
+        // Wait until all of the calls posted so far have been harvested
+        void sync()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_idle_cond.wait(lock, [&] { return !m_pending || m_exiting; });
+        }
+
+        // Stop polling, after any poll in progress, since HIP is about to be torn down
+        void exit()
+        {
+            std::lock_guard<std::mutex> poll_lock(m_poll_mutex);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_exiting = true;
+            m_idle_cond.notify_all();
+        }
+    };
+
+    // The harvester is never destroyed, since its thread is detached
+    // It stops polling at exit; it is created after HIP, so its atexit handler runs before HIP's
+    timing_harvester& profile_timing_harvester()
+    {
+        static timing_harvester* harvester = [] {
+            auto* harvester = new timing_harvester;
+            std::atexit([] { profile_timing_harvester().exit(); });
+            return harvester;
+        }();
+        return *harvester;
+    }
+}
+
+/***********************************************************************
+ * rocblas_profile_timer                                               *
+ ***********************************************************************/
+void rocblas_profile_timer::start(rocblas_handle handle, rocblas_profile_histogram* histogram)
+{
+    rocblas_profile_timer* timer = t_current;
+    if(!timer || timer->m_handle != handle || timer->m_start)
+        return;
+
+    // Events cannot be used to time calls which are captured into a graph
+    if(handle->is_stream_in_capture_mode())
+        return;
+
+    hipEvent_t event = profile_event_pool().acquire(handle);
+    if(event && hipEventRecord(event, handle->get_stream()) == hipSuccess)
+    {
+        timer->m_histogram = histogram;
+        timer->m_stream    = handle->get_stream();
+        timer->m_start     = event;
+    }
+    else
+        profile_event_pool().release(handle->getDevice(), event);
+}
+
+void rocblas_profile_timer::stop()
+try
+{
+    int        device = m_handle->getDevice();
+    hipEvent_t event  = profile_event_pool().acquire(m_handle);
+    if(!event || hipEventRecord(event, m_stream) != hipSuccess)
+    {
+        profile_event_pool().release(device, m_start);
+        profile_event_pool().release(device, event);
+        return;
+    }
+
+    profile_timing_harvester().post({device, m_start, event, m_histogram});
+}
+catch(...)
+{
+}
+
+void rocblas_profile_timing_sync()
+{
+    profile_timing_harvester().sync();
+}
@@ -24,7 +24,11 @@
 static void rocblas_abort_once [[noreturn]] ();
 
 #include "rocblas_ostream.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
 #include <csignal>
+#include <cstring>
 #include <fcntl.h>
 #include <iostream>
 #include <type_traits>
@@ -38,6 +42,8 @@ static void rocblas_abort_once [[noreturn]] ();
 #define OPEN(A) _open(A, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_APPEND, _S_IREAD | _S_IWRITE);
 #define CLOSE(A) _close(A)
 #else
+#include <sys/uio.h>
+
 #define FDOPEN(A, B) fdopen(A, B)
 #define OPEN(A) open(A, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
 #define CLOSE(A) close(A)
@@ -195,6 +201,37 @@ void rocblas_internal_ostream::flush()
     }
 }
 
+// Flush the output and wait for the deferred records to be written
+void rocblas_internal_ostream::drain()
+{
+    if(m_worker_ptr)
+    {
+        flush();
+        m_worker_ptr->drain();
+    }
+}
+
+// Get the statistics of the worker thread
+rocblas_internal_ostream::stats_t rocblas_internal_ostream::stats() const
+{
+    return m_worker_ptr ? m_worker_ptr->stats() : stats_t{};
+}
+
+// Send a deferred record to the worker thread
+void rocblas_internal_ostream::send_deferred(std::unique_ptr<deferred_record> record)
+{
+    if(m_worker_ptr)
+    {
+        // Send anything already buffered first, so that the output order is preserved
+        flush();
+        m_worker_ptr->post(std::move(record));
+    }
+    else
+    {
+        record->format(*this);
+    }
+}
+
 void rocblas_internal_ostream::clear_workers()
 {
     std::lock_guard<std::recursive_mutex> lock(worker_map_mutex());
@@ -240,7 +277,13 @@ void rocblas_internal_ostream::worker::send(std::string str)
     // Hold mutex for as short as possible, to reduce contention
     {
         std::lock_guard<std::mutex> lock(m_mutex);
-        m_queue.push(std::move(worker_task));
+
+        // The worker thread has exited after a write error, and nothing more can be written
+        if(m_stopped)
+            return;
+
+        m_queue.push_back(std::move(worker_task));
+        m_stats.max_queue_depth = std::max(m_stats.max_queue_depth, m_queue.size());
 
         // no lock needed for notification but keeping here
         m_cond.notify_one();
@@ -259,50 +302,187 @@ void rocblas_internal_ostream::worker::send(std::string str)
 #endif
 }
 
+// Post a deferred record to the worker thread for this stream's device/inode
+// The caller does not wait; the worker formats and writes the record in queue order
+// If the queue is bounded and full, the record is dropped or the caller waits for space
+// Records posted after the worker thread has stopped are dropped
+void rocblas_internal_ostream::worker::post(std::unique_ptr<deferred_record> record)
+{
+    task_t worker_task(std::move(record));
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if(m_queue_max && !m_queue_drop)
+        m_space_cond.wait(lock, [&] { return m_stopped || m_queue.size() < m_queue_max; });
+
+    if(m_stopped || (m_queue_max && m_queue.size() >= m_queue_max))
+    {
+        ++m_stats.records_dropped;
+        return;
+    }
+    m_queue.push_back(std::move(worker_task));
+    m_stats.max_queue_depth = std::max(m_stats.max_queue_depth, m_queue.size());
+    m_cond.notify_one();
+}
+
+// Queue a barrier behind everything sent or posted so far, and wait for the worker to reach it
+// Deferred records are posted without waiting, so this is how their writing is guaranteed
+void rocblas_internal_ostream::worker::drain()
+{
+    std::promise<void> promise;
+    auto               future = promise.get_future();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(m_stopped)
+            return;
+        m_queue.push_back(task_t(std::move(promise)));
+        m_stats.max_queue_depth = std::max(m_stats.max_queue_depth, m_queue.size());
+        m_cond.notify_one();
+    }
+    future.get();
+}
+
+// Get a snapshot of the statistics
+rocblas_internal_ostream::stats_t rocblas_internal_ostream::worker::stats()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+// Format a deferred record into the string payload of a task, on the worker thread
+void rocblas_internal_ostream::worker::task_t::format()
+{
+    rocblas_internal_ostream os;
+    m_deferred->format(os);
+    m_deferred.reset();
+    m_str = os.str();
+}
+
+// Write the first count tasks of a batch with as few system calls as possible
+bool rocblas_internal_ostream::worker::write_batch(std::vector<task_t>& batch, size_t count)
+{
+    size_t bytes = 0, writes = 0;
+
+#ifdef WIN32
+    for(size_t i = 0; i < count; ++i)
+        bytes += fwrite(batch[i].data(), 1, batch[i].size(), m_file);
+    writes = 1;
+
+    // Detect any error and flush the C FILE stream
+    bool ok = !ferror(m_file) && !fflush(m_file);
+#else
+    // Gather the payloads of the batch, which are written with writev()
+    // Nothing is ever buffered in m_file, so the file descriptor can be written directly
+    std::vector<iovec> iov;
+    iov.reserve(count);
+    for(size_t i = 0; i < count; ++i)
+        if(batch[i].size())
+            iov.push_back({const_cast<char*>(batch[i].data()), batch[i].size()});
+
+    bool   ok = true;
+    int    fd = fileno(m_file);
+    size_t done = 0;
+    while(done < iov.size())
+    {
+        ssize_t n = writev(fd, &iov[done], int(std::min(iov.size() - done, size_t(IOV_MAX))));
+        if(n < 0)
+        {
+            if(errno == EINTR)
+                continue;
+            ok = false;
+            break;
+        }
+        bytes += n;
+        ++writes;
+
+        // Skip the buffers which were completely written, and advance a partially written one
+        for(; done < iov.size() && size_t(n) >= iov[done].iov_len; ++done)
+            n -= iov[done].iov_len;
+        if(n)
+        {
+            iov[done].iov_base = static_cast<char*>(iov[done].iov_base) + n;
+            iov[done].iov_len -= n;
+        }
+    }
+#endif
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.bytes_written += bytes;
+    m_stats.writes += writes;
+    return ok;
+}
+
 // Worker thread which serializes data to be written to a device/inode
 void rocblas_internal_ostream::worker::thread_function()
 {
     // Clear any errors in the FILE
     clearerr(m_file);
 
+    // Tasks taken from the queue, which are written together
+    // The vector is swapped with the queue, so that both keep their capacity
+    std::vector<task_t> batch;
+
     // Lock the mutex in preparation for cond.wait
     std::unique_lock<std::mutex> lock(m_mutex);
 
-    while(true)
+    for(;;)
     {
         // Wait for any data, ignoring spurious wakeups, locks lock on continue
         m_cond.wait(lock, [&] { return !m_queue.empty(); });
 
-        // With the mutex locked, get and pop data from the front of queue
-        task_t task = std::move(m_queue.front());
-        m_queue.pop();
+        // With the mutex locked, take all of the queued tasks at once
+        batch.swap(m_queue);
 
         // Temporarily unlock queue mutex, unblocking other threads
         lock.unlock();
+        m_space_cond.notify_all();
 
-        // An empty message indicates the closing of the stream
-        if(!task.size())
+        // Format deferred records, off of the calling threads, and look for an empty
+        // message which is not a barrier, which indicates the closing of the stream
+        bool   done  = false;
+        size_t count = 0;
+        for(; count < batch.size(); ++count)
         {
-            // Tell future to wake up
-            task.set_value();
-            break;
+            if(batch[count].is_deferred())
+                batch[count].format();
+            else if(!batch[count].size() && !batch[count].is_barrier())
+            {
+                done = true;
+                break;
+            }
         }
 
         // Write the data
-        fwrite(task.data(), 1, task.size(), m_file);
-
-        // Detect any error and flush the C FILE stream
-        if(ferror(m_file) || fflush(m_file))
+        if(!write_batch(batch, count))
         {
             perror("Error writing log file");
+            done = true;
+        }
 
-            // Tell future to wake up
-            task.set_value();
-            break;
+        // Take no more tasks, and complete those queued since the batch was taken as well, so
+        // that no sender, poster or drain waits for this thread after it has exited
+        if(done)
+        {
+            lock.lock();
+            m_stopped = true;
+            for(auto& task : m_queue)
+                batch.push_back(std::move(task));
+            m_queue.clear();
+
+            // Notify while locked, since a destructor which sees m_stopped does not wait
+            m_space_cond.notify_all();
+            lock.unlock();
         }
 
-        // Promise that the data has been written
-        task.set_value();
+        // Promise that the data has been written, waking up the futures
+        for(auto& task : batch)
+            task.set_value();
+
+        // The closing task has been completed, after which the worker may be destroyed, so its
+        // members are not used again
+        if(done)
+            return;
+
+        batch.clear();
 
         // Re-lock the mutex in preparation for cond.wait
         lock.lock();
@@ -326,6 +506,13 @@ rocblas_internal_ostream::worker::worker(int fd)
         rocblas_abort();
     }
 
+    // Bound on the number of queued tasks, beyond which deferred records are dropped
+    // if ROCBLAS_LOG_QUEUE_POLICY is "drop", or else their senders wait for space
+    if(const char* env = getenv("ROCBLAS_LOG_QUEUE_SIZE"))
+        m_queue_max = strtoul(env, nullptr, 0);
+    if(const char* env = getenv("ROCBLAS_LOG_QUEUE_POLICY"))
+        m_queue_drop = !strcmp(env, "drop");
+
     // Create a worker thread, capturing *this
     m_thread = std::thread([=] { thread_function(); });
 